@@ -0,0 +1,162 @@
+/**********************************************************//**
+ * @file bench.h
+ * @brief Shared timing harness for the benchmark drivers.
+ * Each benchmark is warmed up, timed over several repetitions,
+ * and summarized with percentiles as JSON.
+ **************************************************************/
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+#include <stdio.h>      // FILE, fprintf
+#include <stdlib.h>     // qsort
+#include <time.h>       // clock_gettime
+
+//**************************************************************
+/// Most repetitions a benchmark can be timed over.
+#define BENCH_MAX_REPETITIONS 1000
+
+/// Most benchmarks in one report.
+#define BENCH_MAX_RESULTS 64
+
+/**********************************************************//**
+ * @brief A function to time. It runs the operations of one
+ * repetition.
+ * @param data: Benchmark-specific data.
+ **************************************************************/
+typedef void (*BENCH_FUNCTION)(void *data);
+
+/**********************************************************//**
+ * @struct BENCH_RESULT
+ * @brief Timing summary of one benchmark. Times are in
+ * nanoseconds per operation.
+ **************************************************************/
+typedef struct {
+    const char *name;   ///< Name of the benchmark.
+    int operations;     ///< Operations per repetition.
+    int repetitions;    ///< Number of timed repetitions.
+    double min;         ///< Fastest repetition.
+    double median;      ///< 50th percentile.
+    double p90;         ///< 90th percentile.
+    double p99;         ///< 99th percentile.
+    double max;         ///< Slowest repetition.
+    double mean;        ///< Average over all repetitions.
+} BENCH_RESULT;
+
+/**********************************************************//**
+ * @struct BENCH_REPORT
+ * @brief All the results of one benchmark driver.
+ **************************************************************/
+typedef struct {
+    const char *suite;  ///< Name of the benchmark driver.
+    BENCH_RESULT results[BENCH_MAX_RESULTS]; ///< Finished benchmarks.
+    int nResults;       ///< Number of finished benchmarks.
+} BENCH_REPORT;
+
+/// Sink for results so the compiler can't drop the work.
+static volatile long BenchSink;
+
+/**********************************************************//**
+ * @brief Gets a monotonic time stamp.
+ * @return The time in nanoseconds.
+ **************************************************************/
+static inline double bench_Now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec*1.0e9 + now.tv_nsec;
+}
+
+/**********************************************************//**
+ * @brief Orders two samples for qsort.
+ **************************************************************/
+static inline int bench_Compare(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**********************************************************//**
+ * @brief Gets a percentile of sorted samples.
+ * @param samples: The sorted samples.
+ * @param count: Number of samples.
+ * @param percent: The percentile from 0 to 100.
+ * @return The sample at the percentile.
+ **************************************************************/
+static inline double bench_Percentile(const double *samples, int count, double percent) {
+    int index = (int)(percent/100.0*(count - 1) + 0.5);
+    return samples[index];
+}
+
+/**********************************************************//**
+ * @brief Times a benchmark and adds it to the report.
+ * @param report: The report to add the result to.
+ * @param name: Name of the benchmark.
+ * @param function: The function to time.
+ * @param data: Data passed to the function.
+ * @param operations: Operations done by one call.
+ * @param warmup: Untimed calls made first.
+ * @param repetitions: Timed calls.
+ * @return Whether the benchmark ran.
+ **************************************************************/
+static inline bool bench_Run(BENCH_REPORT *report, const char *name, BENCH_FUNCTION function, void *data, int operations, int warmup, int repetitions) {
+    if (report->nResults >= BENCH_MAX_RESULTS || operations <= 0
+            || repetitions <= 0 || repetitions > BENCH_MAX_REPETITIONS) {
+        fprintf(stderr, "Invalid benchmark: %s\n", name);
+        return false;
+    }
+    
+    // Get the caches and branch predictors going
+    for (int i = 0; i < warmup; i++) {
+        function(data);
+    }
+    
+    // Time each repetition
+    static double samples[BENCH_MAX_REPETITIONS];
+    double total = 0.0;
+    for (int i = 0; i < repetitions; i++) {
+        double start = bench_Now();
+        function(data);
+        samples[i] = (bench_Now() - start) / operations;
+        total += samples[i];
+    }
+    
+    // Summarize
+    qsort(samples, repetitions, sizeof(double), bench_Compare);
+    BENCH_RESULT *result = &report->results[report->nResults++];
+    result->name = name;
+    result->operations = operations;
+    result->repetitions = repetitions;
+    result->min = samples[0];
+    result->median = bench_Percentile(samples, repetitions, 50.0);
+    result->p90 = bench_Percentile(samples, repetitions, 90.0);
+    result->p99 = bench_Percentile(samples, repetitions, 99.0);
+    result->max = samples[repetitions-1];
+    result->mean = total / repetitions;
+    fprintf(stderr, "%-32s %12.1f ns/op (p90 %.1f)\n", name, result->median, result->p90);
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Writes the report as JSON.
+ * @param report: The report to write.
+ * @param file: Where to write it.
+ **************************************************************/
+static inline void bench_WriteJSON(const BENCH_REPORT *report, FILE *file) {
+    fprintf(file, "{\n  \"suite\": \"%s\",\n  \"unit\": \"ns/op\",\n  \"results\": [\n", report->suite);
+    for (int i = 0; i < report->nResults; i++) {
+        const BENCH_RESULT *r = &report->results[i];
+        fprintf(file,
+            "    {\"name\": \"%s\", \"operations\": %d, \"repetitions\": %d, "
+            "\"min\": %.3f, \"median\": %.3f, \"p90\": %.3f, \"p99\": %.3f, "
+            "\"max\": %.3f, \"mean\": %.3f}%s\n",
+            r->name, r->operations, r->repetitions,
+            r->min, r->median, r->p90, r->p99, r->max, r->mean,
+            i+1 < report->nResults? ",": "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+/*============================================================*/
+#endif // _BENCH_H_
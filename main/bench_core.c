@@ -0,0 +1,451 @@
+/**********************************************************//**
+ * @file bench_core.c
+ * @brief Benchmarks for the core game library.
+ **************************************************************/
+
+// Standard library
+#include <ctype.h>      // toupper
+#include <stdio.h>      // printf, fopen, fgets, remove
+#include <stdlib.h>     // malloc, free
+#include <string.h>     // strlen, strcpy
+
+// This project
+#include "debug.h"      // eprintf
+#include "word.h"       // WORD
+#include "word_table.h" // wordTable_Load
+#include "language.h"   // language_Create
+#include "word_sampler.h" // wordSampler_Draw
+#include "word_index.h" // wordIndex_Query
+#include "word_trie.h"  // wordTrie_Create
+#include "player.h"     // PLAYER
+#include "battle.h"     // TEAM
+#include "bench.h"      // bench_Run
+
+//**************************************************************
+/// Dictionary used by the benchmarks.
+#define DICTIONARY "data/words/english.txt"
+
+/// Shuffled copy of the dictionary written by the benchmarks.
+#define UNSORTED_DICTIONARY "bench_unsorted.txt"
+
+/// Level of the words made by the benchmarks.
+#define BENCH_LEVEL 50
+
+/// Experience changes per repetition.
+#define N_EXPERIENCE 10000
+
+/// Boosted stat lookups per repetition.
+#define N_BOOSTS 10000
+
+/// Dictionary words skipped between suggestion lookups.
+#define SUGGEST_STRIDE 100
+
+/// Suggestions found per lookup.
+#define N_SUGGESTIONS 5
+
+/// Random words drawn per repetition.
+#define N_DRAWS 100000
+
+/// Index queries per repetition.
+#define N_QUERIES 100
+
+/// Most matches read out of one query.
+#define MAX_MATCHES 1024
+
+/// Closest words found per search.
+#define N_NEIGHBORS 10
+
+/**********************************************************//**
+ * @struct WORD_LIST
+ * @brief Words read from the dictionary for the benchmarks.
+ **************************************************************/
+typedef struct {
+    char (*words)[MAX_WORD_LENGTH+1];   ///< The hits.
+    char (*misses)[MAX_WORD_LENGTH+3];  ///< Words not in the table.
+    int count;                          ///< Number of words.
+    LANGUAGE *language;                 ///< Language with its own table.
+    WORD_TRIE *trie;                    ///< Prefixes of the table.
+} WORD_LIST;
+
+/**********************************************************//**
+ * @brief Reads every word that fits in a WORD from the
+ * dictionary.
+ * @param list: The list to fill.
+ * @return Whether the dictionary could be read.
+ **************************************************************/
+static bool ReadWords(WORD_LIST *list) {
+    FILE *file = fopen(DICTIONARY, "r");
+    if (!file) {
+        eprintf("Failed to open %s\n", DICTIONARY);
+        return false;
+    }
+    
+    // Count the lines first so the lists are allocated once
+    char buf[64];
+    int lines = 0;
+    while (fgets(buf, sizeof(buf), file)) {
+        lines++;
+    }
+    rewind(file);
+    list->words = malloc(lines * sizeof(*list->words));
+    list->misses = malloc(lines * sizeof(*list->misses));
+    if (!list->words || !list->misses) {
+        eprintf("Out of memory.\n");
+        free(list->words);
+        free(list->misses);
+        fclose(file);
+        return false;
+    }
+    
+    // Misses are the words with a suffix no word ends in
+    list->count = 0;
+    while (fgets(buf, sizeof(buf), file)) {
+        int length = strcspn(buf, "\r\n");
+        buf[length] = '\0';
+        if (length < MIN_WORD_LENGTH || length > MAX_WORD_LENGTH) {
+            continue;
+        }
+        strcpy(list->words[list->count], buf);
+        sprintf(list->misses[list->count], "%sqj", buf);
+        list->count++;
+    }
+    fclose(file);
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Writes the words backwards, in uppercase, with DOS
+ * line endings and every tenth word twice, so loading it has
+ * to normalize, sort and deduplicate.
+ * @param list: The words to write.
+ * @return Whether the file could be written.
+ **************************************************************/
+static bool WriteUnsorted(const WORD_LIST *list) {
+    FILE *file = fopen(UNSORTED_DICTIONARY, "w");
+    if (!file) {
+        eprintf("Failed to open %s\n", UNSORTED_DICTIONARY);
+        return false;
+    }
+    for (int i = list->count - 1; i >= 0; i--) {
+        char upper[MAX_WORD_LENGTH+1];
+        int j;
+        for (j = 0; list->words[i][j]; j++) {
+            upper[j] = toupper((unsigned char)list->words[i][j]);
+        }
+        upper[j] = '\0';
+        fprintf(file, i % 10? "%s\r\n": "%s\r\n%s\r\n", upper, list->words[i]);
+    }
+    fclose(file);
+    return true;
+}
+
+/*============================================================*
+ * Word table benchmarks
+ *============================================================*/
+static void BenchLoad(void *data) {
+    (void)data;
+    wordTable_Load(DICTIONARY);
+    wordTable_Destroy();
+}
+
+static void BenchLoadUnsorted(void *data) {
+    (void)data;
+    WORD_TABLE *table = wordTable_Create(UNSORTED_DICTIONARY);
+    BenchSink = wordTable_GetSize(table);
+    wordTable_Free(table);
+}
+
+static void BenchContainsHits(void *data) {
+    const WORD_LIST *list = data;
+    long found = 0;
+    for (int i = 0; i < list->count; i++) {
+        found += wordTable_Contains(list->words[i]);
+    }
+    BenchSink = found;
+}
+
+static void BenchContainsMisses(void *data) {
+    const WORD_LIST *list = data;
+    long found = 0;
+    for (int i = 0; i < list->count; i++) {
+        found += wordTable_Contains(list->misses[i]);
+    }
+    BenchSink = found;
+}
+
+static void BenchSuggest(void *data) {
+    const WORD_LIST *list = data;
+    WORD_SUGGESTION suggestions[N_SUGGESTIONS];
+    long found = 0;
+    for (int i = 0; i < list->count; i += SUGGEST_STRIDE) {
+        found += wordTable_Suggest(list->misses[i], MAX_SUGGEST_DISTANCE, suggestions, N_SUGGESTIONS);
+    }
+    BenchSink = found;
+}
+
+/*============================================================*
+ * Sampler benchmarks
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Weighs words by their base stat total, so stronger
+ * enemies are more common.
+ **************************************************************/
+static double BenchWeight(const void *data, const WORD *word) {
+    (void)data;
+    return word->base[STAT_MAXHP] + word->base[STAT_ATTACK] + word->base[STAT_DEFEND] + word->base[STAT_SPEED];
+}
+
+static void BenchSamplerCreate(void *data) {
+    (void)data;
+    wordSampler_Free(wordSampler_Create(language_GetEnglish(), BenchWeight, NULL));
+}
+
+static void BenchDrawRank(void *data) {
+    const WORD_SAMPLER *sampler = data;
+    WORD_RNG rng;
+    wordSampler_Seed(&rng, 1);
+    long total = 0;
+    for (int i = 0; i < N_DRAWS; i++) {
+        total += wordSampler_Draw(sampler, &rng, SAMPLE_RANK, i % N_RANKS) != NULL;
+    }
+    BenchSink = total;
+}
+
+static void BenchDrawTechnique(void *data) {
+    const WORD_SAMPLER *sampler = data;
+    WORD_RNG rng;
+    wordSampler_Seed(&rng, 1);
+    long total = 0;
+    for (int i = 0; i < N_DRAWS; i++) {
+        total += wordSampler_DrawWeighted(sampler, &rng, SAMPLE_TECHNIQUE, i % N_TECHNIQUES) != NULL;
+    }
+    BenchSink = total;
+}
+
+/*============================================================*
+ * Index benchmarks
+ *============================================================*/
+static void BenchIndexCreate(void *data) {
+    (void)data;
+    wordIndex_Free(wordIndex_Create(language_GetEnglish()));
+}
+
+static void BenchIndexQuery(void *data) {
+    const WORD_INDEX *index = data;
+    int ids[MAX_MATCHES];
+    long total = 0;
+    for (int i = 0; i < N_QUERIES; i++) {
+        // Words that know two techniques, of rank C or better
+        // and at most 8 letters
+        WORD_QUERY query;
+        wordIndex_ClearQuery(&query);
+        query.techs[query.nTechs++] = DRAIN + i % 8;
+        query.techs[query.nTechs++] = CHARGE + i % 4;
+        query.minRank = RANK_C;
+        query.maxLength = 8;
+        total += wordIndex_Query(index, &query, ids, MAX_MATCHES);
+    }
+    BenchSink = total;
+}
+
+static void BenchIndexNearest(void *data) {
+    const WORD_INDEX *index = data;
+    WORD_NEIGHBOR neighbors[N_NEIGHBORS];
+    long total = 0;
+    for (int i = 0; i < N_QUERIES; i++) {
+        // Opponents of the same rank as a spread of words
+        WORD word;
+        word_Create(&word, wordIndex_GetText(index, i*(wordIndex_GetSize(index)/N_QUERIES)), BENCH_LEVEL);
+        WORD_QUERY filter;
+        wordIndex_ClearQuery(&filter);
+        filter.minRank = word.rank;
+        filter.maxRank = word.rank;
+        total += wordIndex_FindNearest(index, &word, &filter, neighbors, N_NEIGHBORS);
+    }
+    BenchSink = total;
+}
+
+/*============================================================*
+ * Word benchmarks
+ *============================================================*/
+static void BenchCreate(void *data) {
+    const WORD_LIST *list = data;
+    WORD word;
+    long total = 0;
+    for (int i = 0; i < list->count; i++) {
+        word_Create(&word, list->words[i], BENCH_LEVEL);
+        total += word.hp;
+    }
+    BenchSink = total;
+}
+
+static void BenchTrieCreate(void *data) {
+    (void)data;
+    wordTrie_Free(wordTrie_Create(language_GetEnglish()));
+}
+
+static void BenchType(void *data) {
+    const WORD_LIST *list = data;
+    WORD_BUILDER builder;
+    WORD word;
+    long total = 0;
+    for (int i = 0; i < list->count; i++) {
+        // Preview the word after every key
+        word_StartBuilder(&builder, language_GetEnglish(), list->trie);
+        for (const char *next = list->words[i]; *next; next++) {
+            char letter[2] = {*next, '\0'};
+            word_PushLetter(&builder, letter);
+            if (builder.length >= MIN_WORD_LENGTH) {
+                word_CreateFromBuilder(&word, &builder, BENCH_LEVEL);
+                total += word.hp;
+            }
+        }
+    }
+    BenchSink = total;
+}
+
+static void BenchCreateIn(void *data) {
+    const WORD_LIST *list = data;
+    WORD word;
+    long total = 0;
+    for (int i = 0; i < list->count; i++) {
+        word_CreateIn(&word, list->language, list->words[i], BENCH_LEVEL);
+        total += word.hp;
+    }
+    BenchSink = total;
+}
+
+static void BenchExperience(void *data) {
+    WORD word = *(const WORD *)data;
+    for (int i = 0; i < N_EXPERIENCE; i++) {
+        word_ChangeExperience(&word, 1);
+    }
+    BenchSink = word.level;
+}
+
+/*============================================================*
+ * Player benchmarks
+ *============================================================*/
+static void BenchAddRemove(void *data) {
+    const WORD *word = data;
+    PLAYER player;
+    player_Create(&player, "Bench");
+    for (int i = 0; i < MAX_WORDS; i++) {
+        player_AddWord(&player, word);
+    }
+    while (player.nWords > 0) {
+        player_RemoveWord(&player, 0);
+    }
+    BenchSink = player.nTeam;
+}
+
+/*============================================================*
+ * Battle benchmarks
+ *============================================================*/
+static void BenchBoostedStat(void *data) {
+    TEAM *team = data;
+    long total = 0;
+    for (int i = 0; i < N_BOOSTS; i++) {
+        // Walk through every boost level and field effect
+        STAT stat = (STAT)(i % N_STATS);
+        team->statBoosts[stat] = MIN_BOOST + i % (MAX_BOOST - MIN_BOOST + 1);
+        team->fieldEffects[FIELD_ATTACK] = i & 1;
+        total += team_GetBoostedStat(team, stat);
+    }
+    BenchSink = total;
+}
+
+/**********************************************************//**
+ * @brief Benchmark driver method.
+ **************************************************************/
+int main(void) {
+    // Benchmark data
+    BENCH_REPORT report = {.suite = "core", .nResults = 0};
+    WORD_LIST list;
+    if (!ReadWords(&list)) {
+        return EXIT_FAILURE;
+    }
+    
+    // The table is loaded from scratch each repetition
+    bench_Run(&report, "wordTable_Load", BenchLoad, NULL, 1, 1, 10);
+    if (WriteUnsorted(&list)) {
+        bench_Run(&report, "wordTable_Create/unsorted", BenchLoadUnsorted, NULL, 1, 1, 10);
+        remove(UNSORTED_DICTIONARY);
+    }
+    if (!wordTable_Load(DICTIONARY)) {
+        eprintf("Failed to load word table.\n");
+        return EXIT_FAILURE;
+    }
+    bench_Run(&report, "wordTable_Contains/hit", BenchContainsHits, &list, list.count, 1, 20);
+    bench_Run(&report, "wordTable_Contains/miss", BenchContainsMisses, &list, list.count, 1, 20);
+    bench_Run(&report, "wordTable_Suggest/miss", BenchSuggest, &list, (list.count + SUGGEST_STRIDE - 1) / SUGGEST_STRIDE, 1, 10);
+    bench_Run(&report, "word_Create/dictionary", BenchCreate, &list, list.count, 1, 10);
+    
+    // The same words typed a letter at a time
+    bench_Run(&report, "wordTrie_Create", BenchTrieCreate, NULL, 1, 1, 5);
+    list.trie = wordTrie_Create(language_GetEnglish());
+    if (!list.trie) {
+        eprintf("Failed to create trie.\n");
+        return EXIT_FAILURE;
+    }
+    bench_Run(&report, "word_PushLetter/dictionary", BenchType, &list, list.count, 1, 10);
+    
+    // Random words, weighted by strength
+    bench_Run(&report, "wordSampler_Create", BenchSamplerCreate, NULL, 1, 1, 5);
+    WORD_SAMPLER *sampler = wordSampler_Create(language_GetEnglish(), BenchWeight, NULL);
+    if (!sampler) {
+        eprintf("Failed to create sampler.\n");
+        return EXIT_FAILURE;
+    }
+    bench_Run(&report, "wordSampler_Draw/rank", BenchDrawRank, sampler, N_DRAWS, 1, 20);
+    bench_Run(&report, "wordSampler_DrawWeighted/technique", BenchDrawTechnique, sampler, N_DRAWS, 1, 20);
+    
+    // Dictionary searches by what the words become
+    bench_Run(&report, "wordIndex_Create", BenchIndexCreate, NULL, 1, 1, 5);
+    WORD_INDEX *index = wordIndex_Create(language_GetEnglish());
+    if (!index) {
+        eprintf("Failed to create index.\n");
+        return EXIT_FAILURE;
+    }
+    bench_Run(&report, "wordIndex_Query", BenchIndexQuery, index, N_QUERIES, 1, 20);
+    bench_Run(&report, "wordIndex_FindNearest", BenchIndexNearest, index, N_QUERIES, 1, 20);
+    
+    // The same words in a language that owns its table
+    LANGUAGE_DEF def = {
+        .name = "Bench",
+        .dictionary = DICTIONARY,
+        .lower = "abcdefghijklmnopqrstuvwxyz",
+        .upper = "ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+        .stats = "HDSDHADSHAASDSHSSAADHADAHS",
+    };
+    list.language = language_Create(&def);
+    if (!list.language) {
+        eprintf("Failed to create language.\n");
+        return EXIT_FAILURE;
+    }
+    bench_Run(&report, "word_CreateIn/language", BenchCreateIn, &list, list.count, 1, 10);
+    
+    // Word and team setup
+    WORD word;
+    word_Create(&word, "Wordsmith", 1);
+    bench_Run(&report, "word_ChangeExperience", BenchExperience, &word, N_EXPERIENCE, 10, 100);
+    bench_Run(&report, "player_AddWord+RemoveWord", BenchAddRemove, &word, 2*MAX_WORDS, 100, 1000);
+    WORD *words[1] = {&word};
+    TEAM team;
+    team_Create(&team, words, 1);
+    bench_Run(&report, "team_GetBoostedStat", BenchBoostedStat, &team, N_BOOSTS, 10, 100);
+    
+    // Machine-readable results
+    bench_WriteJSON(&report, stdout);
+    wordSampler_Free(sampler);
+    wordIndex_Free(index);
+    wordTrie_Free(list.trie);
+    wordTable_Destroy();
+    language_Free(list.language);
+    free(list.words);
+    free(list.misses);
+    return EXIT_SUCCESS;
+}
+
+/*============================================================*/
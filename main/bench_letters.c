@@ -0,0 +1,288 @@
+/**********************************************************//**
+ * @file bench_letters.c
+ * @brief Benchmark for animating letters with the letter
+ * system. In "draws" mode it instead counts the drawing
+ * requests made for words and their HUDs, headless on the
+ * null render backend.
+ **************************************************************/
+
+// Standard library
+#include <stdio.h>          // printf
+#include <stdlib.h>         // atoi, rand, calloc, free
+#include <string.h>         // strcmp
+
+// Allegro
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_ttf.h>
+#include <allegro5/allegro_image.h>
+#include <allegro5/allegro_primitives.h>
+
+// This project
+#include "debug.h"          // eprintf
+#include "letter_system.h"  // LETTER_SYSTEM
+#include "word.h"           // word_Create
+#include "word_table.h"     // wordTable_Load
+#include "word_sprite.h"    // wordSprite_Draw
+#include "word_frame.h"     // wordFrame_DrawHUD
+#include "frame.h"          // frame_SetTheme
+#include "atlas.h"          // atlas_Initialize
+#include "resource.h"       // resource_LoadFont
+#include "render.h"         // render_SetBackend
+#include "bench.h"          // bench_Run
+
+//**************************************************************
+/// Number of letters animated per frame by default.
+#define DEFAULT_LETTERS 10000
+
+/// Number of frames timed.
+#define N_FRAMES 1000
+
+/// Number of frames animated before timing starts.
+#define WARMUP_FRAMES 100
+
+/// Time step of one frame.
+#define FRAME_TIME (1.0f/60.0f)
+
+/// Number of words drawn by default in draws mode.
+#define DEFAULT_DRAW_WORDS 16
+
+/// Most words drawn in draws mode, so every HUD has its own
+/// cache slot.
+#define MAX_DRAW_WORDS 64
+
+/// Level of the words drawn.
+#define DRAW_LEVEL 10
+
+/// Words drawn in draws mode, reused in turn.
+static const char *const GlobalDrawWords[] = {
+    "Spite", "Skylarks", "Afghanistan", "Fjord",
+    "Explosion", "Death", "Depression", "Nnn",
+};
+
+/// Number of distinct words drawn.
+#define N_DRAW_WORDS ((int)(sizeof(GlobalDrawWords)/sizeof(GlobalDrawWords[0])))
+
+/**********************************************************//**
+ * @brief Gets a random number in a range.
+ * @param low: Lowest value.
+ * @param high: Highest value.
+ * @return The random number.
+ **************************************************************/
+static float Random(float low, float high) {
+    return low + (high - low)*(rand() / (float)RAND_MAX);
+}
+
+/**********************************************************//**
+ * @brief Starts every letter in the system exploding.
+ * @param system: The system to animate.
+ **************************************************************/
+static void Explode(LETTER_SYSTEM *system) {
+    for (int i = 0; i < system->used; i++) {
+        system->xv[i] = Random(-24.0, 24.0);
+        system->yv[i] = Random(48.0, 96.0);
+        system->rv[i] = Random(-3.5, 3.5);
+        system->sv[i] = Random(-0.5, 0.5);
+        system->ov[i] = -0.5;
+        system->speed[i] = 2.0;
+        system->gravity[i] = 128.0;
+        system->drag[i] = 0.1;
+        system->floor[i] = 0.0;
+        system->bounce[i] = -0.8;
+    }
+}
+
+/**********************************************************//**
+ * @brief Animates every letter for one frame.
+ * @param data: The letter system.
+ **************************************************************/
+static void BenchFrame(void *data) {
+    letterSystem_Update(data, FRAME_TIME);
+}
+
+/*============================================================*
+ * Counting drawing requests
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Sets up Allegro, the atlas, the theme and the word
+ * drawing modules without a display. Bitmaps live in memory
+ * and nothing reaches the screen.
+ * @return Whether everything could be set up.
+ **************************************************************/
+static bool StartDrawing(void) {
+    if (!al_init() || !al_init_font_addon() || !al_init_ttf_addon()
+            || !al_init_image_addon() || !al_init_primitives_addon()) {
+        eprintf("Failed to initialize allegro.\n");
+        return false;
+    }
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    if (!atlas_Initialize() || !resource_Initialize()) {
+        eprintf("Failed to create the atlas.\n");
+        return false;
+    }
+    if (!wordTable_Load("data/words/english.txt")) {
+        eprintf("Failed to load word table.\n");
+        return false;
+    }
+    
+    // The same theme as the game
+    THEME theme;
+    theme.font = resource_LoadFont("data/font/wordsmith.ttf", 16, ALLEGRO_TTF_MONOCHROME);
+    if (!theme.font) {
+        eprintf("Failed to load the font.\n");
+        return false;
+    }
+    theme.foreground = al_map_rgb(42, 42, 42);
+    theme.background = al_map_rgb(255, 255, 255);
+    theme.highlight = al_map_rgb(207, 82, 82);
+    theme.disabled = al_map_rgb(128, 128, 128);
+    theme.outline = 1;
+    theme.padding = 2;
+    theme.header = 4;
+    theme.spacing = 2;
+    frame_SetTheme(&theme);
+    wordSprite_Initialize();
+    wordFrame_Initialize();
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Releases everything made by StartDrawing.
+ **************************************************************/
+static void StopDrawing(void) {
+    wordSprite_Destroy();
+    wordFrame_Destroy();
+    resource_Release(frame_GetTheme()->font);
+    resource_Destroy();
+    atlas_Destroy();
+    wordTable_Destroy();
+}
+
+/**********************************************************//**
+ * @brief Writes the requests made since the last reset as one
+ * JSON result, and starts counting again.
+ * @param name: Name of what was drawn.
+ * @param last: Whether this is the last result.
+ **************************************************************/
+static void WriteDraws(const char *name, bool last) {
+    RENDER_STATS stats;
+    render_GetStats(&stats);
+    render_ResetStats();
+    printf("    {\"name\": \"%s\", \"bitmaps\": %d, \"rectangles\": %d, \"texts\": %d, "
+        "\"primitives\": %d, \"vertices\": %d, \"batches\": %d}%s\n",
+        name, stats.bitmaps, stats.rectangles, stats.texts,
+        stats.primitives, stats.vertices, stats.batches, last? "": ",");
+    fprintf(stderr, "%-32s %6d draw calls\n", name, stats.bitmaps + stats.rectangles + stats.texts + stats.primitives);
+}
+
+/**********************************************************//**
+ * @brief Counts the drawing requests made for words one at a
+ * time and all at once, and for their HUDs when rendered and
+ * when cached.
+ * @param nWords: Number of words to draw.
+ * @return Whether the words could be drawn.
+ **************************************************************/
+static bool CountDraws(int nWords) {
+    // Sprites can't move once loaded, so they are allocated once
+    WORD *words = calloc(nWords, sizeof(WORD));
+    WORD_SPRITE *sprites = calloc(nWords, sizeof(WORD_SPRITE));
+    const WORD_SPRITE **drawn = calloc(nWords, sizeof(WORD_SPRITE *));
+    if (!words || !sprites || !drawn) {
+        eprintf("Out of memory.\n");
+        free(words);
+        free(sprites);
+        free(drawn);
+        return false;
+    }
+    for (int i = 0; i < nWords; i++) {
+        word_Create(&words[i], GlobalDrawWords[i % N_DRAW_WORDS], DRAW_LEVEL);
+        sprites[i].first = -1;
+        wordSprite_Load(&sprites[i], 0, 0, &words[i]);
+        drawn[i] = &sprites[i];
+    }
+    
+    // Only record the requests from here on
+    render_SetBackend(RENDER_BACKEND_NULL);
+    render_ResetStats();
+    printf("{\n  \"suite\": \"letters\",\n  \"unit\": \"requests\",\n  \"results\": [\n");
+    for (int i = 0; i < nWords; i++) {
+        wordSprite_Draw(&sprites[i]);
+    }
+    WriteDraws("wordSprite_Draw", false);
+    wordSprite_DrawAll(drawn, nWords);
+    WriteDraws("wordSprite_DrawAll", false);
+    for (int i = 0; i < nWords; i++) {
+        wordFrame_DrawHUD(&words[i], 0, 0, HUD_FULL, false);
+    }
+    WriteDraws("wordFrame_DrawHUD/render", false);
+    for (int i = 0; i < nWords; i++) {
+        wordFrame_DrawHUD(&words[i], 0, 0, HUD_FULL, false);
+    }
+    WriteDraws("wordFrame_DrawHUD/cached", true);
+    printf("  ]\n}\n");
+    render_SetBackend(RENDER_BACKEND_ALLEGRO);
+    
+    for (int i = 0; i < nWords; i++) {
+        wordSprite_Unload(&sprites[i]);
+    }
+    free(words);
+    free(sprites);
+    free(drawn);
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Benchmark driver method.
+ **************************************************************/
+int main(int argc, char **argv) {
+    // Arguments check
+    if (argc > 1 && !strcmp(argv[1], "-h")) {
+        eprintf("Usage: %s [letters]?\n", argv[0]);
+        eprintf("       %s draws [words]?\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    
+    // Count drawing requests instead of timing
+    if (argc > 1 && !strcmp(argv[1], "draws")) {
+        int nWords = argc > 2? atoi(argv[2]): DEFAULT_DRAW_WORDS;
+        if (nWords <= 0 || nWords > MAX_DRAW_WORDS) {
+            eprintf("Invalid benchmark size.\n");
+            return EXIT_FAILURE;
+        }
+        if (!StartDrawing()) {
+            return EXIT_FAILURE;
+        }
+        bool counted = CountDraws(nWords);
+        StopDrawing();
+        return counted? EXIT_SUCCESS: EXIT_FAILURE;
+    }
+    int nLetters = argc > 1? atoi(argv[1]): DEFAULT_LETTERS;
+    if (nLetters <= 0) {
+        eprintf("Invalid benchmark size.\n");
+        return EXIT_FAILURE;
+    }
+    
+    // Fill a system with exploding words
+    LETTER_SYSTEM system;
+    int nWords = (nLetters + LETTER_BLOCK - 1) / LETTER_BLOCK;
+    if (!letterSystem_Create(&system, nWords)) {
+        eprintf("Failed to create the letter system.\n");
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < nWords; i++) {
+        letterSystem_Allocate(&system);
+    }
+    srand(0);
+    Explode(&system);
+    
+    // Time one frame per repetition
+    BENCH_REPORT report = {.suite = "letters", .nResults = 0};
+    bench_Run(&report, "letterSystem_Update", BenchFrame, &system, system.used, WARMUP_FRAMES, N_FRAMES);
+    bench_WriteJSON(&report, stdout);
+    
+    letterSystem_Destroy(&system);
+    return EXIT_SUCCESS;
+}
+
+/*============================================================*/
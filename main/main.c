@@ -8,6 +8,7 @@
 #include <stdlib.h>         // malloc, srand
 #include <stdbool.h>        // bool
 #include <stdio.h>          // printf, fopen, fclose ...
+#include <string.h>         // strcmp, strcpy
 #include <time.h>           // time
 
 // Allegro
@@ -23,26 +24,76 @@
 #include "window.h"         // window size
 #include "frame_rate.h"     // FrameRate
 #include "frame.h"          // FRAME
+#include "atlas.h"          // atlas_Initialize
+#include "resource.h"       // resource_LoadFont
+#include "loader.h"         // loader_Start
+#include "redraw.h"         // redraw_Invalidate
+#include "render.h"         // render_DrawText
+#include "format.h"         // format_Fixed
 #include "word_sprite.h"    // WORD_SPRITE
 #include "word_frame.h"     // WORD_FRAME
 #include "word_table.h"     // WORD_TABLE
 #include "player.h"
 #include "player_frame.h"
+#include "profile.h"        // PROFILE_ZONE
+#include "profile_frame.h"  // profileFrame_Draw
 
 //*************************************************************
-/// The frame rate of the game.
+/// The frame rate of the game, when the display doesn't say.
 #define FRAME_RATE 60.0
 
+/// Length of one simulation step, in seconds.
+#define TIME_STEP (1.0/60.0)
+
+/// Most simulation steps run between two frames, so that a
+/// stall doesn't snowball into ever longer catch-ups.
+#define MAX_STEPS 8
+
+/// How often the frame rate display is refreshed, in seconds.
+#define FRAME_RATE_REFRESH 1.0
+
+/// Number of loader threads, so the dictionary and the images
+/// load side by side.
+#define LOADER_THREADS 2
+
+/// Height of the loading screen's progress bar.
+#define LOADING_BAR_HEIGHT 8
+
 //*************************************************************
 /// Debugging font.
 static ALLEGRO_FONT *GlobalDebugFont;
 
+/// Frame rate text currently on the screen.
+static char GlobalFrameRateText[64];
+
+/// Time since the frame rate text was refreshed.
+static float GlobalFrameRateTimer = FRAME_RATE_REFRESH;
+
 static WORD Word;
 static WORD_SPRITE Sprite;
 
 static PLAYER Player;
 static TEAM_MENU TeamMenu;
 
+#ifdef PROFILE
+/// Whether the frame-time graph is shown.
+static bool GlobalShowProfile = false;
+#endif
+
+/**********************************************************//**
+ * @brief Loader job that reads the real word table.
+ * @param data: Unused.
+ * @return Whether the table was loaded.
+ **************************************************************/
+static bool loadDictionary(void *data) {
+    (void)data;
+    if (!wordTable_Load("data/words/english.txt")) {
+        eprintf("Failed to load the real word table.\n");
+        return false;
+    }
+    return true;
+}
+
 /**********************************************************//**
  * @brief Program setup function.
  * @return Whether the setup succeeded. The program must be
@@ -52,7 +103,7 @@ static TEAM_MENU TeamMenu;
 static bool setup(void) {
     // Random number generator setup
     srand(time(NULL));
-
+    
     // Allegro setup
     if (!al_init()) {
         eprintf("Failed to initialize allegro.\n");
@@ -88,9 +139,21 @@ static bool setup(void) {
     // Timer setup
     RegisterTimer(&al_get_time);
     
+    // Images and glyphs are packed into one texture
+    if (!atlas_Initialize()) {
+        eprintf("Failed to create the texture atlas.\n");
+        return false;
+    }
+    
+    // Fonts and images are shared through the cache
+    if (!resource_Initialize()) {
+        eprintf("Failed to create the resource cache.\n");
+        return false;
+    }
+    
     // Set up theme
     THEME theme;
-    theme.font = al_load_ttf_font("data/font/wordsmith.ttf", 16, ALLEGRO_TTF_MONOCHROME);
+    theme.font = resource_LoadFont("data/font/wordsmith.ttf", 16, ALLEGRO_TTF_MONOCHROME);
     if (!theme.font) {
         eprintf("Failed to load the font.\n");
         return false;
@@ -105,16 +168,36 @@ static bool setup(void) {
     theme.spacing = 2;
     frame_SetTheme(&theme);
     
-    // Set up real word table
-    if (!wordTable_Load("data/words/english.txt")) {
-        eprintf("Failed to load the real word table.\n");
+    // System setup. This is the theme's font, so it comes from
+    // the cache.
+    GlobalDebugFont = resource_LoadFont("data/font/wordsmith.ttf", 16, ALLEGRO_TTF_MONOCHROME);
+    if (!GlobalDebugFont) {
+        eprintf("Failed to load system debug font.\n");
         return false;
     }
     
-    // System setup
-    GlobalDebugFont = al_load_ttf_font("data/font/wordsmith.ttf", 16, ALLEGRO_TTF_MONOCHROME);
-    if (!GlobalDebugFont) {
-        eprintf("Failed to load system debug font.\n");
+    // Read the dictionary and decode images in the background
+    // while the display opens.
+    if (!loader_Start(LOADER_THREADS)) {
+        eprintf("Failed to start the loader.\n");
+        return false;
+    }
+    if (!loader_Add(loadDictionary, NULL)) {
+        return false;
+    }
+    wordFrame_Preload();
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Finishes setup once the loader is done. This runs on
+ * the main thread, since it uploads to the display.
+ * @return Whether the setup succeeded. The program must be
+ * aborted if this function fails.
+ **************************************************************/
+static bool start(void) {
+    if (!loader_Finish()) {
+        eprintf("Failed to load the game data.\n");
         return false;
     }
     
@@ -123,6 +206,9 @@ static bool setup(void) {
     wordSprite_Initialize();
     wordFrame_Initialize();
     
+    // The decoded images are in the atlas now
+    resource_Purge();
+    
     // Game initialization
     if (!player_Create(&Player, "Wes")) {
         eprintf("Unable to initialize player data.\n");
@@ -164,30 +250,91 @@ static bool setup(void) {
  **************************************************************/
 static void cleanup(void) {
     // Destroy resources
+    loader_Finish();
+    redraw_Destroy();
     wordTable_Destroy();
+    wordSprite_Destroy();
+    wordFrame_Destroy();
+    resource_Release(GlobalDebugFont);
+    resource_Release(frame_GetTheme()->font);
+    resource_Destroy();
+    atlas_Destroy();
+}
+
+/**********************************************************//**
+ * @brief Draws the loading screen straight to the display.
+ **************************************************************/
+static void renderLoading(void) {
+    int done, total;
+    loader_GetProgress(&done, &total);
+    float ratio = total > 0? (float)done / total: 1.0;
+    
+    // Caption above a progress bar in the middle of the screen
+    int x = WINDOW_WIDTH/4;
+    int y = WINDOW_HEIGHT/2;
+    int width = WINDOW_WIDTH/2;
+    al_clear_to_color(al_map_rgb(0, 0, 0));
+    render_DrawText(GlobalDebugFont, al_map_rgb(255, 255, 255), x, y - al_get_font_line_height(GlobalDebugFont) - 4, ALLEGRO_ALIGN_LEFT, "Loading...");
+    atlas_DrawRectangle(x, y, x + width, y + LOADING_BAR_HEIGHT, al_map_rgb(64, 64, 64));
+    atlas_DrawRectangle(x, y, x + width*ratio, y + LOADING_BAR_HEIGHT, al_map_rgb(207, 82, 82));
+    al_flip_display();
 }
 
 /**********************************************************//**
  * @brief Screen rendering function.
  **************************************************************/
 static void render(void) {
+    PROFILE_ZONE("render");
+    
+    // Defer drawing so the frame goes out in a few draw calls
+    atlas_BeginBatch();
+    
     // Draw the frame rate
-    char buf[64];
-    sprintf(buf, "%0.1lf FPS", FrameRate());
-    al_draw_text(GlobalDebugFont, al_map_rgb(255, 255, 255), 1, 1, ALLEGRO_ALIGN_LEFT, buf);
+    render_DrawText(GlobalDebugFont, al_map_rgb(255, 255, 255), 1, 1, ALLEGRO_ALIGN_LEFT, GlobalFrameRateText);
     
     // Render stats
     playerFrame_DrawTeam(&TeamMenu);
+    
+#ifdef PROFILE
+    // Frame times, in the bottom left corner
+    if (GlobalShowProfile) {
+        profileFrame_Draw(0, WINDOW_HEIGHT - PROFILE_GRAPH_HEIGHT);
+    }
+#endif
+    atlas_EndBatch();
 }
 
 /**********************************************************//**
  * @brief Update loop function.
  **************************************************************/
 static bool update(float dt) {
-    // Record the frame for frame rate
-    RegisterFrame();
+    PROFILE_ZONE("update");
+    
+    // Refresh the frame rate text only occasionally, so that it
+    // doesn't keep the screen from idling.
+    GlobalFrameRateTimer += dt;
+    if (GlobalFrameRateTimer >= FRAME_RATE_REFRESH) {
+        GlobalFrameRateTimer = 0.0;
+        char buf[sizeof(GlobalFrameRateText)];
+        int length = format_Fixed(buf, (int)(FrameRate()*10.0 + 0.5), 1);
+        strcpy(buf + length, " FPS");
+        if (strcmp(buf, GlobalFrameRateText)) {
+            strcpy(GlobalFrameRateText, buf);
+            redraw_Invalidate(0, 0, al_get_text_width(GlobalDebugFont, buf)+2, al_get_font_line_height(GlobalDebugFont)+2);
+        }
+    }
     
     playerFrame_UpdateTeam(&TeamMenu, dt);
+    
+    // Move the letters of every word at once
+    wordSprite_Step(dt);
+    
+#ifdef PROFILE
+    // The graph changes every frame
+    if (GlobalShowProfile) {
+        redraw_Invalidate(0, WINDOW_HEIGHT - PROFILE_GRAPH_HEIGHT, PROFILE_GRAPH_WIDTH, PROFILE_GRAPH_HEIGHT);
+    }
+#endif
     return true;
 }
 
@@ -209,6 +356,18 @@ static void keyboard(int key, bool down) {
     } else if (key == ALLEGRO_KEY_LEFT && down) {
         playerFrame_InteractTeam(&TeamMenu, TEAM_MENU_LEFT);
     }
+#ifdef PROFILE
+    else if (key == ALLEGRO_KEY_F3 && down) {
+        GlobalShowProfile = !GlobalShowProfile;
+        redraw_Invalidate(0, WINDOW_HEIGHT - PROFILE_GRAPH_HEIGHT, PROFILE_GRAPH_WIDTH, PROFILE_GRAPH_HEIGHT);
+    } else if (key == ALLEGRO_KEY_F11 && down) {
+        resource_Report(stdout);
+    } else if (key == ALLEGRO_KEY_F12 && down) {
+        if (profile_WriteTrace("trace.json")) {
+            printf("Wrote trace.json\n");
+        }
+    }
+#endif
 }
 
 /**********************************************************//**
@@ -241,6 +400,12 @@ int main(int argc, char **argv) {
         return EXIT_FAILURE;
     }
     
+    // Draw at the display's refresh rate when it is known
+    int refreshRate = al_get_display_refresh_rate(display);
+    if (refreshRate > 0) {
+        al_set_timer_speed(timer, 1.0 / refreshRate);
+    }
+    
     // Event queue setup
     ALLEGRO_EVENT_QUEUE *queue;
     if (!(queue = al_create_event_queue())) {
@@ -256,48 +421,101 @@ int main(int argc, char **argv) {
     al_clear_to_color(background);
     al_flip_display();
     
+    // Only changed parts of the screen are redrawn
+    redraw_Initialize(WINDOW_WIDTH, WINDOW_HEIGHT);
+    
     // Start game
     al_start_timer(timer);
     
     // Game loop
     ALLEGRO_EVENT event;
     bool running = true;
+    bool loading = true;
     bool redraw = false;
-    float previous = al_get_time();
-    float current;
+    double previous = al_get_time();
+    double current;
+    double lag = 0.0;
     while (running) {
         // Get the next event
         al_wait_for_event(queue, &event);
         switch (event.type) {
         case ALLEGRO_EVENT_TIMER:
-            // Compute the time step and update
+            PROFILE_FRAME();
+            
+            // Show the loading screen until the loader is done
+            if (loading) {
+                if (!loader_IsFinished()) {
+                    renderLoading();
+                    break;
+                }
+                loading = false;
+                if (!(running = start())) {
+                    break;
+                }
+                redraw_InvalidateAll();
+                previous = al_get_time();
+            }
+            
+            // Run fixed simulation steps for the elapsed time
             current = al_get_time();
-            running = update(current-previous);
+            lag += current - previous;
             previous = current;
+            if (lag > MAX_STEPS*TIME_STEP) {
+                lag = MAX_STEPS*TIME_STEP;
+            }
+            if (lag >= TIME_STEP) {
+                redraw_BeginStep();
+                while (running && lag >= TIME_STEP) {
+                    running = update(TIME_STEP);
+                    lag -= TIME_STEP;
+                }
+            } else {
+                redraw_RepeatStep();
+            }
+            
+            // Draw the leftover time blended between the last
+            // two steps
+            frame_SetInterpolation(lag / TIME_STEP);
             redraw = true;
             break;
-            
+        
         case ALLEGRO_EVENT_DISPLAY_CLOSE:
             running = false;
             break;
         
+        case ALLEGRO_EVENT_DISPLAY_EXPOSE:
+        case ALLEGRO_EVENT_DISPLAY_SWITCH_IN:
+            redraw_InvalidateAll();
+            break;
+        
         case ALLEGRO_EVENT_KEY_CHAR:
-            keyboard(event.keyboard.keycode, true);
+            if (!loading) {
+                keyboard(event.keyboard.keycode, true);
+            }
             break;
         
         case ALLEGRO_EVENT_KEY_UP:
-            keyboard(event.keyboard.keycode, false);
+            if (!loading) {
+                keyboard(event.keyboard.keycode, false);
+            }
             break;
-            
+        
         default:
             break;
         }
         
-        // Redraw the screen
+        // Redraw the screen, skipping the flip if nothing changed
         if (running && redraw && al_is_event_queue_empty(queue)) {
-            al_clear_to_color(background);
-            render();
-            al_flip_display();
+            if (redraw_IsNeeded()) {
+                redraw_Begin(background);
+                render();
+                redraw_End();
+                al_flip_display();
+                
+                // Only frames actually shown count toward the
+                // frame rate
+                RegisterFrame();
+            }
             redraw = false;
         }
     }
@@ -0,0 +1,134 @@
+/**********************************************************//**
+ * @file test.h
+ * @brief Shared word list for the testing programs. Every word
+ * of a dictionary is copied out so that the structure under
+ * test can be checked against a plain scan.
+ **************************************************************/
+
+#ifndef _TEST_H_
+#define _TEST_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+#include <stdlib.h>     // malloc, realloc, free
+#include <string.h>     // strlen, memcpy
+
+// This project
+#include "word.h"       // WORD
+
+/**********************************************************//**
+ * @struct TEST_LIST
+ * @brief Every word walked, in the order walked. Zero-initialize
+ * before walking, and fill with only one of test_AddText and
+ * test_AddWord.
+ **************************************************************/
+typedef struct {
+    char **texts;       ///< Copy of the text of each word.
+    WORD *words;        ///< Each word made, if walked with test_AddWord.
+    int *lengths;       ///< Letters in each word, likewise.
+    int count;          ///< Number of words.
+    int capacity;       ///< Words allocated.
+    bool failed;        ///< Whether memory ran out.
+} TEST_LIST;
+
+/**********************************************************//**
+ * @brief Makes room for one more word.
+ * @param list: The list.
+ * @param withWords: Whether the words and lengths are kept.
+ * @return Whether there is room.
+ **************************************************************/
+static inline bool test_Grow(TEST_LIST *list, bool withWords) {
+    if (list->failed) {
+        return false;
+    }
+    if (list->count < list->capacity) {
+        return true;
+    }
+    int capacity = 2*list->capacity + 1024;
+    char **texts = realloc(list->texts, capacity*sizeof(*texts));
+    if (texts) {
+        list->texts = texts;
+    }
+    bool grown = texts != NULL;
+    if (withWords) {
+        WORD *words = realloc(list->words, capacity*sizeof(*words));
+        if (words) {
+            list->words = words;
+        }
+        int *lengths = realloc(list->lengths, capacity*sizeof(*lengths));
+        if (lengths) {
+            list->lengths = lengths;
+        }
+        grown &= words && lengths;
+    }
+    if (!grown) {
+        list->failed = true;
+        return false;
+    }
+    list->capacity = capacity;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Copies the text of a word to the end of the list.
+ * @param list: The list, with room for the word.
+ * @param text: The text.
+ * @return Whether the text was copied.
+ **************************************************************/
+static inline bool test_CopyText(TEST_LIST *list, const char *text) {
+    size_t bytes = strlen(text) + 1;
+    char *copy = malloc(bytes);
+    if (!copy) {
+        list->failed = true;
+        return false;
+    }
+    memcpy(copy, text, bytes);
+    list->texts[list->count] = copy;
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Adds the text of a word to the list. Walks the words
+ * of a language or table.
+ * @param data: The TEST_LIST.
+ * @param text: The text.
+ **************************************************************/
+static inline void test_AddText(void *data, const char *text) {
+    TEST_LIST *list = data;
+    if (test_Grow(list, false) && test_CopyText(list, text)) {
+        list->count++;
+    }
+}
+
+/**********************************************************//**
+ * @brief Adds a word and its text to the list. Walks the words
+ * made from a dictionary.
+ * @param data: The TEST_LIST.
+ * @param text: The lowercase word.
+ * @param word: The word made from it.
+ * @param length: Letters in the word.
+ **************************************************************/
+static inline void test_AddWord(void *data, const char *text, const WORD *word, int length) {
+    TEST_LIST *list = data;
+    if (test_Grow(list, true) && test_CopyText(list, text)) {
+        list->words[list->count] = *word;
+        list->lengths[list->count] = length;
+        list->count++;
+    }
+}
+
+/**********************************************************//**
+ * @brief Frees every word in the list.
+ * @param list: The list.
+ **************************************************************/
+static inline void test_FreeList(TEST_LIST *list) {
+    for (int i = 0; i < list->count; i++) {
+        free(list->texts[i]);
+    }
+    free(list->texts);
+    free(list->words);
+    free(list->lengths);
+}
+
+/*============================================================*/
+#endif // _TEST_H_
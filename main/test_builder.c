@@ -0,0 +1,182 @@
+/**********************************************************//**
+ * @file test_builder.c
+ * @brief Testing program for typing words a letter at a time.
+ * Random letters are typed and deleted, and after every key
+ * the word is checked against making it from scratch.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>    // bool
+#include <stdio.h>      // printf
+#include <stdlib.h>     // EXIT_SUCCESS, EXIT_FAILURE
+#include <string.h>     // strlen, strcmp, strncmp
+
+// This project
+#include "debug.h"      // eprintf
+#include "word.h"       // word_PushLetter
+#include "word_trie.h"  // wordTrie_Create
+#include "word_table.h" // wordTable_Load
+#include "language.h"   // language_GetEnglish
+#include "word_sampler.h" // wordSampler_Draw
+#include "test.h"       // TEST_LIST
+
+//**************************************************************
+/// Dictionary used by the test.
+#define DICTIONARY "data/words/english.txt"
+
+/// Keys pressed.
+#define N_KEYS 200000
+
+/// Level of the words made.
+#define TEST_LEVEL 5
+
+/// Letters typed at random. Capitals are folded as they are typed.
+#define TEST_LETTERS "abcdefghijklmnopqrstuvwxyzAEIOU"
+
+/**********************************************************//**
+ * @brief Adds a dictionary word to the list, if it is short
+ * enough to type.
+ * @param data: The TEST_LIST.
+ * @param word: The word.
+ **************************************************************/
+static void AddTypeable(void *data, const char *word) {
+    if (strlen(word) <= MAX_WORD_LENGTH) {
+        test_AddText(data, word);
+    }
+}
+
+/**********************************************************//**
+ * @brief Checks if any word starts with some text.
+ * @param list: Every word of the dictionary.
+ * @param text: The lowercase text.
+ * @return Whether a word starts with it.
+ **************************************************************/
+static bool IsPrefix(const TEST_LIST *list, const char *text) {
+    int low = 0;
+    int high = list->count;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (strcmp(list->texts[middle], text) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low < list->count && !strncmp(list->texts[low], text, strlen(text));
+}
+
+/**********************************************************//**
+ * @brief Checks a word being typed against the text typed.
+ * @param builder: The word being typed.
+ * @param list: Every word of the dictionary.
+ * @param text: The lowercase text typed.
+ * @return Whether the word is right.
+ **************************************************************/
+static bool CheckBuilder(const WORD_BUILDER *builder, const TEST_LIST *list, const char *text) {
+    int length = strlen(text);
+    if (strcmp(builder->lower, text)) {
+        eprintf("Typed \"%s\" but have \"%s\".\n", text, builder->lower);
+        return false;
+    }
+    if (word_BuilderIsReal(builder) != (length >= MIN_WORD_LENGTH && wordTable_Contains(text))) {
+        eprintf("\"%s\" is wrongly %s.\n", text, word_BuilderIsReal(builder)? "real": "not real");
+        return false;
+    }
+    if (word_BuilderCanBeReal(builder) != IsPrefix(list, text)) {
+        eprintf("\"%s\" wrongly %s.\n", text, word_BuilderCanBeReal(builder)? "can be real": "can't be real");
+        return false;
+    }
+    if (length < MIN_WORD_LENGTH) {
+        return true;
+    }
+    
+    // The word must be the same as one made from scratch
+    WORD typed;
+    WORD made;
+    if (!word_CreateFromBuilder(&typed, builder, TEST_LEVEL) || !word_Create(&made, text, TEST_LEVEL)) {
+        eprintf("Failed to make \"%s\".\n", text);
+        return false;
+    }
+    bool same = !strcmp(typed.text, made.text) && typed.flags == made.flags && typed.rank == made.rank
+        && typed.level == made.level && typed.hp == made.hp && typed.nTechs == made.nTechs;
+    for (int i = 0; same && i < N_STATS; i++) {
+        same = typed.base[i] == made.base[i] && typed.stat[i] == made.stat[i];
+    }
+    for (int i = 0; same && i < typed.nTechs; i++) {
+        same = typed.techs[i] == made.techs[i];
+    }
+    if (!same) {
+        eprintf("Typing \"%s\" made a different word.\n", text);
+    }
+    return same;
+}
+
+/**********************************************************//**
+ * @brief test driver method.
+ **************************************************************/
+int main(void) {
+    // Get the word table, its trie, and real words to type
+    if (!wordTable_Load(DICTIONARY)) {
+        eprintf("Failed to load word table.\n");
+        return EXIT_FAILURE;
+    }
+    const LANGUAGE *language = language_GetEnglish();
+    TEST_LIST list = {0};
+    language_Walk(language, AddTypeable, &list);
+    WORD_TRIE *trie = wordTrie_Create(language);
+    WORD_SAMPLER *sampler = wordSampler_Create(language, NULL, NULL);
+    if (list.failed || !trie || !sampler) {
+        eprintf("Failed to make the dictionary.\n");
+        return EXIT_FAILURE;
+    }
+    
+    // Type random letters and real words, deleting some and
+    // starting over now and then
+    WORD_BUILDER builder;
+    word_StartBuilder(&builder, language, trie);
+    char text[MAX_WORD_BYTES+1] = "";
+    int length = 0;
+    int failures = 0;
+    WORD_RNG rng;
+    wordSampler_Seed(&rng, 1);
+    for (int i = 0; i < N_KEYS && failures < 10; i++) {
+        int key = wordSampler_Random(&rng) % 20;
+        if (key < 6 && length > 0) {
+            failures += !word_PopLetter(&builder);
+            text[--length] = '\0';
+        } else if (key == 6) {
+            word_StartBuilder(&builder, language, trie);
+            failures += word_PopLetter(&builder);
+            text[length = 0] = '\0';
+        } else if (key == 7 && length == 0) {
+            const char *word = wordSampler_Draw(sampler, &rng, SAMPLE_ANY, 0);
+            for (int j = 0; word[j]; j++) {
+                char letter[2] = {word[j], '\0'};
+                failures += !word_PushLetter(&builder, letter);
+                text[length++] = word[j];
+            }
+            text[length] = '\0';
+        } else {
+            char letter[2] = {TEST_LETTERS[wordSampler_Random(&rng) % (sizeof(TEST_LETTERS) - 1)], '\0'};
+            bool pushed = word_PushLetter(&builder, letter);
+            if (pushed != (length < MAX_WORD_LENGTH)) {
+                eprintf("Pushing a letter onto \"%s\" %s.\n", text, pushed? "worked": "failed");
+                failures++;
+            }
+            if (pushed) {
+                text[length++] = letter[0] | 0x20;
+                text[length] = '\0';
+            }
+        }
+        failures += !CheckBuilder(&builder, &list, text);
+    }
+    printf("Typed %d keys with %d failures.\n", N_KEYS, failures);
+    
+    wordSampler_Free(sampler);
+    wordTrie_Free(trie);
+    test_FreeList(&list);
+    wordTable_Destroy();
+    return failures? EXIT_FAILURE: EXIT_SUCCESS;
+}
+
+/*============================================================*/
@@ -0,0 +1,238 @@
+/**********************************************************//**
+ * @file test_index.c
+ * @brief Testing program for the dictionary index. Random
+ * queries and searches for the closest words are checked
+ * against a scan of every word.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>    // bool
+#include <stdio.h>      // printf
+#include <stdlib.h>     // EXIT_SUCCESS, EXIT_FAILURE
+#include <string.h>     // strcmp
+
+// This project
+#include "debug.h"      // eprintf
+#include "word.h"       // word_WalkDictionary
+#include "word_table.h" // wordTable_Load
+#include "language.h"   // language_GetEnglish
+#include "technique.h"  // N_TECHNIQUES
+#include "word_index.h" // wordIndex_Query, wordIndex_FindNearest
+#include "word_sampler.h" // wordSampler_Random
+#include "test.h"       // TEST_LIST
+
+//**************************************************************
+/// Dictionary used by the test.
+#define DICTIONARY "data/words/english.txt"
+
+/// Random queries checked.
+#define N_QUERIES 2000
+
+/// Most matches read out of one query.
+#define MAX_MATCHES 256
+
+/// Dictionary words skipped between the words matched.
+#define NEAREST_STRIDE 97
+
+/// Closest words found per search.
+#define N_NEIGHBORS 10
+
+/**********************************************************//**
+ * @brief Checks if a word matches a query.
+ * @param list: Every word of the dictionary.
+ * @param id: The number of the word.
+ * @param query: The words to find.
+ * @return Whether it matches.
+ **************************************************************/
+static bool Matches(const TEST_LIST *list, int id, const WORD_QUERY *query) {
+    const WORD *word = &list->words[id];
+    if (word->rank < query->minRank || word->rank > query->maxRank
+            || list->lengths[id] < query->minLength || list->lengths[id] > query->maxLength) {
+        return false;
+    }
+    for (int i = 0; i < query->nTechs; i++) {
+        bool known = false;
+        for (int j = 0; j < word->nTechs; j++) {
+            known |= word->techs[j] == query->techs[i];
+        }
+        if (!known) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Makes a random query. Ranges are sometimes empty or
+ * past the ranks and lengths that exist.
+ * @param rng: The random number generator.
+ * @param query: Gets the query.
+ **************************************************************/
+static void RandomQuery(WORD_RNG *rng, WORD_QUERY *query) {
+    wordIndex_ClearQuery(query);
+    query->nTechs = wordSampler_Random(rng) % 3;
+    for (int i = 0; i < query->nTechs; i++) {
+        query->techs[i] = wordSampler_Random(rng) % N_TECHNIQUES;
+    }
+    if (wordSampler_Random(rng) % 2) {
+        query->minRank = wordSampler_Random(rng) % N_RANKS;
+        query->maxRank = wordSampler_Random(rng) % N_RANKS;
+    }
+    if (wordSampler_Random(rng) % 2) {
+        query->minLength = wordSampler_Random(rng) % (MAX_WORD_LENGTH + 2);
+        query->maxLength = wordSampler_Random(rng) % (MAX_WORD_LENGTH + 2);
+    }
+}
+
+/**********************************************************//**
+ * @brief Checks a query against a scan of every word.
+ * @param index: The index to search.
+ * @param list: Every word of the dictionary.
+ * @param query: The words to find.
+ * @return Whether the matches are the same.
+ **************************************************************/
+static bool CheckQuery(const WORD_INDEX *index, const TEST_LIST *list, const WORD_QUERY *query) {
+    int expected[MAX_MATCHES];
+    int nExpected = 0;
+    for (int i = 0; i < list->count; i++) {
+        if (Matches(list, i, query)) {
+            if (nExpected < MAX_MATCHES) {
+                expected[nExpected] = i;
+            }
+            nExpected++;
+        }
+    }
+    int ids[MAX_MATCHES];
+    int count = wordIndex_Query(index, query, ids, MAX_MATCHES);
+    bool same = count == nExpected && wordIndex_Query(index, query, NULL, 0) == count;
+    for (int i = 0; same && i < count && i < MAX_MATCHES; i++) {
+        same = ids[i] == expected[i];
+    }
+    if (!same) {
+        eprintf("Query for %d techniques (%d, %d), ranks %d to %d and %d to %d letters found %d words, not %d.\n",
+            query->nTechs, query->techs[0], query->techs[1], query->minRank, query->maxRank,
+            query->minLength, query->maxLength, count, nExpected);
+    }
+    return same;
+}
+
+/**********************************************************//**
+ * @brief Checks the words closest to a word against a scan of
+ * every word.
+ * @param index: The index to search.
+ * @param list: Every word of the dictionary.
+ * @param id: The number of the word to match.
+ * @param filter: Words that may be found, or NULL for any.
+ * @return Whether the closest words are the same.
+ **************************************************************/
+static bool CheckNearest(const WORD_INDEX *index, const TEST_LIST *list, int id, const WORD_QUERY *filter) {
+    // Keep the closest words seen, in dictionary order among
+    // equals as the words are scanned in order
+    const WORD *word = &list->words[id];
+    WORD_NEIGHBOR expected[N_NEIGHBORS];
+    int nExpected = 0;
+    for (int i = 0; i < list->count; i++) {
+        if (filter && !Matches(list, i, filter)) {
+            continue;
+        }
+        int distance = 0;
+        for (int j = 0; j < N_STATS; j++) {
+            int difference = list->words[i].base[j] - word->base[j];
+            distance += difference*difference;
+        }
+        int at = nExpected;
+        while (at > 0 && expected[at-1].distance > distance) {
+            at--;
+        }
+        if (at == N_NEIGHBORS) {
+            continue;
+        }
+        if (nExpected < N_NEIGHBORS) {
+            nExpected++;
+        }
+        for (int j = nExpected - 1; j > at; j--) {
+            expected[j] = expected[j-1];
+        }
+        expected[at].id = i;
+        expected[at].distance = distance;
+    }
+    
+    WORD_NEIGHBOR neighbors[N_NEIGHBORS];
+    int count = wordIndex_FindNearest(index, word, filter, neighbors, N_NEIGHBORS);
+    bool same = count == nExpected;
+    for (int i = 0; same && i < count; i++) {
+        same = neighbors[i].id == expected[i].id && neighbors[i].distance == expected[i].distance;
+    }
+    if (!same) {
+        eprintf("Closest words to \"%s\" differ:\n", list->texts[id]);
+        for (int i = 0; i < nExpected; i++) {
+            eprintf("  expected %s (%d)\n", list->texts[expected[i].id], expected[i].distance);
+        }
+        for (int i = 0; i < count; i++) {
+            eprintf("  found %s (%d)\n", wordIndex_GetText(index, neighbors[i].id), neighbors[i].distance);
+        }
+    }
+    return same;
+}
+
+/**********************************************************//**
+ * @brief test driver method.
+ **************************************************************/
+int main(void) {
+    // Get the word table and every word in it
+    if (!wordTable_Load(DICTIONARY)) {
+        eprintf("Failed to load word table.\n");
+        return EXIT_FAILURE;
+    }
+    TEST_LIST list = {0};
+    word_WalkDictionary(language_GetEnglish(), test_AddWord, &list);
+    WORD_INDEX *index = wordIndex_Create(language_GetEnglish());
+    if (list.failed || !index) {
+        eprintf("Failed to make the index.\n");
+        return EXIT_FAILURE;
+    }
+    
+    // The index numbers the words in dictionary order
+    int failures = 0;
+    if (wordIndex_GetSize(index) != list.count) {
+        eprintf("Index has %d words, not %d.\n", wordIndex_GetSize(index), list.count);
+        failures++;
+    }
+    for (int i = 0; i < list.count && i < wordIndex_GetSize(index); i++) {
+        if (strcmp(wordIndex_GetText(index, i), list.texts[i]) && !failures++) {
+            eprintf("Word %d of the index is \"%s\".\n", i, wordIndex_GetText(index, i));
+        }
+    }
+    
+    // Every technique alone, then random queries
+    WORD_QUERY query;
+    for (int t = 0; t < N_TECHNIQUES; t++) {
+        wordIndex_ClearQuery(&query);
+        query.techs[query.nTechs++] = t;
+        failures += !CheckQuery(index, &list, &query);
+    }
+    WORD_RNG rng;
+    wordSampler_Seed(&rng, 1);
+    for (int i = 0; i < N_QUERIES; i++) {
+        RandomQuery(&rng, &query);
+        failures += !CheckQuery(index, &list, &query);
+    }
+    
+    // The closest words to a spread of words, with and
+    // without a random filter
+    int searches = 0;
+    for (int i = 0; i < list.count; i += NEAREST_STRIDE) {
+        failures += !CheckNearest(index, &list, i, NULL);
+        RandomQuery(&rng, &query);
+        failures += !CheckNearest(index, &list, i, &query);
+        searches += 2;
+    }
+    printf("Checked %d queries and %d searches over %d words with %d failures.\n", N_TECHNIQUES + N_QUERIES, searches, list.count, failures);
+    
+    wordIndex_Free(index);
+    test_FreeList(&list);
+    wordTable_Destroy();
+    return failures? EXIT_FAILURE: EXIT_SUCCESS;
+}
+
+/*============================================================*/
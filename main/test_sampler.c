@@ -0,0 +1,239 @@
+/**********************************************************//**
+ * @file test_sampler.c
+ * @brief Testing program for random words. Draws are counted
+ * by rank or length and checked against the share each group
+ * should get, found by making every word of the dictionary.
+ **************************************************************/
+
+// Standard library
+#include <math.h>       // sqrt, fabs
+#include <stdbool.h>    // bool
+#include <stdio.h>      // printf
+#include <stdlib.h>     // EXIT_SUCCESS, EXIT_FAILURE
+
+// This project
+#include "debug.h"      // eprintf
+#include "word.h"       // word_WalkDictionary
+#include "word_table.h" // wordTable_Load
+#include "language.h"   // language_GetEnglish
+#include "technique.h"  // N_TECHNIQUES
+#include "word_sampler.h" // wordSampler_DrawWeighted
+
+//**************************************************************
+/// Dictionary used by the test.
+#define DICTIONARY "data/words/english.txt"
+
+/// Words drawn for each check.
+#define N_DRAWS 100000
+
+/// Words drawn for each technique.
+#define N_TECHNIQUE_DRAWS 10000
+
+/// Standard deviations a count may be from its expected value.
+#define MAX_DEVIATIONS 5.0
+
+/// Most groups the draws are counted in.
+#define MAX_GROUPS (N_WORD_LENGTHS > N_RANKS? N_WORD_LENGTHS: N_RANKS)
+
+/**********************************************************//**
+ * @struct WORD_TALLY
+ * @brief How many words of the dictionary, and how much
+ * weight, each length, rank and technique has.
+ **************************************************************/
+typedef struct {
+    int counts[N_WORD_LENGTHS][N_RANKS];        ///< Words of each length and rank.
+    double weights[N_WORD_LENGTHS][N_RANKS];    ///< Their total weight.
+    int techCounts[N_TECHNIQUES][N_RANKS];      ///< Words of each rank knowing each technique.
+} WORD_TALLY;
+
+/**********************************************************//**
+ * @brief Weighs words by their base stat total, except that
+ * words without techniques weigh nothing.
+ * @param data: Unused.
+ * @param word: The word.
+ * @return The weight.
+ **************************************************************/
+static double Weigh(const void *data, const WORD *word) {
+    (void)data;
+    if (word->nTechs == 0) {
+        return 0.0;
+    }
+    return word->base[STAT_MAXHP] + word->base[STAT_ATTACK] + word->base[STAT_DEFEND] + word->base[STAT_SPEED];
+}
+
+/**********************************************************//**
+ * @brief Counts a dictionary word.
+ * @param data: The WORD_TALLY.
+ * @param text: The lowercase word.
+ * @param word: The word made from it.
+ * @param length: Letters in the word.
+ **************************************************************/
+static void TallyWord(void *data, const char *text, const WORD *word, int length) {
+    (void)text;
+    WORD_TALLY *tally = data;
+    tally->counts[length - MIN_WORD_LENGTH][word->rank]++;
+    tally->weights[length - MIN_WORD_LENGTH][word->rank] += Weigh(NULL, word);
+    for (int i = 0; i < word->nTechs; i++) {
+        tally->techCounts[word->techs[i]][word->rank]++;
+    }
+}
+
+/**********************************************************//**
+ * @brief Draws words and checks that each group of them comes
+ * up as often as it should.
+ * @param sampler: The sampler to draw from.
+ * @param rng: The random number generator.
+ * @param by: What the draws are limited to.
+ * @param value: The length, RANK or TECHNIQUE to match.
+ * @param weighted: Whether to make weighted draws.
+ * @param byRank: Whether the groups are ranks, not lengths.
+ * @param expected: Expected share of each group, which may be
+ * in any units.
+ * @param nDraws: Number of words to draw.
+ * @return Whether the draws matched.
+ **************************************************************/
+static bool CheckDraws(const WORD_SAMPLER *sampler, WORD_RNG *rng, SAMPLE_BY by, int value, bool weighted, bool byRank, const double *expected, int nDraws) {
+    int nGroups = byRank? N_RANKS: N_WORD_LENGTHS;
+    double total = 0.0;
+    for (int i = 0; i < nGroups; i++) {
+        total += expected[i];
+    }
+    
+    // Every word drawn must match and have some weight
+    const LANGUAGE *language = language_GetEnglish();
+    int observed[MAX_GROUPS] = {0};
+    for (int i = 0; i < nDraws; i++) {
+        const char *text = weighted? wordSampler_DrawWeighted(sampler, rng, by, value): wordSampler_Draw(sampler, rng, by, value);
+        if (!text) {
+            if (total > 0.0) {
+                eprintf("Draw %d by %d = %d gave no word.\n", i, by, value);
+                return false;
+            }
+            continue;
+        }
+        WORD word;
+        char lower[MAX_WORD_BYTES+1];
+        char upper[MAX_WORD_BYTES+1];
+        unsigned char stats[MAX_WORD_LENGTH];
+        int length = language_Fold(language, text, lower, upper, stats, MAX_WORD_LENGTH);
+        if (length < MIN_WORD_LENGTH || !word_CreateIn(&word, language, text, MIN_LEVEL)) {
+            eprintf("Drew \"%s\", which isn't a valid word.\n", text);
+            return false;
+        }
+        bool matches = by == SAMPLE_ANY
+            || (by == SAMPLE_LENGTH && length == value)
+            || (by == SAMPLE_RANK && (int)word.rank == value);
+        for (int j = 0; by == SAMPLE_TECHNIQUE && j < word.nTechs; j++) {
+            matches |= (int)word.techs[j] == value;
+        }
+        if (!matches || (weighted && Weigh(NULL, &word) <= 0.0)) {
+            eprintf("Drew \"%s\", which can't be drawn by %d = %d.\n", text, by, value);
+            return false;
+        }
+        observed[byRank? (int)word.rank: length - MIN_WORD_LENGTH]++;
+    }
+    
+    // Each count should be within a few standard deviations
+    if (total <= 0.0) {
+        return true;
+    }
+    for (int i = 0; i < nGroups; i++) {
+        double share = expected[i] / total;
+        double mean = nDraws*share;
+        double deviation = sqrt(nDraws*share*(1.0 - share));
+        if (fabs(observed[i] - mean) > MAX_DEVIATIONS*deviation + 1.0) {
+            eprintf("Group %d of draws by %d = %d came up %d times, not about %.0f.\n", i, by, value, observed[i], mean);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief test driver method.
+ **************************************************************/
+int main(void) {
+    // Get the word table and count its words
+    if (!wordTable_Load(DICTIONARY)) {
+        eprintf("Failed to load word table.\n");
+        return EXIT_FAILURE;
+    }
+    static WORD_TALLY tally;
+    word_WalkDictionary(language_GetEnglish(), TallyWord, &tally);
+    WORD_SAMPLER *sampler = wordSampler_Create(language_GetEnglish(), Weigh, NULL);
+    if (!sampler) {
+        eprintf("Failed to make the sampler.\n");
+        return EXIT_FAILURE;
+    }
+    
+    // The sampler has every word
+    int failures = 0;
+    int total = 0;
+    int rankCounts[N_RANKS] = {0};
+    for (int l = 0; l < N_WORD_LENGTHS; l++) {
+        int count = 0;
+        for (int r = 0; r < N_RANKS; r++) {
+            count += tally.counts[l][r];
+            rankCounts[r] += tally.counts[l][r];
+        }
+        total += count;
+        if (wordSampler_Count(sampler, SAMPLE_LENGTH, l + MIN_WORD_LENGTH) != count) {
+            eprintf("Sampler has the wrong number of %d letter words.\n", l + MIN_WORD_LENGTH);
+            failures++;
+        }
+    }
+    for (int r = 0; r < N_RANKS; r++) {
+        if (wordSampler_Count(sampler, SAMPLE_RANK, r) != rankCounts[r]) {
+            eprintf("Sampler has the wrong number of rank %d words.\n", r);
+            failures++;
+        }
+    }
+    if (wordSampler_Count(sampler, SAMPLE_ANY, 0) != total) {
+        eprintf("Sampler has %d words, not %d.\n", wordSampler_Count(sampler, SAMPLE_ANY, 0), total);
+        failures++;
+    }
+    
+    // Uniform draws of any word, by length
+    WORD_RNG rng;
+    wordSampler_Seed(&rng, 1);
+    double expected[MAX_GROUPS];
+    for (int l = 0; l < N_WORD_LENGTHS; l++) {
+        expected[l] = 0.0;
+        for (int r = 0; r < N_RANKS; r++) {
+            expected[l] += tally.counts[l][r];
+        }
+    }
+    failures += !CheckDraws(sampler, &rng, SAMPLE_ANY, 0, false, false, expected, N_DRAWS);
+    
+    // Weighted draws of any word, by rank
+    for (int r = 0; r < N_RANKS; r++) {
+        expected[r] = 0.0;
+        for (int l = 0; l < N_WORD_LENGTHS; l++) {
+            expected[r] += tally.weights[l][r];
+        }
+    }
+    failures += !CheckDraws(sampler, &rng, SAMPLE_ANY, 0, true, true, expected, N_DRAWS);
+    
+    // Weighted draws of each rank, by length
+    for (int r = 0; r < N_RANKS; r++) {
+        for (int l = 0; l < N_WORD_LENGTHS; l++) {
+            expected[l] = tally.weights[l][r];
+        }
+        failures += !CheckDraws(sampler, &rng, SAMPLE_RANK, r, true, false, expected, N_DRAWS);
+    }
+    
+    // Uniform draws of each technique, by rank
+    for (int t = 0; t < N_TECHNIQUES; t++) {
+        for (int r = 0; r < N_RANKS; r++) {
+            expected[r] = tally.techCounts[t][r];
+        }
+        failures += !CheckDraws(sampler, &rng, SAMPLE_TECHNIQUE, t, false, true, expected, N_TECHNIQUE_DRAWS);
+    }
+    printf("Drew from %d words with %d failures.\n", total, failures);
+    
+    wordSampler_Free(sampler);
+    wordTable_Destroy();
+    return failures? EXIT_FAILURE: EXIT_SUCCESS;
+}
+
+/*============================================================*/
@@ -0,0 +1,196 @@
+/**********************************************************//**
+ * @file test_suggest.c
+ * @brief Testing program for "did you mean" suggestions. Each
+ * suggestion list is checked against the Levenshtein distance
+ * to every word in the table.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>    // bool
+#include <stdio.h>      // printf, snprintf
+#include <stdlib.h>     // EXIT_SUCCESS, EXIT_FAILURE
+#include <string.h>     // strlen, strcmp, strcpy
+
+// This project
+#include "debug.h"      // eprintf
+#include "word_table.h" // wordTable_SuggestIn
+#include "test.h"       // TEST_LIST
+
+//**************************************************************
+/// Dictionary used by the test.
+#define DICTIONARY "data/words/english.txt"
+
+/// Dictionary words skipped between the words misspelled.
+#define TEST_STRIDE 3001
+
+/// Most suggestions asked for.
+#define N_SUGGESTIONS 8
+
+/**********************************************************//**
+ * @brief Finds the Levenshtein distance over bytes between two
+ * strings, filling in the whole table.
+ * @param a: The first string, up to MAX_SUGGEST_BYTES long.
+ * @param b: The second string, up to MAX_SUGGEST_BYTES long.
+ * @return The number of edits between them.
+ **************************************************************/
+static int Distance(const char *a, const char *b) {
+    int nA = strlen(a);
+    int nB = strlen(b);
+    int rows[2][MAX_SUGGEST_BYTES+1];
+    for (int j = 0; j <= nB; j++) {
+        rows[0][j] = j;
+    }
+    for (int i = 1; i <= nA; i++) {
+        int *last = rows[(i-1) & 1];
+        int *row = rows[i & 1];
+        row[0] = i;
+        for (int j = 1; j <= nB; j++) {
+            int best = last[j-1] + (a[i-1] != b[j-1]);
+            if (last[j] + 1 < best) {
+                best = last[j] + 1;
+            }
+            if (row[j-1] + 1 < best) {
+                best = row[j-1] + 1;
+            }
+            row[j] = best;
+        }
+    }
+    return rows[nA & 1][nB];
+}
+
+/**********************************************************//**
+ * @brief Finds the suggestions for some text by measuring the
+ * distance to every word.
+ * @param list: Every word of the table.
+ * @param what: The lowercase text.
+ * @param maxDistance: Most edits a suggestion may be away.
+ * @param suggestions: Gets the suggestions, closest first and
+ * alphabetical among equals.
+ * @param maxSuggestions: Most suggestions to find.
+ * @return The number of suggestions found.
+ **************************************************************/
+static int Suggest(const TEST_LIST *list, const char *what, int maxDistance, WORD_SUGGESTION *suggestions, int maxSuggestions) {
+    int count = 0;
+    int length = strlen(what);
+    for (int i = 0; i < list->count; i++) {
+        // Words too far apart in length can't be close
+        int bytes = strlen(list->texts[i]);
+        if (bytes > length + maxDistance || bytes < length - maxDistance) {
+            continue;
+        }
+        int distance = Distance(what, list->texts[i]);
+        if (distance > maxDistance) {
+            continue;
+        }
+        
+        // The table is in order, so a word only passes those
+        // strictly closer
+        int at = count;
+        while (at > 0 && suggestions[at-1].distance > distance) {
+            at--;
+        }
+        if (at == maxSuggestions) {
+            continue;
+        }
+        if (count < maxSuggestions) {
+            count++;
+        }
+        for (int j = count - 1; j > at; j--) {
+            suggestions[j] = suggestions[j-1];
+        }
+        strcpy(suggestions[at].text, list->texts[i]);
+        suggestions[at].distance = distance;
+    }
+    return count;
+}
+
+/**********************************************************//**
+ * @brief Checks the suggestions for some text against the
+ * ones found by measuring every word.
+ * @param table: The table to search.
+ * @param list: Every word of the table.
+ * @param what: The lowercase text.
+ * @return Whether the suggestions match.
+ **************************************************************/
+static bool CheckText(const WORD_TABLE *table, const TEST_LIST *list, const char *what) {
+    for (int maxDistance = 0; maxDistance <= MAX_SUGGEST_DISTANCE; maxDistance++) {
+        WORD_SUGGESTION expected[N_SUGGESTIONS];
+        WORD_SUGGESTION found[N_SUGGESTIONS];
+        int nExpected = Suggest(list, what, maxDistance, expected, N_SUGGESTIONS);
+        int nFound = wordTable_SuggestIn(table, what, maxDistance, found, N_SUGGESTIONS);
+        bool same = nFound == nExpected;
+        for (int i = 0; same && i < nFound; i++) {
+            same = found[i].distance == expected[i].distance && !strcmp(found[i].text, expected[i].text);
+        }
+        if (!same) {
+            eprintf("Suggestions for \"%s\" within %d edits differ:\n", what, maxDistance);
+            for (int i = 0; i < nExpected; i++) {
+                eprintf("  expected %s (%d)\n", expected[i].text, expected[i].distance);
+            }
+            for (int i = 0; i < nFound; i++) {
+                eprintf("  found %s (%d)\n", found[i].text, found[i].distance);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief test driver method.
+ **************************************************************/
+int main(void) {
+    // Get the table and every word in it
+    WORD_TABLE *table = wordTable_Create(DICTIONARY);
+    if (!table) {
+        eprintf("Failed to load word table.\n");
+        return EXIT_FAILURE;
+    }
+    TEST_LIST list = {0};
+    wordTable_WalkIn(table, test_AddText, &list);
+    if (list.failed) {
+        eprintf("Out of memory.\n");
+        return EXIT_FAILURE;
+    }
+    
+    // Misspell words by dropping, changing, doubling and
+    // swapping letters, and try text no word is near
+    static const char *const others[] = {
+        "", "a", "qj", "zzzzzz", "xylophonq", "supercalifragilistic",
+    };
+    int failures = 0;
+    int checked = 0;
+    for (int i = 0; i < (int)(sizeof(others)/sizeof(others[0])); i++) {
+        failures += !CheckText(table, &list, others[i]);
+        checked++;
+    }
+    for (int i = 0; i < list.count; i += TEST_STRIDE) {
+        const char *word = list.texts[i];
+        int length = strlen(word);
+        if (length + 1 > MAX_SUGGEST_QUERY) {
+            continue;
+        }
+        int at = i % length;
+        char text[MAX_SUGGEST_QUERY+1];
+        failures += !CheckText(table, &list, word);
+        snprintf(text, sizeof(text), "%.*s%s", at, word, word + at + 1);
+        failures += !CheckText(table, &list, text);
+        snprintf(text, sizeof(text), "%.*s%c%s", at, word, 'a' + (word[at] - 'a' + 7) % 26, word + at + 1);
+        failures += !CheckText(table, &list, text);
+        snprintf(text, sizeof(text), "%.*s%s", at + 1, word, word + at);
+        failures += !CheckText(table, &list, text);
+        if (at + 1 < length) {
+            snprintf(text, sizeof(text), "%.*s%c%c%s", at, word, word[at+1], word[at], word + at + 2);
+            failures += !CheckText(table, &list, text);
+            checked++;
+        }
+        checked += 4;
+    }
+    printf("%d of %d suggestion lists match.\n", checked - failures, checked);
+    
+    test_FreeList(&list);
+    wordTable_Free(table);
+    return failures? EXIT_FAILURE: EXIT_SUCCESS;
+}
+
+/*============================================================*/
@@ -13,6 +13,10 @@
 #include "word.h"       // WORD
 #include "technique.h"  // TECHNIQUE_DATA
 #include "word_table.h" // WORD_TABLE
+#include "language.h"   // language_Suggest
+
+/// Most "did you mean" suggestions to print.
+#define N_SUGGESTIONS 5
 
 /**********************************************************//**
  * @brief test driver method.
@@ -76,10 +80,20 @@ int main(int argc, char **argv) {
     }
     
     // Print the word data.
-    if (word.isReal) {
+    if (word.flags & WORD_REAL) {
         printf("%s (Level %d, Rank %s*)\n", word.text, word.level, rank);
     } else {
         printf("%s (Level %d, Rank %s)\n", word.text, word.level, rank);
+        
+        // Suggest real words close to this one
+        WORD_SUGGESTION suggestions[N_SUGGESTIONS];
+        int count = language_Suggest(language_GetEnglish(), text, MAX_SUGGEST_DISTANCE, suggestions, N_SUGGESTIONS);
+        for (int i = 0; i < count; i++) {
+            printf("%s%s", i == 0? "Did you mean: ": ", ", suggestions[i].text);
+        }
+        if (count > 0) {
+            printf("?\n");
+        }
     }
     
     // Print the stats
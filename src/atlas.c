@@ -0,0 +1,292 @@
+/**********************************************************//**
+ * @file atlas.c
+ * @brief Implementation of the shared texture atlas.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>        // bool
+#include <stddef.h>         // NULL
+
+// Allegro
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_primitives.h>
+
+// This project
+#include "debug.h"          // assert, eprintf
+#include "atlas.h"          // ATLAS_SIZE
+#include "render.h"         // render_DrawScaledBitmap
+
+//**************************************************************
+/// Empty pixels left between regions to prevent bleeding.
+#define ATLAS_PADDING 1
+
+/// The maximum number of regions in the atlas.
+#define MAX_REGIONS 512
+
+/**********************************************************//**
+ * @struct ATLAS
+ * @brief Stores the atlas texture and the shelf packing state.
+ **************************************************************/
+typedef struct {
+    ALLEGRO_BITMAP *bitmap;     ///< The atlas texture.
+    ALLEGRO_BITMAP *white;      ///< Opaque white region for shapes.
+    ALLEGRO_BITMAP *regions[MAX_REGIONS];   ///< Owned bitmaps.
+    int nRegions;               ///< Number of owned bitmaps.
+    int x;                      ///< Next free x on the current shelf.
+    int y;                      ///< Top of the current shelf.
+    int shelf;                  ///< Height of the current shelf.
+    int batch;                  ///< Depth of nested batches.
+} ATLAS;
+
+/// The atlas shared by every module.
+static ATLAS GlobalAtlas;
+
+/**********************************************************//**
+ * @brief Keeps track of a bitmap so it is freed with the atlas.
+ * @param bitmap: The bitmap to own.
+ * @return The bitmap, or NULL if it couldn't be tracked.
+ **************************************************************/
+static ALLEGRO_BITMAP *Own(ALLEGRO_BITMAP *bitmap) {
+    if (!bitmap) {
+        return NULL;
+    }
+    if (GlobalAtlas.nRegions >= MAX_REGIONS) {
+        eprintf("Too many atlas regions.\n");
+        al_destroy_bitmap(bitmap);
+        return NULL;
+    }
+    GlobalAtlas.regions[GlobalAtlas.nRegions++] = bitmap;
+    return bitmap;
+}
+
+/**********************************************************//**
+ * @brief Sets up rendering into a region of the atlas. Colors
+ * and alpha are written as-is into transparent regions.
+ * @param state: Output parameter for the state to restore.
+ * @param region: The region to draw into.
+ **************************************************************/
+static void BeginRegion(ALLEGRO_STATE *state, ALLEGRO_BITMAP *region) {
+    al_store_state(state, ALLEGRO_STATE_TARGET_BITMAP | ALLEGRO_STATE_BLENDER);
+    al_set_target_bitmap(region);
+    al_set_separate_blender(ALLEGRO_ADD, ALLEGRO_ALPHA, ALLEGRO_INVERSE_ALPHA, ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_INVERSE_ALPHA);
+}
+
+/*============================================================*
+ * Creating the atlas
+ *============================================================*/
+bool atlas_Initialize(void) {
+    if (GlobalAtlas.bitmap) {
+        return true;
+    }
+    
+    // Create the texture
+    GlobalAtlas.bitmap = al_create_bitmap(ATLAS_SIZE, ATLAS_SIZE);
+    if (!GlobalAtlas.bitmap) {
+        eprintf("Failed to create the texture atlas.\n");
+        return false;
+    }
+    GlobalAtlas.nRegions = 0;
+    GlobalAtlas.x = 0;
+    GlobalAtlas.y = 0;
+    GlobalAtlas.shelf = 0;
+    GlobalAtlas.batch = 0;
+    
+    // Clear to transparent
+    ALLEGRO_STATE state;
+    BeginRegion(&state, GlobalAtlas.bitmap);
+    al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+    al_restore_state(&state);
+    
+    // Reserve a white block and draw shapes from its center texel
+    // so that sampling never touches a neighbor.
+    ALLEGRO_BITMAP *block = atlas_Allocate(3, 3);
+    if (!block) {
+        atlas_Destroy();
+        return false;
+    }
+    BeginRegion(&state, block);
+    al_clear_to_color(al_map_rgb(255, 255, 255));
+    al_restore_state(&state);
+    GlobalAtlas.white = Own(al_create_sub_bitmap(block, 1, 1, 1, 1));
+    return true;
+}
+
+/*============================================================*
+ * Destroying the atlas
+ *============================================================*/
+void atlas_Destroy(void) {
+    // Sub-bitmaps must go before their parent
+    for (int i = GlobalAtlas.nRegions-1; i >= 0; i--) {
+        al_destroy_bitmap(GlobalAtlas.regions[i]);
+    }
+    if (GlobalAtlas.bitmap) {
+        al_destroy_bitmap(GlobalAtlas.bitmap);
+    }
+    GlobalAtlas.bitmap = NULL;
+    GlobalAtlas.white = NULL;
+    GlobalAtlas.nRegions = 0;
+}
+
+ALLEGRO_BITMAP *atlas_GetBitmap(void) {
+    return GlobalAtlas.bitmap;
+}
+
+/*============================================================*
+ * Packing regions
+ *============================================================*/
+ALLEGRO_BITMAP *atlas_Allocate(int width, int height) {
+    if (!GlobalAtlas.bitmap || width <= 0 || height <= 0) {
+        return NULL;
+    }
+    
+    // Start a new shelf if this row is full
+    int paddedWidth = width + ATLAS_PADDING;
+    int paddedHeight = height + ATLAS_PADDING;
+    if (GlobalAtlas.x + paddedWidth > ATLAS_SIZE) {
+        GlobalAtlas.x = 0;
+        GlobalAtlas.y += GlobalAtlas.shelf;
+        GlobalAtlas.shelf = 0;
+    }
+    if (paddedWidth > ATLAS_SIZE || GlobalAtlas.y + paddedHeight > ATLAS_SIZE) {
+        eprintf("The texture atlas is full.\n");
+        return NULL;
+    }
+    
+    // Place the region on the shelf
+    ALLEGRO_BITMAP *region = al_create_sub_bitmap(GlobalAtlas.bitmap, GlobalAtlas.x, GlobalAtlas.y, width, height);
+    if (!(region = Own(region))) {
+        return NULL;
+    }
+    GlobalAtlas.x += paddedWidth;
+    if (paddedHeight > GlobalAtlas.shelf) {
+        GlobalAtlas.shelf = paddedHeight;
+    }
+    return region;
+}
+
+/**********************************************************//**
+ * @brief Finds a region among those the atlas owns.
+ * @param region: The region to find.
+ * @return Its index, or -1 if the atlas doesn't own it.
+ **************************************************************/
+static int Find(const ALLEGRO_BITMAP *region) {
+    for (int i = 0; region && i < GlobalAtlas.nRegions; i++) {
+        if (GlobalAtlas.regions[i] == region) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void atlas_Free(ALLEGRO_BITMAP *region) {
+    int i = Find(region);
+    if (i < 0 || region == GlobalAtlas.white) {
+        return;
+    }
+    
+    // Later regions may be sub-bitmaps of earlier ones, so the
+    // order is kept
+    al_destroy_bitmap(region);
+    GlobalAtlas.nRegions--;
+    for (; i < GlobalAtlas.nRegions; i++) {
+        GlobalAtlas.regions[i] = GlobalAtlas.regions[i+1];
+    }
+}
+
+bool atlas_Owns(const ALLEGRO_BITMAP *region) {
+    return Find(region) >= 0;
+}
+
+/*============================================================*
+ * Loading images
+ *============================================================*/
+ALLEGRO_BITMAP *atlas_LoadBitmap(const char *filename) {
+    ALLEGRO_BITMAP *image = al_load_bitmap(filename);
+    if (!image) {
+        eprintf("Failed to load %s\n", filename);
+        return NULL;
+    }
+    ALLEGRO_BITMAP *bitmap = atlas_AddBitmap(image);
+    al_destroy_bitmap(image);
+    return bitmap;
+}
+
+ALLEGRO_BITMAP *atlas_AddBitmap(ALLEGRO_BITMAP *image) {
+    // Keep a copy separate if there is no room
+    ALLEGRO_BITMAP *region = atlas_Allocate(al_get_bitmap_width(image), al_get_bitmap_height(image));
+    if (!region) {
+        return Own(al_clone_bitmap(image));
+    }
+    
+    // Copy the pixels exactly
+    ALLEGRO_STATE state;
+    al_store_state(&state, ALLEGRO_STATE_TARGET_BITMAP | ALLEGRO_STATE_BLENDER);
+    al_set_target_bitmap(region);
+    al_set_blender(ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_ZERO);
+    al_draw_bitmap(image, 0, 0, 0);
+    al_restore_state(&state);
+    return region;
+}
+
+/*============================================================*
+ * Rendering glyphs
+ *============================================================*/
+ALLEGRO_BITMAP *atlas_AddGlyph(const ALLEGRO_FONT *font, char letter, int left, int top, int width, int height) {
+    ALLEGRO_BITMAP *region = atlas_Allocate(width, height);
+    if (region) {
+        atlas_DrawGlyph(region, font, letter, left, top);
+    }
+    return region;
+}
+
+void atlas_DrawGlyph(ALLEGRO_BITMAP *region, const ALLEGRO_FONT *font, char letter, int left, int top) {
+    // Draw in white so the glyph can be tinted, with the pen
+    // moved so the bounding box starts at the region's corner
+    char string[2] = {letter, '\0'};
+    ALLEGRO_STATE state;
+    BeginRegion(&state, region);
+    al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+    al_draw_text(font, al_map_rgb(255, 255, 255), -left, -top, ALLEGRO_ALIGN_LEFT, string);
+    al_restore_state(&state);
+}
+
+/*============================================================*
+ * Drawing shapes
+ *============================================================*/
+void atlas_DrawRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color) {
+    if (!GlobalAtlas.white) {
+        render_DrawRectangle(x1, y1, x2, y2, color);
+        return;
+    }
+    render_DrawScaledBitmap(GlobalAtlas.white, color, 0, 0, 1, 1, x1, y1, x2-x1, y2-y1);
+}
+
+/*============================================================*
+ * Batching
+ *============================================================*/
+void atlas_BeginBatch(void) {
+    if (GlobalAtlas.batch++ == 0) {
+        render_HoldDrawing(true);
+    }
+}
+
+void atlas_EndBatch(void) {
+    if (GlobalAtlas.batch > 0 && --GlobalAtlas.batch == 0) {
+        render_HoldDrawing(false);
+    }
+}
+
+void atlas_PauseBatch(void) {
+    if (GlobalAtlas.batch > 0) {
+        render_HoldDrawing(false);
+    }
+}
+
+void atlas_ResumeBatch(void) {
+    if (GlobalAtlas.batch > 0) {
+        render_HoldDrawing(true);
+    }
+}
+
+/*============================================================*/
@@ -0,0 +1,149 @@
+/**********************************************************//**
+ * @file atlas.h
+ * @brief Header file for the shared texture atlas that all
+ * user interface images and glyphs are packed into.
+ **************************************************************/
+
+#ifndef _ATLAS_H_
+#define _ATLAS_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+
+// Allegro
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+
+//**************************************************************
+/// Width and height of the atlas texture.
+#define ATLAS_SIZE 1024
+
+/**********************************************************//**
+ * @brief Creates the atlas. Regions created before the
+ * display exists are converted along with the atlas when the
+ * display is created.
+ * @return Whether the atlas was created.
+ **************************************************************/
+extern bool atlas_Initialize(void);
+
+/**********************************************************//**
+ * @brief Destroys the atlas and every region in it.
+ **************************************************************/
+extern void atlas_Destroy(void);
+
+/**********************************************************//**
+ * @brief Gets the texture all regions are drawn from.
+ * @return The atlas bitmap, or NULL if it doesn't exist.
+ **************************************************************/
+extern ALLEGRO_BITMAP *atlas_GetBitmap(void);
+
+/**********************************************************//**
+ * @brief Reserves an empty region of the atlas.
+ * @param width: Width of the region.
+ * @param height: Height of the region.
+ * @return A sub-bitmap of the atlas owned by the atlas, or
+ * NULL if the atlas is full.
+ **************************************************************/
+extern ALLEGRO_BITMAP *atlas_Allocate(int width, int height);
+
+/**********************************************************//**
+ * @brief Frees a region, so that its slot can be used again.
+ * The space it took in the texture stays in use, so regions
+ * that will be replaced should be drawn over instead.
+ * @param region: A region made by the atlas. Regions that are
+ * not in the atlas, such as after atlas_Destroy, are ignored.
+ **************************************************************/
+extern void atlas_Free(ALLEGRO_BITMAP *region);
+
+/**********************************************************//**
+ * @brief Checks if a region is still owned by the atlas.
+ * @param region: The region to check.
+ * @return Whether it can be drawn into.
+ **************************************************************/
+extern bool atlas_Owns(const ALLEGRO_BITMAP *region);
+
+/**********************************************************//**
+ * @brief Loads an image file into the atlas.
+ * @param filename: The image to load.
+ * @return A bitmap owned by the atlas. This is a region of the
+ * atlas unless the atlas is full, in which case the image is
+ * kept as its own bitmap.
+ **************************************************************/
+extern ALLEGRO_BITMAP *atlas_LoadBitmap(const char *filename);
+
+/**********************************************************//**
+ * @brief Copies an image that is already in memory into the
+ * atlas. This must be called from the thread that owns the
+ * display.
+ * @param image: The image to copy. It is not taken over.
+ * @return A bitmap owned by the atlas. This is a region of the
+ * atlas unless the atlas is full, in which case a copy of the
+ * image is kept as its own bitmap.
+ **************************************************************/
+extern ALLEGRO_BITMAP *atlas_AddBitmap(ALLEGRO_BITMAP *image);
+
+/**********************************************************//**
+ * @brief Renders one character of the font into the atlas in
+ * white, so that it can be drawn tinted in any color. The cell
+ * is the glyph's bounding box from al_get_glyph_dimensions, so
+ * ink left of the pen or past the advance is kept.
+ * @param font: The font to render.
+ * @param letter: The ASCII character to render.
+ * @param left: Left edge of the box, from the pen position.
+ * @param top: Top edge of the box, from the top of the line.
+ * @param width: Width of the box.
+ * @param height: Height of the box.
+ * @return A region of the atlas, or NULL if the glyph is empty
+ * or the atlas is full.
+ **************************************************************/
+extern ALLEGRO_BITMAP *atlas_AddGlyph(const ALLEGRO_FONT *font, char letter, int left, int top, int width, int height);
+
+/**********************************************************//**
+ * @brief Renders one character over a region that already
+ * holds a glyph, clearing it first. The box is placed at the
+ * region's top left.
+ * @param region: A region of the atlas at least as large as
+ * the box.
+ * @param font: The font to render.
+ * @param letter: The ASCII character to render.
+ * @param left: Left edge of the box, from the pen position.
+ * @param top: Top edge of the box, from the top of the line.
+ **************************************************************/
+extern void atlas_DrawGlyph(ALLEGRO_BITMAP *region, const ALLEGRO_FONT *font, char letter, int left, int top);
+
+/**********************************************************//**
+ * @brief Draws a filled rectangle from the atlas' white texel
+ * so that it batches with the rest of the atlas.
+ * @param x1: Left edge.
+ * @param y1: Top edge.
+ * @param x2: Right edge.
+ * @param y2: Bottom edge.
+ * @param color: Fill color.
+ **************************************************************/
+extern void atlas_DrawRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color);
+
+/**********************************************************//**
+ * @brief Starts deferring bitmap drawing so that consecutive
+ * draws from the atlas go out as one draw call. Batches nest.
+ **************************************************************/
+extern void atlas_BeginBatch(void);
+
+/**********************************************************//**
+ * @brief Ends the batch started by atlas_BeginBatch, flushing
+ * all deferred drawing when the outermost batch ends.
+ **************************************************************/
+extern void atlas_EndBatch(void);
+
+/**********************************************************//**
+ * @brief Flushes and suspends the current batch, if any, so
+ * that the target, blender or primitives can be used.
+ **************************************************************/
+extern void atlas_PauseBatch(void);
+
+/**********************************************************//**
+ * @brief Resumes the batch suspended by atlas_PauseBatch.
+ **************************************************************/
+extern void atlas_ResumeBatch(void);
+
+/*============================================================*/
+#endif // _ATLAS_H_
@@ -5,10 +5,10 @@
 
 // Allegro
 #include <allegro5/allegro.h>
-#include <allegro5/allegro_primitives.h>
 
 // This project
 #include "bar.h"        // BAR
+#include "atlas.h"      // atlas_DrawRectangle
 
 /*============================================================*
  * Word loading
@@ -25,12 +25,12 @@ void bar_Draw(const BAR *bar) {
     
     // The background of the entire bar
     if (!(bar->flags & BAR_NO_BACKGROUND)) {
-        al_draw_filled_rectangle(xo, yo, xf, yf, bar->background);
+        atlas_DrawRectangle(xo, yo, xf, yf, bar->background);
     }
     
     // Filled section
     if (xr > xo) {
-        al_draw_filled_rectangle(xo, yo, xr, yf, bar->foreground);
+        atlas_DrawRectangle(xo, yo, xr, yf, bar->foreground);
     }
 }
 
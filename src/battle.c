@@ -130,13 +130,10 @@ static int team_ChangeBoost(TEAM *team, STAT stat, int delta) {
     return next == old;
 }
 
-/**********************************************************//**
- * @brief Get the boosted value of the active word's stats.
- * @param team: The team to check.
- * @param stat: The stat to get.
- * @return The value of the stat.
- **************************************************************/
-static int team_GetBoostedStat(const TEAM *team, STAT stat) {
+/*============================================================*
+ * Boosted stats
+ *============================================================*/
+int team_GetBoostedStat(const TEAM *team, STAT stat) {
     // Apply boost
     int unboosted = team->words[ACTIVE_WORD]->stat[stat];
     int boost = team->statBoosts[stat];
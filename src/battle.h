@@ -120,6 +120,14 @@ extern bool player_GetTeam(PLAYER *player, TEAM *team);
  **************************************************************/
 extern bool team_Create(TEAM *team, WORD **words, int size);
 
+/**********************************************************//**
+ * @brief Get the boosted value of the active word's stats.
+ * @param team: The team to check.
+ * @param stat: The stat to get.
+ * @return The value of the stat.
+ **************************************************************/
+extern int team_GetBoostedStat(const TEAM *team, STAT stat);
+
 /**********************************************************//**
  * @brief Start a battle between the two teams.
  * @param battle: The battle to conduct.
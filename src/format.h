@@ -0,0 +1,101 @@
+/**********************************************************//**
+ * @file format.h
+ * @brief Small integer-to-text formatters for text that is
+ * drawn often, so that it can skip the generality of sprintf.
+ **************************************************************/
+
+#ifndef _FORMAT_H_
+#define _FORMAT_H_
+
+//**************************************************************
+/// Buffer size that fits any int, with sign and terminator.
+#define FORMAT_INT_SIZE 12
+
+/// Buffer size that fits any fraction of two ints.
+#define FORMAT_RATIO_SIZE (2*FORMAT_INT_SIZE)
+
+/**********************************************************//**
+ * @brief Writes an integer in decimal.
+ * @param string: Output buffer of at least FORMAT_INT_SIZE
+ * characters.
+ * @param value: The integer to write.
+ * @return The length of the written text.
+ **************************************************************/
+static inline int format_Int(char *string, int value) {
+    // Digits come out backwards, so build them at the end
+    char digits[FORMAT_INT_SIZE];
+    char *end = digits + sizeof(digits);
+    char *start = end;
+    unsigned magnitude = value < 0? 0u - (unsigned)value: (unsigned)value;
+    do {
+        *--start = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) {
+        *--start = '-';
+    }
+    
+    // Copy them to the front of the output
+    int length = end - start;
+    for (int i = 0; i < length; i++) {
+        string[i] = start[i];
+    }
+    string[length] = '\0';
+    return length;
+}
+
+/**********************************************************//**
+ * @brief Writes a fraction such as "12/34".
+ * @param string: Output buffer of at least FORMAT_RATIO_SIZE
+ * characters.
+ * @param numerator: The number before the slash.
+ * @param denominator: The number after the slash.
+ * @return The length of the written text.
+ **************************************************************/
+static inline int format_Ratio(char *string, int numerator, int denominator) {
+    int length = format_Int(string, numerator);
+    string[length++] = '/';
+    return length + format_Int(string + length, denominator);
+}
+
+/**********************************************************//**
+ * @brief Writes a fixed-point number such as "59.9".
+ * @param string: Output buffer of at least FORMAT_INT_SIZE+1
+ * characters.
+ * @param value: The number scaled by 10 to the places.
+ * @param places: Number of digits after the point, 0 to 9.
+ * @return The length of the written text.
+ **************************************************************/
+static inline int format_Fixed(char *string, int value, int places) {
+    if (places <= 0) {
+        return format_Int(string, value);
+    }
+    
+    // Pad with zeros so there is a digit before the point
+    char digits[FORMAT_INT_SIZE + 10];
+    int sign = value < 0;
+    int length = format_Int(digits + places + 1, value) + places + 1;
+    char *first = digits + places + 1 + sign;
+    int count = length - places - 1 - sign;
+    while (count < places + 1) {
+        *--first = '0';
+        count++;
+    }
+    
+    // Copy the digits with the point in place
+    int out = 0;
+    if (sign) {
+        string[out++] = '-';
+    }
+    for (int i = 0; i < count; i++) {
+        if (i == count - places) {
+            string[out++] = '.';
+        }
+        string[out++] = first[i];
+    }
+    string[out] = '\0';
+    return out;
+}
+
+/*============================================================*/
+#endif // _FORMAT_H_
@@ -7,63 +7,106 @@
 // Standard library
 #include <stdbool.h>    // bool
 #include <stdlib.h>     // malloc, free
+#include <math.h>       // fabsf, floorf, ceilf
 
 // Allegro
 #include <allegro5/allegro.h>
 #include <allegro5/allegro_font.h>
-#include <allegro5/allegro_primitives.h>
 
 // This project
 #include "debug.h"      // eprintf, assert
 #include "frame.h"      // FRAME
+#include "glyph_table.h" // GLYPH_TABLE
+#include "atlas.h"      // atlas_DrawRectangle
 
 //**************************************************************
-/// Rendering flags of the text.
-#define TEXT_FLAGS (ALLEGRO_ALIGN_LEFT | ALLEGRO_ALIGN_INTEGER)
+/// Spring constant pulling a list's view to its cursor.
+#define VLIST_STIFFNESS 400.0
+
+/// Damping of the list spring. Twice the square root of the
+/// stiffness settles as fast as possible without overshooting.
+#define VLIST_DAMPING 40.0
+
+/// Distance in pixels below which the list snaps into place.
+#define VLIST_SETTLE_DISTANCE 0.5
+
+/// Speed in pixels per second below which the list snaps.
+#define VLIST_SETTLE_SPEED 10.0
 
 //**************************************************************
 /// Shared theme data for all frames.
 static THEME GlobalTheme;
 
+/// Measurements of the theme font.
+static GLYPH_TABLE GlobalGlyphs;
+
+/// Generation of the current theme (0 is never valid).
+static int GlobalThemeVersion = 0;
+
+/// Position of the drawn screen between simulation steps.
+static float GlobalInterpolation = 1.0;
+
 /*============================================================*
  * Global theme manipulation
  *============================================================*/
 void frame_SetTheme(const THEME *newTheme) {
     GlobalTheme = *newTheme;
+    glyphTable_Create(&GlobalGlyphs, GlobalTheme.font);
+    GlobalThemeVersion++;
 }
 
 const THEME *frame_GetTheme(void) {
     return &GlobalTheme;
 }
 
+int frame_GetThemeVersion(void) {
+    return GlobalThemeVersion;
+}
+
+/*============================================================*
+ * Interpolation between simulation steps
+ *============================================================*/
+void frame_SetInterpolation(float alpha) {
+    if (alpha < 0.0) {
+        alpha = 0.0;
+    } else if (alpha > 1.0) {
+        alpha = 1.0;
+    }
+    GlobalInterpolation = alpha;
+}
+
+float frame_GetInterpolation(void) {
+    return GlobalInterpolation;
+}
+
 /*============================================================*
  * Spacing data
  *============================================================*/
 int frame_GetLineHeight(int lines) {
-    int fontHeight = al_get_font_line_height(GlobalTheme.font);
+    int fontHeight = GlobalGlyphs.height;
     return (fontHeight + GlobalTheme.spacing)*lines - GlobalTheme.spacing;
 }
 
 int frame_GetLineSpacing(void) {
-    return al_get_font_line_height(GlobalTheme.font) + GlobalTheme.spacing;
+    return GlobalGlyphs.height + GlobalTheme.spacing;
 }
 
 /*============================================================*
  * Drawing text on the screen
  *============================================================*/
 void frame_DrawText(int x, int y, const char *text) {
-    al_draw_text(GlobalTheme.font, GlobalTheme.foreground, x, y, TEXT_FLAGS, text);
+    glyphTable_DrawText(&GlobalGlyphs, GlobalTheme.foreground, x, y, text);
 }
 
 void frame_DrawOutlinedText(int x, int y, const char *text) {
     // Construct the outline
-    al_draw_text(GlobalTheme.font, GlobalTheme.foreground, x-1, y, TEXT_FLAGS, text);
-    al_draw_text(GlobalTheme.font, GlobalTheme.foreground, x+1, y, TEXT_FLAGS, text);
-    al_draw_text(GlobalTheme.font, GlobalTheme.foreground, x, y-1, TEXT_FLAGS, text);
-    al_draw_text(GlobalTheme.font, GlobalTheme.foreground, x, y+1, TEXT_FLAGS, text);
+    glyphTable_DrawText(&GlobalGlyphs, GlobalTheme.foreground, x-1, y, text);
+    glyphTable_DrawText(&GlobalGlyphs, GlobalTheme.foreground, x+1, y, text);
+    glyphTable_DrawText(&GlobalGlyphs, GlobalTheme.foreground, x, y-1, text);
+    glyphTable_DrawText(&GlobalGlyphs, GlobalTheme.foreground, x, y+1, text);
     
     // Draw the actual text
-    al_draw_text(GlobalTheme.font, GlobalTheme.background, x, y, TEXT_FLAGS, text);
+    glyphTable_DrawText(&GlobalGlyphs, GlobalTheme.background, x, y, text);
 }
 
 /*============================================================*
@@ -118,6 +161,24 @@ void frame_GetEnd(const FRAME *frame, int *xf, int *yf) {
     }
 }
 
+/**********************************************************//**
+ * @brief Draws a rectangle outline centered on the edges of
+ * the rectangle, using atlas rectangles so it batches.
+ * @param x1: Left edge.
+ * @param y1: Top edge.
+ * @param x2: Right edge.
+ * @param y2: Bottom edge.
+ * @param color: Outline color.
+ * @param thickness: Width of the outline.
+ **************************************************************/
+static void DrawOutline(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, float thickness) {
+    float h = thickness / 2.0;
+    atlas_DrawRectangle(x1-h, y1-h, x2+h, y1+h, color);
+    atlas_DrawRectangle(x1-h, y2-h, x2+h, y2+h, color);
+    atlas_DrawRectangle(x1-h, y1+h, x1+h, y2-h, color);
+    atlas_DrawRectangle(x2-h, y1+h, x2+h, y2-h, color);
+}
+
 /*============================================================*
  * Drawing frames
  *============================================================*/
@@ -129,11 +190,11 @@ void frame_Draw(const FRAME *frame) {
     int yf = yo + frame->height;
     
     // Draw the frame background
-    al_draw_filled_rectangle(xo, yo, xf, yf, GlobalTheme.background);
+    atlas_DrawRectangle(xo, yo, xf, yf, GlobalTheme.background);
     
     // Draw the frame outline
     if (frame->flags & FRAME_OUTLINE) {
-        al_draw_rectangle(xo, yo, xf, yf, GlobalTheme.foreground, GlobalTheme.outline);
+        DrawOutline(xo, yo, xf, yf, GlobalTheme.foreground, GlobalTheme.outline);
     }
     
     // Draw the frame header
@@ -150,21 +211,37 @@ void frame_Draw(const FRAME *frame) {
             hyo = yo;
             hyf = hyo + GlobalTheme.header;
         }
-        al_draw_filled_rectangle(hxo, hyo, hxf, hyf, GlobalTheme.highlight);
+        atlas_DrawRectangle(hxo, hyo, hxf, hyf, GlobalTheme.highlight);
     }
 }
 
+/**********************************************************//**
+ * @brief Gets the width of the entry's text, measuring it only
+ * if the text pointer or theme changed since it was last
+ * measured.
+ * @param entry: The entry to measure.
+ * @return The width of the entry's text.
+ **************************************************************/
+static int EntryWidth(TEXT_ENTRY *entry) {
+    if (entry->measured != entry->text || entry->theme != GlobalThemeVersion) {
+        entry->width = glyphTable_TextWidth(&GlobalGlyphs, entry->text);
+        entry->measured = entry->text;
+        entry->theme = GlobalThemeVersion;
+    }
+    return entry->width;
+}
+
 /*============================================================*
  * Text frame sizing
  *============================================================*/
-int textFrame_Width(const TEXT_FRAME *frame) {
+int textFrame_Width(TEXT_FRAME *frame) {
     // Dynamic width sizing
     if (frame->flags & FRAME_DYNAMIC_WIDTH) {
         // Get the maximum width of all the strings, including
         // the maximum frame width (set to 0 to exclude).
         int maxFontWidth = frame->maxWidth;
         for (int line = 0; line < frame->lines; line++) {
-            int temp = al_get_text_width(GlobalTheme.font, frame->data[line].text);
+            int temp = EntryWidth(&frame->data[line]);
             if (temp > maxFontWidth) {
                 maxFontWidth = temp;
             }
@@ -177,14 +254,14 @@ int textFrame_Width(const TEXT_FRAME *frame) {
 }
 
 int textFrame_Height(const TEXT_FRAME *frame) {
-    int fontHeight = al_get_font_line_height(GlobalTheme.font);
+    int fontHeight = GlobalGlyphs.height;
     return (fontHeight + GlobalTheme.spacing)*frame->lines - GlobalTheme.spacing;
 }
 
 /*============================================================*
  * Drawing text frames
  *============================================================*/
-void textFrame_Draw(const TEXT_FRAME *frame) {
+void textFrame_Draw(TEXT_FRAME *frame) {
     // Get the frame's area
     FRAME base;
     base.x = frame->x;
@@ -195,7 +272,7 @@ void textFrame_Draw(const TEXT_FRAME *frame) {
     int width = textFrame_Width(frame);
     
     // Get the base frame height
-    int fontHeight = al_get_font_line_height(GlobalTheme.font);
+    int fontHeight = GlobalGlyphs.height;
     int height = textFrame_Height(frame);
     
     // Draw the base frame
@@ -230,10 +307,10 @@ void textFrame_Draw(const TEXT_FRAME *frame) {
         // Draw the entry and selection bar
         // To center the text in the selection perfectly we need to add 1 to xo
         if (textFlags & ENTRY_SELECTED) {
-            al_draw_filled_rectangle(xo, y, xf, y+fontHeight, color);
-            al_draw_text(GlobalTheme.font, GlobalTheme.background, xo+1, y+1, TEXT_FLAGS, frame->data[line].text);
+            atlas_DrawRectangle(xo, y, xf, y+fontHeight, color);
+            glyphTable_DrawText(&GlobalGlyphs, GlobalTheme.background, xo+1, y+1, frame->data[line].text);
         } else {
-            al_draw_text(GlobalTheme.font, color, xo+1, y+1, TEXT_FLAGS, frame->data[line].text);
+            glyphTable_DrawText(&GlobalGlyphs, color, xo+1, y+1, frame->data[line].text);
         }
         y += dy;
     }
@@ -272,7 +349,7 @@ static inline void MenuToTextFrame(TEXT_FRAME *frame, const MENU *menu) {
 /*============================================================*
  * Menu sizing
  *============================================================*/
-int menu_Width(const MENU *menu) {
+int menu_Width(MENU *menu) {
     TEXT_FRAME base;
     MenuToTextFrame(&base, menu);
     return textFrame_Width(&base);
@@ -287,7 +364,7 @@ int menu_Height(const MENU *menu) {
 /*============================================================*
  * Drawing menus
  *============================================================*/
-void menu_Draw(const MENU *menu) {
+void menu_Draw(MENU *menu) {
     TEXT_FRAME base;
     MenuToTextFrame(&base, menu);
     textFrame_Draw(&base);
@@ -361,4 +438,112 @@ MENU_STATUS menu_Run(MENU *menu, MENU_ACTION action) {
     }
 }
 
+/*============================================================*
+ * Virtual list setup
+ *============================================================*/
+void vlist_Create(VLIST *list, int x, int y, int height, int rowHeight) {
+    list->x = x;
+    list->y = y;
+    list->height = height;
+    list->rowHeight = rowHeight;
+    list->count = 0;
+    list->cursor = 0;
+    list->scroll = 0.0;
+    list->prevScroll = 0.0;
+    list->velocity = 0.0;
+    list->scrollMax = 0.0;
+}
+
+void vlist_SetCount(VLIST *list, int count) {
+    if (count == list->count) {
+        return;
+    }
+    list->count = count;
+    
+    // Stop scrolling where the last row reaches the bottom
+    list->scrollMax = (float)count*list->rowHeight - list->height;
+    if (list->scrollMax < 0.0) {
+        list->scrollMax = 0.0;
+    }
+    if (list->cursor >= count) {
+        list->cursor = count > 0? count-1: 0;
+    }
+}
+
+/*============================================================*
+ * Virtual list input
+ *============================================================*/
+bool vlist_MoveCursor(VLIST *list, int delta) {
+    int cursor = list->cursor + delta;
+    if (cursor >= list->count) {
+        cursor = list->count-1;
+    }
+    if (cursor < 0) {
+        cursor = 0;
+    }
+    if (cursor == list->cursor) {
+        return false;
+    }
+    list->cursor = cursor;
+    return true;
+}
+
+/*============================================================*
+ * Virtual list scrolling
+ *============================================================*/
+bool vlist_Update(VLIST *list, float dt) {
+    // The last frame still drew a blend if the last step moved
+    bool moving = list->prevScroll != list->scroll;
+    list->prevScroll = list->scroll;
+    
+    // Bring the cursor's row to the top of the view
+    float target = (float)list->cursor*list->rowHeight;
+    if (target > list->scrollMax) {
+        target = list->scrollMax;
+    }
+    float offset = target - list->scroll;
+    if (fabsf(offset) < VLIST_SETTLE_DISTANCE && fabsf(list->velocity) < VLIST_SETTLE_SPEED) {
+        list->scroll = target;
+        list->velocity = 0.0;
+        return moving || list->scroll != list->prevScroll;
+    }
+    
+    // Damped spring, integrated semi-implicitly for stability
+    list->velocity += (VLIST_STIFFNESS*offset - VLIST_DAMPING*list->velocity)*dt;
+    list->scroll += list->velocity*dt;
+    if (list->scroll < 0.0) {
+        list->scroll = 0.0;
+        list->velocity = 0.0;
+    } else if (list->scroll > list->scrollMax) {
+        list->scroll = list->scrollMax;
+        list->velocity = 0.0;
+    }
+    return true;
+}
+
+/*============================================================*
+ * Virtual list drawing
+ *============================================================*/
+void vlist_GetVisible(const VLIST *list, float scroll, int *first, int *end) {
+    *first = (int)floorf((scroll - list->y) / list->rowHeight);
+    if (*first < 0) {
+        *first = 0;
+    }
+    *end = (int)ceilf((scroll + list->height) / list->rowHeight);
+    if (*end > list->count) {
+        *end = list->count;
+    }
+}
+
+void vlist_Draw(const VLIST *list, VLIST_DRAW draw, const void *data) {
+    float scroll = frame_Interpolate(list->prevScroll, list->scroll, frame_GetInterpolation());
+    int first, end;
+    vlist_GetVisible(list, scroll, &first, &end);
+    float y = list->y + (float)first*list->rowHeight - scroll;
+    for (int i = first; i < end; i++) {
+        draw(data, i, list->x, y, i == list->cursor);
+        y += list->rowHeight;
+    }
+}
+
 /*============================================================*/
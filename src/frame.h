@@ -7,6 +7,9 @@
 #ifndef _FRAME_H_
 #define _FRAME_H_
 
+// Standard library
+#include <stdbool.h>    // bool
+
 // Allegro
 #include <allegro5/allegro.h>
 #include <allegro5/allegro_font.h>
@@ -34,7 +37,9 @@ typedef struct {
 
 /**********************************************************//**
  * @brief Sets the global frame theme. Resources associated
- * to the old theme must be freed by the programmer.
+ * to the old theme must be freed by the programmer. The glyph
+ * widths of the theme font are measured here once, and all
+ * cached text entry widths become stale.
  * @param theme: The new theme to copy.
  **************************************************************/
 extern void frame_SetTheme(const THEME *theme);
@@ -45,6 +50,40 @@ extern void frame_SetTheme(const THEME *theme);
  **************************************************************/
 extern const THEME *frame_GetTheme(void);
 
+/**********************************************************//**
+ * @brief Gets the generation of the current theme, which
+ * changes every time the theme is set, so that anything drawn
+ * with an old theme can be redrawn.
+ * @return The theme generation, never 0.
+ **************************************************************/
+extern int frame_GetThemeVersion(void);
+
+/**********************************************************//**
+ * @brief Sets how far the screen being drawn is between the
+ * last two simulation steps.
+ * @param alpha: 0.0 for the previous step, up to 1.0 for the
+ * latest step.
+ **************************************************************/
+extern void frame_SetInterpolation(float alpha);
+
+/**********************************************************//**
+ * @brief Gets how far the screen being drawn is between the
+ * last two simulation steps.
+ * @return The interpolation factor from 0.0 to 1.0.
+ **************************************************************/
+extern float frame_GetInterpolation(void);
+
+/**********************************************************//**
+ * @brief Blends a value between two simulation steps.
+ * @param previous: The value at the previous step.
+ * @param current: The value at the latest step.
+ * @param alpha: The interpolation factor.
+ * @return The value to draw.
+ **************************************************************/
+static inline float frame_Interpolate(float previous, float current, float alpha) {
+    return previous + (current - previous)*alpha;
+}
+
 /**********************************************************//**
  * @brief Draws text using the current theme.
  * @param x: The x coordinate of the text.
@@ -170,11 +209,18 @@ typedef enum {
 /**********************************************************//**
  * @struct TEXT_ENTRY
  * @brief Stores setting for one element of text in a
- * TEXT_FRAME.
+ * TEXT_FRAME. The width is cached by the text's pointer, not
+ * its contents, so text changed in place must either be given
+ * a new pointer or have measured set to NULL.
  **************************************************************/
 typedef struct {
     const char *text;   ///< The text to display at this entry.
     ENTRY_FLAG flags;   ///< Entry flags.
+    
+    // Layout cache (zero-initialize, maintained by the frame)
+    const char *measured;   ///< The pointer the width was measured for.
+    int theme;              ///< The theme the width was measured with.
+    int width;              ///< Cached width of the measured text.
 } TEXT_ENTRY;
 
 /**********************************************************//**
@@ -193,10 +239,11 @@ typedef struct {
 } TEXT_FRAME;
 
 /**********************************************************//**
- * @brief Gets the width of the text frame.
+ * @brief Gets the width of the text frame, measuring entries
+ * whose cached widths are stale.
  * @param frame: The text frame to inspect.
  **************************************************************/
-extern int textFrame_Width(const TEXT_FRAME *frame);
+extern int textFrame_Width(TEXT_FRAME *frame);
 
 /**********************************************************//**
  * @brief Gets the height of the text frame.
@@ -206,10 +253,11 @@ extern int textFrame_Height(const TEXT_FRAME *frame);
 
 /**********************************************************//**
  * @brief Draws the text frame and the text it contains based
- * on the current theme.
+ * on the current theme, measuring entries whose cached widths
+ * are stale.
  * @param frame: Pointer to a text frame to draw.
  **************************************************************/
-extern void textFrame_Draw(const TEXT_FRAME *frame);
+extern void textFrame_Draw(TEXT_FRAME *frame);
 
 /**********************************************************//**
  * @struct MENU
@@ -285,10 +333,11 @@ static inline int menu_Bottom(const MENU *menu) {
 }
 
 /**********************************************************//**
- * @brief Gets the width of the menu.
+ * @brief Gets the width of the menu, measuring entries whose
+ * cached widths are stale.
  * @param frame: The menu to inspect.
  **************************************************************/
-extern int menu_Width(const MENU *menu);
+extern int menu_Width(MENU *menu);
 
 /**********************************************************//**
  * @brief Gets the height of the menu.
@@ -297,10 +346,11 @@ extern int menu_Width(const MENU *menu);
 extern int menu_Height(const MENU *menu);
 
 /**********************************************************//**
- * @brief Draws the menu on the screen using the current theme.
+ * @brief Draws the menu on the screen using the current theme,
+ * measuring entries whose cached widths are stale.
  * @param menu: Pointer to the menu to draw.
  **************************************************************/
-extern void menu_Draw(const MENU *menu);
+extern void menu_Draw(MENU *menu);
 
 /**********************************************************//**
  * @brief Handles keyboard input for the given menu.
@@ -310,5 +360,91 @@ extern void menu_Draw(const MENU *menu);
  **************************************************************/
 extern MENU_STATUS menu_Run(MENU *menu, MENU_ACTION action);
 
+/**********************************************************//**
+ * @brief Draws one row of a virtual list.
+ * @param data: The data given to vlist_Draw.
+ * @param index: Index of the row.
+ * @param x: Left edge of the row.
+ * @param y: Top edge of the row.
+ * @param selected: Whether the row is under the cursor.
+ **************************************************************/
+typedef void (*VLIST_DRAW)(const void *data, int index, float x, float y, bool selected);
+
+/**********************************************************//**
+ * @struct VLIST
+ * @brief A scrolling list of equal-height rows that only ever
+ * visits the rows in view, so updating and drawing it costs
+ * the same no matter how many rows it has. The view glides to
+ * the cursor with a damped spring.
+ **************************************************************/
+typedef struct {
+    int x;              ///< Left edge of the view.
+    int y;              ///< Top edge of the view.
+    int height;         ///< Height of the view.
+    int rowHeight;      ///< Distance between the tops of two rows.
+    int count;          ///< Number of rows.
+    int cursor;         ///< The selected row.
+    float scroll;       ///< Distance scrolled past the first row.
+    float prevScroll;   ///< Scroll before the last update.
+    float velocity;     ///< Scrolling speed in pixels per second.
+    float scrollMax;    ///< Furthest scroll for the current count.
+} VLIST;
+
+/**********************************************************//**
+ * @brief Initializes an empty list scrolled to the top.
+ * @param list: The list to initialize.
+ * @param x: Left edge of the view.
+ * @param y: Top edge of the view.
+ * @param height: Height of the view.
+ * @param rowHeight: Distance between the tops of two rows.
+ **************************************************************/
+extern void vlist_Create(VLIST *list, int x, int y, int height, int rowHeight);
+
+/**********************************************************//**
+ * @brief Changes the number of rows, keeping the cursor on a
+ * row. Nothing is recomputed if the count is the same.
+ * @param list: The list to change.
+ * @param count: The new number of rows.
+ **************************************************************/
+extern void vlist_SetCount(VLIST *list, int count);
+
+/**********************************************************//**
+ * @brief Moves the cursor, stopping at either end.
+ * @param list: The list to change.
+ * @param delta: Number of rows to move down, or up if
+ * negative.
+ * @return Whether the cursor moved.
+ **************************************************************/
+extern bool vlist_MoveCursor(VLIST *list, int delta);
+
+/**********************************************************//**
+ * @brief Advances the scrolling by one simulation step.
+ * @param list: The list to update.
+ * @param dt: Length of the step in seconds.
+ * @return Whether the drawn list may have changed since the
+ * last step, so that the caller can redraw it.
+ **************************************************************/
+extern bool vlist_Update(VLIST *list, float dt);
+
+/**********************************************************//**
+ * @brief Gets the rows that are on the screen. The list isn't
+ * clipped, so rows scrolled above the view stay visible until
+ * they leave the top of the screen.
+ * @param list: The list to inspect.
+ * @param scroll: The scroll to check at.
+ * @param first: Output parameter for the first visible row.
+ * @param end: Output parameter for one past the last visible
+ * row.
+ **************************************************************/
+extern void vlist_GetVisible(const VLIST *list, float scroll, int *first, int *end);
+
+/**********************************************************//**
+ * @brief Draws the visible rows at the interpolated scroll.
+ * @param list: The list to draw.
+ * @param draw: Draws one row.
+ * @param data: Passed on to every draw call.
+ **************************************************************/
+extern void vlist_Draw(const VLIST *list, VLIST_DRAW draw, const void *data);
+
 /*============================================================*/
 #endif // _FRAME_H_
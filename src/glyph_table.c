@@ -0,0 +1,116 @@
+/**********************************************************//**
+ * @file glyph_table.c
+ * @brief Implementation of cached font glyph measurements.
+ **************************************************************/
+
+// Standard library
+#include <stddef.h>         // NULL
+#include <stdbool.h>        // bool
+
+// Allegro
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+
+// This project
+#include "debug.h"          // assert, eprintf
+#include "glyph_table.h"    // GLYPH_TABLE
+#include "atlas.h"          // atlas_AddGlyph, atlas_Free
+#include "render.h"         // render_DrawBitmap
+
+/*============================================================*
+ * Measuring a font
+ *============================================================*/
+void glyphTable_Create(GLYPH_TABLE *table, const ALLEGRO_FONT *font) {
+    table->font = font;
+    
+    // Missing fonts measure as empty so layout still works.
+    if (!font) {
+        eprintf("Measuring glyphs of a missing font.\n");
+        for (int i = 0; i < N_GLYPHS; i++) {
+            atlas_Free(table->glyph[i]);
+            table->advance[i] = 0;
+            table->glyph[i] = NULL;
+            table->left[i] = 0;
+            table->top[i] = 0;
+            table->missing[i] = false;
+        }
+        table->height = 0;
+        return;
+    }
+    
+    // Measure each printable character on its own
+    char string[2] = {'\0', '\0'};  // Need null terminator!
+    table->advance[0] = 0;
+    for (int i = 1; i < N_GLYPHS; i++) {
+        string[0] = (char)i;
+        table->advance[i] = al_get_text_width(font, string);
+    }
+    table->height = al_get_font_line_height(font);
+    
+    // Render the ink of the printable characters into the atlas
+    for (int i = 0; i < N_GLYPHS; i++) {
+        ALLEGRO_BITMAP *old = table->glyph[i];
+        int left = 0, top = 0, width = 0, height = 0;
+        bool inked = i >= ' ' && i < N_GLYPHS-1
+            && al_get_glyph_dimensions(font, i, &left, &top, &width, &height)
+            && width > 0 && height > 0;
+        table->glyph[i] = NULL;
+        table->left[i] = left;
+        table->top[i] = top;
+        if (inked && atlas_Owns(old)
+                && al_get_bitmap_width(old) >= width && al_get_bitmap_height(old) >= height) {
+            // Draw over the old image, as atlas space isn't reused
+            atlas_DrawGlyph(old, font, (char)i, left, top);
+            table->glyph[i] = old;
+        } else {
+            atlas_Free(old);
+            if (inked && atlas_GetBitmap()) {
+                table->glyph[i] = atlas_AddGlyph(font, (char)i, left, top, width, height);
+            }
+        }
+        table->missing[i] = inked && !table->glyph[i];
+    }
+}
+
+/*============================================================*
+ * Measuring text
+ *============================================================*/
+int glyphTable_TextWidth(const GLYPH_TABLE *table, const char *text) {
+    int width = 0;
+    for (const char *c = text; *c; c++) {
+        unsigned char index = (unsigned char)*c;
+        if (index >= N_GLYPHS) {
+            // Multibyte UTF-8 needs the real font metrics.
+            return table->font? al_get_text_width(table->font, text): 0;
+        }
+        width += table->advance[index];
+    }
+    return width;
+}
+
+/*============================================================*
+ * Drawing text
+ *============================================================*/
+void glyphTable_DrawText(const GLYPH_TABLE *table, ALLEGRO_COLOR color, int x, int y, const char *text) {
+    // Use the font if any visible character is missing
+    for (const char *c = text; *c; c++) {
+        unsigned char index = (unsigned char)*c;
+        if (index >= N_GLYPHS || table->missing[index]) {
+            if (table->font) {
+                render_DrawText(table->font, color, x, y, ALLEGRO_ALIGN_LEFT | ALLEGRO_ALIGN_INTEGER, text);
+            }
+            return;
+        }
+    }
+    
+    // Draw each glyph from the atlas
+    for (const char *c = text; *c; c++) {
+        unsigned char index = (unsigned char)*c;
+        if (table->glyph[index]) {
+            render_DrawBitmap(table->glyph[index], color, x + table->left[index], y + table->top[index]);
+        }
+        x += table->advance[index];
+    }
+}
+
+/*============================================================*/
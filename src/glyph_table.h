@@ -0,0 +1,95 @@
+/**********************************************************//**
+ * @file glyph_table.h
+ * @brief Header file for cached font glyph measurements.
+ **************************************************************/
+
+#ifndef _GLYPH_TABLE_H_
+#define _GLYPH_TABLE_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+
+// Allegro
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+
+//**************************************************************
+/// Number of glyphs measured in a table (7-bit ASCII).
+#define N_GLYPHS 128
+
+/**********************************************************//**
+ * @struct GLYPH_TABLE
+ * @brief Stores the advance of every ASCII glyph in a font so
+ * that text can be measured without calling into the font
+ * library, along with the glyph images in the texture atlas.
+ * Each image covers the glyph's ink, which can start left of
+ * the pen or run past the advance, so it is drawn offset by
+ * the glyph's bearing.
+ **************************************************************/
+typedef struct {
+    const ALLEGRO_FONT *font;   ///< The font that was measured.
+    int advance[N_GLYPHS];      ///< Width of each ASCII character.
+    int height;                 ///< Line height of the font.
+    ALLEGRO_BITMAP *glyph[N_GLYPHS];    ///< Atlas image of each character.
+    int left[N_GLYPHS];         ///< Left of each image, from the pen.
+    int top[N_GLYPHS];          ///< Top of each image, from the line.
+    bool missing[N_GLYPHS];     ///< Whether a character has ink but no image.
+} GLYPH_TABLE;
+
+/**********************************************************//**
+ * @brief Measures every glyph in the font and renders it into
+ * the texture atlas if the atlas exists. This is the only
+ * time the font library is queried for ASCII text. Images of
+ * a table made before are drawn over where they fit and freed
+ * where they don't, so the theme can be changed any number of
+ * times.
+ * @param table: The table to fill, which is either zeroed or
+ * was made before.
+ * @param font: The font to measure.
+ **************************************************************/
+extern void glyphTable_Create(GLYPH_TABLE *table, const ALLEGRO_FONT *font);
+
+/**********************************************************//**
+ * @brief Gets the width of the text using the cached glyph
+ * advances. Text containing non-ASCII characters falls back
+ * to the font library.
+ * @param table: The glyph table to use.
+ * @param text: The text to measure.
+ * @return The width of the text in pixels.
+ **************************************************************/
+extern int glyphTable_TextWidth(const GLYPH_TABLE *table, const char *text);
+
+/**********************************************************//**
+ * @brief Draws text from the glyph images in the atlas, so
+ * that it batches with other atlas drawing. Text that isn't
+ * in the atlas is drawn with the font instead.
+ * @param table: The glyph table to use.
+ * @param color: The color of the text.
+ * @param x: The x coordinate of the text.
+ * @param y: The y coordinate of the text.
+ * @param text: The text to draw.
+ **************************************************************/
+extern void glyphTable_DrawText(const GLYPH_TABLE *table, ALLEGRO_COLOR color, int x, int y, const char *text);
+
+/**********************************************************//**
+ * @brief Gets the width of a single character.
+ * @param table: The glyph table to use.
+ * @param letter: An ASCII character.
+ * @return The width of the character in pixels.
+ **************************************************************/
+static inline int glyphTable_Advance(const GLYPH_TABLE *table, char letter) {
+    return table->advance[(unsigned char)letter % N_GLYPHS];
+}
+
+/**********************************************************//**
+ * @brief Gets the atlas image of a single character.
+ * @param table: The glyph table to use.
+ * @param letter: An ASCII character.
+ * @return The glyph image, or NULL if it isn't in the atlas.
+ **************************************************************/
+static inline ALLEGRO_BITMAP *glyphTable_Glyph(const GLYPH_TABLE *table, char letter) {
+    return table->glyph[(unsigned char)letter % N_GLYPHS];
+}
+
+/*============================================================*/
+#endif // _GLYPH_TABLE_H_
@@ -0,0 +1,416 @@
+/**********************************************************//**
+ * @file language.c
+ * @brief Implementation of languages.
+ **************************************************************/
+
+// Standard library
+#include <stddef.h>         // NULL
+#include <stdbool.h>        // bool
+#include <stdlib.h>         // malloc, free, qsort
+#include <string.h>         // strlen, strchr, memcpy
+#include <pthread.h>        // pthread_once
+
+// This project
+#include "debug.h"          // assert, eprintf
+#include "language.h"       // LANGUAGE
+#include "word.h"           // STAT
+#include "word_table.h"     // WORD_TABLE
+
+/// Stat table entry for ASCII letters that fold outside ASCII.
+#define LETTER_WIDE 0xFF
+
+/// Stats in the order of the STAT enumeration.
+#define STAT_KEYS "HADS"
+
+/**********************************************************//**
+ * @struct WIDE_LETTER
+ * @brief A letter that isn't handled by the ASCII tables.
+ **************************************************************/
+typedef struct {
+    unsigned codepoint;     ///< The letter.
+    unsigned lower;         ///< Its lowercase form.
+    unsigned upper;         ///< Its uppercase form.
+    unsigned char stat;     ///< Its stat.
+} WIDE_LETTER;
+
+/**********************************************************//**
+ * @struct LANGUAGE
+ * @brief Lookup tables built from a LANGUAGE_DEF.
+ **************************************************************/
+struct LANGUAGE {
+    char name[MAX_LANGUAGE_NAME];   ///< Name of the language.
+    WORD_TABLE *table;              ///< Dictionary, or NULL for "real words".
+    unsigned char stat[128];        ///< Stat of each ASCII byte.
+    unsigned char lower[128];       ///< Lowercase of each ASCII byte.
+    unsigned char upper[128];       ///< Uppercase of each ASCII byte.
+    int nWide;                      ///< Number of wide letters.
+    WIDE_LETTER wide[2*MAX_ALPHABET]; ///< Wide letters by codepoint.
+};
+
+//**************************************************************
+/// The built-in English language.
+static const LANGUAGE_DEF ENGLISH = {
+    .name = "English",
+    .dictionary = NULL,
+    .lower = "abcdefghijklmnopqrstuvwxyz",
+    .upper = "ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+    //        ABCDEFGHIJKLMNOPQRSTUVWXYZ
+    .stats = "HDSDHADSHAASDSHSSAADHADAHS",
+};
+
+/// English, built on first use.
+static LANGUAGE GlobalEnglish;
+
+/// Builds GlobalEnglish once.
+static pthread_once_t GlobalEnglishOnce = PTHREAD_ONCE_INIT;
+
+/*============================================================*
+ * UTF-8
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Decodes one UTF-8 character.
+ * @param text: The character to decode.
+ * @param codepoint: Gets the codepoint.
+ * @return The number of bytes read, or 0 if invalid.
+ **************************************************************/
+static int Decode(const unsigned char *text, unsigned *codepoint) {
+    // Read the length from the first byte
+    unsigned c = text[0];
+    int length;
+    unsigned min;
+    if (c < 0x80) {
+        *codepoint = c;
+        return 1;
+    } else if ((c & 0xE0) == 0xC0) {
+        length = 2;
+        min = 0x80;
+        c &= 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+        length = 3;
+        min = 0x800;
+        c &= 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+        length = 4;
+        min = 0x10000;
+        c &= 0x07;
+    } else {
+        return 0;
+    }
+    
+    // A '\0' stops this before the end of the string
+    for (int i = 1; i < length; i++) {
+        if ((text[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        c = (c << 6) | (text[i] & 0x3F);
+    }
+    
+    // Reject overlong forms and surrogates
+    if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+        return 0;
+    }
+    *codepoint = c;
+    return length;
+}
+
+/**********************************************************//**
+ * @brief Encodes one codepoint as UTF-8.
+ * @param codepoint: A valid codepoint.
+ * @param text: Gets up to MAX_LETTER_BYTES bytes.
+ * @return The number of bytes written.
+ **************************************************************/
+static int Encode(unsigned codepoint, char *text) {
+    if (codepoint < 0x80) {
+        text[0] = codepoint;
+        return 1;
+    } else if (codepoint < 0x800) {
+        text[0] = 0xC0 | (codepoint >> 6);
+        text[1] = 0x80 | (codepoint & 0x3F);
+        return 2;
+    } else if (codepoint < 0x10000) {
+        text[0] = 0xE0 | (codepoint >> 12);
+        text[1] = 0x80 | ((codepoint >> 6) & 0x3F);
+        text[2] = 0x80 | (codepoint & 0x3F);
+        return 3;
+    }
+    text[0] = 0xF0 | (codepoint >> 18);
+    text[1] = 0x80 | ((codepoint >> 12) & 0x3F);
+    text[2] = 0x80 | ((codepoint >> 6) & 0x3F);
+    text[3] = 0x80 | (codepoint & 0x3F);
+    return 4;
+}
+
+/*============================================================*
+ * Building the tables
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Orders wide letters by codepoint for qsort.
+ **************************************************************/
+static int CompareWide(const void *a, const void *b) {
+    unsigned x = ((const WIDE_LETTER *)a)->codepoint;
+    unsigned y = ((const WIDE_LETTER *)b)->codepoint;
+    return (x > y) - (x < y);
+}
+
+/**********************************************************//**
+ * @brief Adds a letter the ASCII tables can't fold.
+ * @param language: The language being built.
+ * @param codepoint: The letter.
+ * @param lower: Its lowercase form.
+ * @param upper: Its uppercase form.
+ * @param stat: Its stat.
+ **************************************************************/
+static void AddWide(LANGUAGE *language, unsigned codepoint, unsigned lower, unsigned upper, unsigned char stat) {
+    assert(language->nWide < 2*MAX_ALPHABET);
+    if (codepoint < 0x80) {
+        language->stat[codepoint] = LETTER_WIDE;
+    }
+    language->wide[language->nWide++] = (WIDE_LETTER){codepoint, lower, upper, stat};
+}
+
+/**********************************************************//**
+ * @brief Builds the lookup tables of a language.
+ * @param language: The language to build.
+ * @param def: What to build it from.
+ * @return Whether the definition was valid.
+ **************************************************************/
+static bool Build(LANGUAGE *language, const LANGUAGE_DEF *def) {
+    if (strlen(def->name) >= MAX_LANGUAGE_NAME) {
+        eprintf("The language name \"%s\" is too long.\n", def->name);
+        return false;
+    }
+    strcpy(language->name, def->name);
+    
+    // Bytes outside the alphabet stay as they are
+    for (int i = 0; i < 128; i++) {
+        language->stat[i] = STAT_MAXHP;
+        language->lower[i] = i;
+        language->upper[i] = i;
+    }
+    language->nWide = 0;
+    
+    // Walk the three alphabet strings together
+    const unsigned char *lowers = (const unsigned char *)def->lower;
+    const unsigned char *uppers = (const unsigned char *)def->upper;
+    const char *stats = def->stats;
+    int letters = 0;
+    while (*lowers && *uppers && *stats) {
+        unsigned lower, upper;
+        int lowerBytes = Decode(lowers, &lower);
+        int upperBytes = Decode(uppers, &upper);
+        const char *key = strchr(STAT_KEYS, *stats);
+        if (!lowerBytes || !upperBytes || !key || letters >= MAX_ALPHABET) {
+            eprintf("Invalid alphabet for %s at letter %d.\n", def->name, letters);
+            return false;
+        }
+        unsigned char stat = key - STAT_KEYS;
+        
+        // ASCII pairs fold through the byte tables
+        if (lower < 0x80 && upper < 0x80) {
+            language->lower[lower] = language->lower[upper] = lower;
+            language->upper[lower] = language->upper[upper] = upper;
+            language->stat[lower] = language->stat[upper] = stat;
+        } else {
+            AddWide(language, lower, lower, upper, stat);
+            if (upper != lower) {
+                AddWide(language, upper, lower, upper, stat);
+            }
+        }
+        lowers += lowerBytes;
+        uppers += upperBytes;
+        stats++;
+        letters++;
+    }
+    if (*lowers || *uppers || *stats) {
+        eprintf("Alphabet strings for %s differ in length.\n", def->name);
+        return false;
+    }
+    
+    // Sorted for binary search
+    qsort(language->wide, language->nWide, sizeof(WIDE_LETTER), CompareWide);
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Finds a wide letter.
+ * @param language: The language to search.
+ * @param codepoint: The letter to find.
+ * @return The letter, or NULL if it isn't in the alphabet.
+ **************************************************************/
+static const WIDE_LETTER *FindWide(const LANGUAGE *language, unsigned codepoint) {
+    int start = 0;
+    int end = language->nWide;
+    while (start < end) {
+        int midpoint = start + (end - start) / 2;
+        unsigned found = language->wide[midpoint].codepoint;
+        if (found == codepoint) {
+            return &language->wide[midpoint];
+        } else if (found > codepoint) {
+            end = midpoint;
+        } else {
+            start = midpoint + 1;
+        }
+    }
+    return NULL;
+}
+
+/**********************************************************//**
+ * @brief Folds a dictionary word with a language's alphabet.
+ * @param data: The language.
+ * @param word: The word to fold.
+ * @param folded: Gets the lowercase word.
+ * @param size: Bytes available in folded.
+ * @return The length of the folded word, or -1 if invalid.
+ **************************************************************/
+static int FoldWord(const void *data, const char *word, char *folded, int size) {
+    char upper[MAX_WORD_LINE+1];
+    unsigned char stats[MAX_WORD_LINE/MAX_LETTER_BYTES];
+    int maxLetters = (size - 1) / MAX_LETTER_BYTES;
+    if (maxLetters > MAX_WORD_LINE/MAX_LETTER_BYTES) {
+        maxLetters = MAX_WORD_LINE/MAX_LETTER_BYTES;
+    }
+    if (language_Fold(data, word, folded, upper, stats, maxLetters) < 0) {
+        return -1;
+    }
+    return strlen(folded);
+}
+
+/*============================================================*
+ * Creating a language
+ *============================================================*/
+LANGUAGE *language_Create(const LANGUAGE_DEF *def) {
+    LANGUAGE *language = malloc(sizeof(LANGUAGE));
+    if (!language) {
+        eprintf("Out of memory.\n");
+        return NULL;
+    }
+    language->table = NULL;
+    if (!Build(language, def)) {
+        free(language);
+        return NULL;
+    }
+    
+    // Languages without a file share the "real words" table
+    if (def->dictionary) {
+        language->table = wordTable_CreateFolded(def->dictionary, FoldWord, language);
+        if (!language->table) {
+            free(language);
+            return NULL;
+        }
+    }
+    return language;
+}
+
+void language_Free(LANGUAGE *language) {
+    if (language) {
+        wordTable_Free(language->table);
+        free(language);
+    }
+}
+
+/**********************************************************//**
+ * @brief Builds GlobalEnglish.
+ **************************************************************/
+static void BuildEnglish(void) {
+    GlobalEnglish.table = NULL;
+    if (!Build(&GlobalEnglish, &ENGLISH)) {
+        eprintf("Failed to build English.\n");
+    }
+}
+
+const LANGUAGE *language_GetEnglish(void) {
+    pthread_once(&GlobalEnglishOnce, BuildEnglish);
+    return &GlobalEnglish;
+}
+
+const char *language_GetName(const LANGUAGE *language) {
+    return language->name;
+}
+
+/*============================================================*
+ * Folding text
+ *============================================================*/
+int language_Fold(const LANGUAGE *language, const char *text, char *lower, char *upper, unsigned char *stats, int maxLetters) {
+    const unsigned char *next = (const unsigned char *)text;
+    int nLower = 0;
+    int nUpper = 0;
+    int length = 0;
+    while (*next) {
+        if (length >= maxLetters) {
+            return -1;
+        }
+        
+        // Most letters are a single table lookup
+        unsigned c = *next;
+        if (c < 0x80 && language->stat[c] != LETTER_WIDE) {
+            lower[nLower++] = language->lower[c];
+            upper[nUpper++] = language->upper[c];
+            stats[length++] = language->stat[c];
+            next++;
+            continue;
+        }
+        
+        // Everything else is decoded and searched for
+        unsigned codepoint;
+        int bytes = Decode(next, &codepoint);
+        if (!bytes) {
+            return -1;
+        }
+        const WIDE_LETTER *letter = FindWide(language, codepoint);
+        if (letter) {
+            nLower += Encode(letter->lower, lower + nLower);
+            nUpper += Encode(letter->upper, upper + nUpper);
+            stats[length++] = letter->stat;
+        } else {
+            memcpy(lower + nLower, next, bytes);
+            memcpy(upper + nUpper, next, bytes);
+            nLower += bytes;
+            nUpper += bytes;
+            stats[length++] = STAT_MAXHP;
+        }
+        next += bytes;
+    }
+    lower[nLower] = '\0';
+    upper[nUpper] = '\0';
+    return length;
+}
+
+/*============================================================*
+ * Dictionary lookups
+ *============================================================*/
+bool language_HasDictionary(const LANGUAGE *language) {
+    return language->table || wordTable_IsValid();
+}
+
+bool language_Contains(const LANGUAGE *language, const char *lower) {
+    if (language->table) {
+        return wordTable_ContainsIn(language->table, lower);
+    }
+    return wordTable_Contains(lower);
+}
+
+int language_Suggest(const LANGUAGE *language, const char *text, int maxDistance, WORD_SUGGESTION *suggestions, int maxSuggestions) {
+    // Fold the text first, as the dictionary is lowercase
+    char lower[MAX_SUGGEST_QUERY+1];
+    char upper[MAX_SUGGEST_QUERY+1];
+    unsigned char stats[MAX_SUGGEST_QUERY/MAX_LETTER_BYTES];
+    if (language_Fold(language, text, lower, upper, stats, MAX_SUGGEST_QUERY/MAX_LETTER_BYTES) < 0) {
+        return 0;
+    }
+    if (language->table) {
+        return wordTable_SuggestIn(language->table, lower, maxDistance, suggestions, maxSuggestions);
+    }
+    return wordTable_Suggest(lower, maxDistance, suggestions, maxSuggestions);
+}
+
+bool language_Walk(const LANGUAGE *language, WORD_VISIT visit, void *data) {
+    if (language->table) {
+        wordTable_WalkIn(language->table, visit, data);
+        return true;
+    }
+    return wordTable_Walk(visit, data);
+}
+
+/*============================================================*/
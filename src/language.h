@@ -0,0 +1,136 @@
+/**********************************************************//**
+ * @file language.h
+ * @brief Header file for languages. Each language has its own
+ * alphabet, case folding, letter stats and dictionary. Text
+ * is UTF-8; ASCII letters are looked up with a single table
+ * access and other letters with a short search.
+ **************************************************************/
+
+#ifndef _LANGUAGE_H_
+#define _LANGUAGE_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+
+// This project
+#include "word_table.h" // WORD_SUGGESTION, WORD_VISIT
+
+//**************************************************************
+/// Most letters in one alphabet.
+#define MAX_ALPHABET 64
+
+/// Longest language name, including the '\0'.
+#define MAX_LANGUAGE_NAME 32
+
+/// Most bytes one letter can take in UTF-8.
+#define MAX_LETTER_BYTES 4
+
+/**********************************************************//**
+ * @struct LANGUAGE_DEF
+ * @brief Describes a language to create. The three alphabet
+ * strings list the letters in the same order.
+ **************************************************************/
+typedef struct {
+    const char *name;       ///< Name of the language.
+    const char *dictionary; ///< Word list, or NULL for the "real words" table.
+    const char *lower;      ///< Lowercase letters, in UTF-8.
+    const char *upper;      ///< Uppercase letters, in UTF-8.
+    const char *stats;      ///< Stat of each letter: 'H', 'A', 'D' or 'S'.
+} LANGUAGE_DEF;
+
+/**********************************************************//**
+ * @struct LANGUAGE
+ * @brief A language ready for making words. The contents are
+ * private to language.c and never change after creation.
+ **************************************************************/
+typedef struct LANGUAGE LANGUAGE;
+
+/**********************************************************//**
+ * @brief Creates a language and loads its dictionary. This
+ * may be called from any thread.
+ * @param def: The language to create.
+ * @return The language, which must be freed with
+ * language_Free, or NULL on failure.
+ **************************************************************/
+extern LANGUAGE *language_Create(const LANGUAGE_DEF *def);
+
+/**********************************************************//**
+ * @brief Frees a language made by language_Create. No word
+ * may be in the middle of being created with it.
+ * @param language: The language to free. NULL is ignored.
+ **************************************************************/
+extern void language_Free(LANGUAGE *language);
+
+/**********************************************************//**
+ * @brief Gets the built-in English language, which uses the
+ * "real words" table from wordTable_Load.
+ * @return The English language.
+ **************************************************************/
+extern const LANGUAGE *language_GetEnglish(void);
+
+/**********************************************************//**
+ * @brief Gets the name of a language.
+ * @param language: The language to inspect.
+ * @return The name.
+ **************************************************************/
+extern const char *language_GetName(const LANGUAGE *language);
+
+/**********************************************************//**
+ * @brief Folds text to lowercase and uppercase and finds the
+ * stat of each letter, in one pass. Characters outside the
+ * alphabet are copied unchanged and count as STAT_MAXHP.
+ * @param language: The language of the text.
+ * @param text: UTF-8 text.
+ * @param lower: Gets the lowercase text, with room for
+ * maxLetters*MAX_LETTER_BYTES+1 bytes.
+ * @param upper: Gets the uppercase text, the same size.
+ * @param stats: Gets the stat of each letter.
+ * @param maxLetters: Most letters to accept.
+ * @return The number of letters, or -1 if the text is not
+ * valid UTF-8 or has more than maxLetters letters.
+ **************************************************************/
+extern int language_Fold(const LANGUAGE *language, const char *text, char *lower, char *upper, unsigned char *stats, int maxLetters);
+
+/**********************************************************//**
+ * @brief Checks if the language's dictionary is loaded.
+ * @param language: The language to inspect.
+ * @return Whether words can be looked up.
+ **************************************************************/
+extern bool language_HasDictionary(const LANGUAGE *language);
+
+/**********************************************************//**
+ * @brief Checks if a word is in the language's dictionary.
+ * This is safe to call from any thread.
+ * @param language: The language to search.
+ * @param lower: The word, folded to lowercase.
+ * @return Whether the word is in the dictionary.
+ **************************************************************/
+extern bool language_Contains(const LANGUAGE *language, const char *lower);
+
+/**********************************************************//**
+ * @brief Finds the real words closest to some text, to suggest
+ * in place of a word that isn't real. This is safe to call
+ * from any thread.
+ * @param language: The language to search.
+ * @param text: The UTF-8 text, in any case.
+ * @param maxDistance: Most edits a suggestion may be away,
+ * up to MAX_SUGGEST_DISTANCE.
+ * @param suggestions: Gets the lowercase suggestions, closest
+ * first.
+ * @param maxSuggestions: Most suggestions to find.
+ * @return The number of suggestions found.
+ **************************************************************/
+extern int language_Suggest(const LANGUAGE *language, const char *text, int maxDistance, WORD_SUGGESTION *suggestions, int maxSuggestions);
+
+/**********************************************************//**
+ * @brief Visits every word in the language's dictionary, in
+ * order. This is safe to call from any thread.
+ * @param language: The language to walk.
+ * @param visit: Called with each lowercase word.
+ * @param data: Passed to visit.
+ * @return Whether the dictionary is loaded.
+ **************************************************************/
+extern bool language_Walk(const LANGUAGE *language, WORD_VISIT visit, void *data);
+
+/*============================================================*/
+#endif // _LANGUAGE_H_
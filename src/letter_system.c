@@ -0,0 +1,242 @@
+/**********************************************************//**
+ * @file letter_system.c
+ * @brief Implementation of the letter particle system.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>        // bool
+#include <stdlib.h>         // malloc, free
+#include <string.h>         // memcpy
+
+// This project
+#include "debug.h"          // assert, eprintf
+#include "letter_system.h"  // LETTER_SYSTEM
+
+//**************************************************************
+/// Number of float arrays in a letter system.
+#define N_FIELDS 20
+
+/**********************************************************//**
+ * @brief Gets every float array of the system, in the order
+ * they are laid out in memory.
+ * @param system: The system to inspect.
+ * @param fields: Output array of pointers to each field.
+ **************************************************************/
+static void Fields(LETTER_SYSTEM *system, float ***fields) {
+    fields[0] = &system->x;
+    fields[1] = &system->y;
+    fields[2] = &system->rotation;
+    fields[3] = &system->scaling;
+    fields[4] = &system->opacity;
+    fields[5] = &system->prevX;
+    fields[6] = &system->prevY;
+    fields[7] = &system->prevRotation;
+    fields[8] = &system->prevScaling;
+    fields[9] = &system->prevOpacity;
+    fields[10] = &system->xv;
+    fields[11] = &system->yv;
+    fields[12] = &system->rv;
+    fields[13] = &system->sv;
+    fields[14] = &system->ov;
+    fields[15] = &system->speed;
+    fields[16] = &system->gravity;
+    fields[17] = &system->drag;
+    fields[18] = &system->floor;
+    fields[19] = &system->bounce;
+}
+
+/*============================================================*
+ * Creating a letter system
+ *============================================================*/
+bool letterSystem_Create(LETTER_SYSTEM *system, int maxWords) {
+    if (maxWords <= 0) {
+        eprintf("Invalid letter system size: %d\n", maxWords);
+        return false;
+    }
+    int capacity = maxWords*LETTER_BLOCK;
+    
+    // One allocation holds every field back to back
+    float *memory = (float *)malloc(N_FIELDS * capacity * sizeof(float));
+    int *freeBlocks = (int *)malloc(maxWords * sizeof(int));
+    bool *allocated = (bool *)malloc(maxWords * sizeof(bool));
+    if (!memory || !freeBlocks || !allocated) {
+        eprintf("Out of memory.\n");
+        free(memory);
+        free(freeBlocks);
+        free(allocated);
+        return false;
+    }
+    float **fields[N_FIELDS];
+    Fields(system, fields);
+    for (int i = 0; i < N_FIELDS; i++) {
+        *fields[i] = &memory[i*capacity];
+    }
+    
+    // Every block starts free, lowest index on top
+    system->capacity = capacity;
+    system->used = 0;
+    system->freeBlocks = freeBlocks;
+    system->allocated = allocated;
+    system->nFree = maxWords;
+    for (int i = 0; i < maxWords; i++) {
+        freeBlocks[i] = maxWords - 1 - i;
+        allocated[i] = false;
+    }
+    letterSystem_Reset(system, 0, capacity);
+    return true;
+}
+
+/*============================================================*
+ * Destroying a letter system
+ *============================================================*/
+void letterSystem_Destroy(LETTER_SYSTEM *system) {
+    // The first field owns the shared allocation
+    free(system->x);
+    free(system->freeBlocks);
+    free(system->allocated);
+    float **fields[N_FIELDS];
+    Fields(system, fields);
+    for (int i = 0; i < N_FIELDS; i++) {
+        *fields[i] = NULL;
+    }
+    system->freeBlocks = NULL;
+    system->allocated = NULL;
+    system->capacity = 0;
+    system->used = 0;
+    system->nFree = 0;
+}
+
+/*============================================================*
+ * Allocating letters
+ *============================================================*/
+int letterSystem_Allocate(LETTER_SYSTEM *system) {
+    if (system->nFree <= 0) {
+        eprintf("The letter system is full.\n");
+        return -1;
+    }
+    int block = system->freeBlocks[--system->nFree];
+    int first = block*LETTER_BLOCK;
+    system->allocated[block] = true;
+    if (first + LETTER_BLOCK > system->used) {
+        system->used = first + LETTER_BLOCK;
+    }
+    letterSystem_Reset(system, first, LETTER_BLOCK);
+    return first;
+}
+
+void letterSystem_Free(LETTER_SYSTEM *system, int first) {
+    int block = first / LETTER_BLOCK;
+    if (first < 0 || first >= system->capacity || first % LETTER_BLOCK || !system->allocated[block]) {
+        eprintf("Invalid letter block: %d\n", first);
+        return;
+    }
+    
+    // Freed letters rest so integration leaves them alone
+    letterSystem_Reset(system, first, LETTER_BLOCK);
+    system->freeBlocks[system->nFree++] = block;
+    system->allocated[block] = false;
+    
+    // Shrink the range that gets integrated
+    while (system->used > 0 && !system->allocated[system->used/LETTER_BLOCK - 1]) {
+        system->used -= LETTER_BLOCK;
+    }
+}
+
+/*============================================================*
+ * Resetting letters
+ *============================================================*/
+void letterSystem_Reset(LETTER_SYSTEM *system, int first, int count) {
+    for (int i = first; i < first + count; i++) {
+        system->x[i] = 0.0;
+        system->y[i] = 0.0;
+        system->rotation[i] = 0.0;
+        system->scaling[i] = 1.0;
+        system->opacity[i] = 1.0;
+        system->prevX[i] = 0.0;
+        system->prevY[i] = 0.0;
+        system->prevRotation[i] = 0.0;
+        system->prevScaling[i] = 1.0;
+        system->prevOpacity[i] = 1.0;
+        system->xv[i] = 0.0;
+        system->yv[i] = 0.0;
+        system->rv[i] = 0.0;
+        system->sv[i] = 0.0;
+        system->ov[i] = 0.0;
+        system->speed[i] = 0.0;
+        system->gravity[i] = 0.0;
+        system->drag[i] = 0.0;
+        system->floor[i] = LETTER_NO_FLOOR;
+        system->bounce[i] = 1.0;
+    }
+}
+
+/**********************************************************//**
+ * @brief Integrates rotation, scaling and fading.
+ **************************************************************/
+static void IntegrateSpin(int n, float dt,
+        float *restrict rotation, float *restrict scaling, float *restrict opacity,
+        const float *restrict rv, const float *restrict sv, const float *restrict ov) {
+    for (int i = 0; i < n; i++) {
+        rotation[i] += rv[i]*dt;
+        scaling[i] += sv[i]*dt;
+        float o = opacity[i] + ov[i]*dt;
+        opacity[i] = o > 0.0f? o: 0.0f;
+    }
+}
+
+/**********************************************************//**
+ * @brief Integrates horizontal motion with drag.
+ **************************************************************/
+static void IntegrateX(int n, float dt,
+        float *restrict x, float *restrict xv,
+        const float *restrict speed, const float *restrict drag) {
+    for (int i = 0; i < n; i++) {
+        x[i] += speed[i]*xv[i]*dt;
+        xv[i] -= drag[i]*dt*xv[i];
+    }
+}
+
+/**********************************************************//**
+ * @brief Integrates vertical motion with gravity and floor
+ * collision.
+ **************************************************************/
+static void IntegrateY(int n, float dt,
+        float *restrict y, float *restrict yv,
+        const float *restrict speed, const float *restrict gravity,
+        const float *restrict floor, const float *restrict bounce) {
+    for (int i = 0; i < n; i++) {
+        float nextY = y[i] + speed[i]*yv[i]*dt;
+        float nextV = yv[i] - gravity[i]*dt;
+        
+        // Both sides of the collision are computed so that it
+        // becomes a pair of vector selects.
+        float low = floor[i];
+        float bounced = bounce[i];
+        float scale = nextY < low? bounced: 1.0f;
+        y[i] = nextY < low? low: nextY;
+        yv[i] = nextV*scale;
+    }
+}
+
+/*============================================================*
+ * Integrating letters
+ *============================================================*/
+void letterSystem_Update(LETTER_SYSTEM *system, float dt) {
+    // The current state becomes the previous state
+    const int n = system->used;
+    size_t size = n*sizeof(float);
+    memcpy(system->prevX, system->x, size);
+    memcpy(system->prevY, system->y, size);
+    memcpy(system->prevRotation, system->rotation, size);
+    memcpy(system->prevScaling, system->scaling, size);
+    memcpy(system->prevOpacity, system->opacity, size);
+    
+    // Each field is its own array and the loops have no calls,
+    // so the compiler vectorizes them (with -fno-trapping-math
+    // for the floor collision selects).
+    IntegrateSpin(n, dt, system->rotation, system->scaling, system->opacity, system->rv, system->sv, system->ov);
+    IntegrateX(n, dt, system->x, system->xv, system->speed, system->drag);
+    IntegrateY(n, dt, system->y, system->yv, system->speed, system->gravity, system->floor, system->bounce);
+}
+
+/*============================================================*/
@@ -0,0 +1,117 @@
+/**********************************************************//**
+ * @file letter_system.h
+ * @brief Header file for the letter particle system that
+ * animates the letters of every word sprite.
+ **************************************************************/
+
+#ifndef _LETTER_SYSTEM_H_
+#define _LETTER_SYSTEM_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+
+// This project
+#include "word.h"       // MAX_WORD_LENGTH
+
+//**************************************************************
+/// Number of letters reserved for each word.
+#define LETTER_BLOCK MAX_WORD_LENGTH
+
+/// Floor used by letters that can fall forever.
+#define LETTER_NO_FLOOR -1.0e9f
+
+/**********************************************************//**
+ * @struct LETTER_SYSTEM
+ * @brief Stores every animated letter in structure-of-arrays
+ * form, so that the letters of all words are integrated
+ * together in tight loops. Each word owns a block of
+ * LETTER_BLOCK consecutive letters. The state before the last
+ * update is kept so that drawing can blend between steps.
+ **************************************************************/
+typedef struct {
+    // Letter state
+    float *x;           ///< Letter X offset position.
+    float *y;           ///< Letter Y offset position.
+    float *rotation;    ///< Rotation in radians of the letter.
+    float *scaling;     ///< Scaling applied to the letter.
+    float *opacity;     ///< Opacity of the letter.
+    
+    // Letter state before the last update
+    float *prevX;       ///< Previous X offset position.
+    float *prevY;       ///< Previous Y offset position.
+    float *prevRotation;///< Previous rotation.
+    float *prevScaling; ///< Previous scaling.
+    float *prevOpacity; ///< Previous opacity.
+    
+    // Letter velocities
+    float *xv;          ///< X velocity.
+    float *yv;          ///< Y velocity.
+    float *rv;          ///< Rotational velocity.
+    float *sv;          ///< Size velocity.
+    float *ov;          ///< Opacity velocity.
+    
+    // Letter physics
+    float *speed;       ///< Scale applied to the position velocity.
+    float *gravity;     ///< Downward acceleration.
+    float *drag;        ///< Fraction of X velocity lost per second.
+    float *floor;       ///< Lowest Y position of the letter.
+    float *bounce;      ///< Y velocity scale when hitting the floor.
+    
+    // Allocation
+    int capacity;       ///< Number of letters allocated.
+    int used;           ///< One past the highest block in use, in letters.
+    int *freeBlocks;    ///< Stack of free block indices.
+    int nFree;          ///< Number of free blocks.
+    bool *allocated;    ///< Whether each block is in use.
+} LETTER_SYSTEM;
+
+/**********************************************************//**
+ * @brief Creates an empty letter system.
+ * @param system: The system to initialize.
+ * @param maxWords: The number of words it can animate.
+ * @return Whether the creation succeeded. If it succeeds you
+ * must destroy the system with letterSystem_Destroy later.
+ **************************************************************/
+extern bool letterSystem_Create(LETTER_SYSTEM *system, int maxWords);
+
+/**********************************************************//**
+ * @brief Frees all memory owned by the letter system.
+ * @param system: The system to destroy.
+ **************************************************************/
+extern void letterSystem_Destroy(LETTER_SYSTEM *system);
+
+/**********************************************************//**
+ * @brief Reserves a block of letters for one word. The letters
+ * start at rest.
+ * @param system: The system to allocate from.
+ * @return Index of the first letter of the block, or -1 if the
+ * system is full.
+ **************************************************************/
+extern int letterSystem_Allocate(LETTER_SYSTEM *system);
+
+/**********************************************************//**
+ * @brief Returns a block of letters to the system.
+ * @param system: The system to return the block to.
+ * @param first: Index of the first letter of the block.
+ **************************************************************/
+extern void letterSystem_Free(LETTER_SYSTEM *system, int first);
+
+/**********************************************************//**
+ * @brief Puts letters at rest at their origin.
+ * @param system: The system to modify.
+ * @param first: Index of the first letter.
+ * @param count: Number of letters to reset.
+ **************************************************************/
+extern void letterSystem_Reset(LETTER_SYSTEM *system, int first, int count);
+
+/**********************************************************//**
+ * @brief Advances every letter in the system by one Euler
+ * step, saving the old state first. Letters at rest are
+ * unaffected.
+ * @param system: The system to update.
+ * @param dt: The time step.
+ **************************************************************/
+extern void letterSystem_Update(LETTER_SYSTEM *system, float dt);
+
+/*============================================================*/
+#endif // _LETTER_SYSTEM_H_
@@ -0,0 +1,203 @@
+/**********************************************************//**
+ * @file loader.c
+ * @brief Implementation of the background loader.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>        // bool
+#include <stddef.h>         // NULL
+
+// Allegro
+#include <allegro5/allegro.h>
+
+// This project
+#include "debug.h"          // assert, eprintf
+#include "resource.h"       // resource_LoadImage, resource_Release
+#include "loader.h"         // LOADER_FUNCTION
+
+/**********************************************************//**
+ * @struct LOADER_JOB
+ * @brief One queued job.
+ **************************************************************/
+typedef struct {
+    LOADER_FUNCTION function;   ///< The job to run.
+    void *data;                 ///< Data passed to the job.
+} LOADER_JOB;
+
+/**********************************************************//**
+ * @struct LOADER
+ * @brief The job queue and the threads working through it.
+ **************************************************************/
+typedef struct {
+    LOADER_JOB jobs[MAX_LOADER_JOBS];   ///< Every queued job.
+    int nJobs;                  ///< Number of queued jobs.
+    int next;                   ///< Next job to hand out.
+    int done;                   ///< Number of finished jobs.
+    int failed;                 ///< Number of failed jobs.
+    bool stopping;              ///< Whether the threads should exit.
+    ALLEGRO_THREAD *threads[MAX_LOADER_THREADS]; ///< Workers.
+    int nThreads;               ///< Number of workers.
+    ALLEGRO_MUTEX *mutex;       ///< Guards everything above.
+    ALLEGRO_COND *changed;      ///< Signaled on new or finished jobs.
+} LOADER;
+
+/// The loader shared by the whole program.
+static LOADER GlobalLoader;
+
+/**********************************************************//**
+ * @brief Worker thread that runs jobs until told to stop.
+ * @param thread: The Allegro thread.
+ * @param arg: Unused.
+ * @return Unused.
+ **************************************************************/
+static void *Work(ALLEGRO_THREAD *thread, void *arg) {
+    (void)thread;
+    (void)arg;
+    LOADER *loader = &GlobalLoader;
+    al_lock_mutex(loader->mutex);
+    while (true) {
+        // Sleep until there is a job or nothing more to do
+        while (loader->next == loader->nJobs && !loader->stopping) {
+            al_wait_cond(loader->changed, loader->mutex);
+        }
+        if (loader->next == loader->nJobs) {
+            break;
+        }
+        
+        // Run the job without holding up the queue
+        LOADER_JOB job = loader->jobs[loader->next++];
+        al_unlock_mutex(loader->mutex);
+        bool success = job.function(job.data);
+        al_lock_mutex(loader->mutex);
+        loader->done++;
+        loader->failed += !success;
+        al_broadcast_cond(loader->changed);
+    }
+    al_unlock_mutex(loader->mutex);
+    return NULL;
+}
+
+/**********************************************************//**
+ * @brief Job that decodes an image into the resource cache.
+ * A missing image is reported but doesn't fail the job, since
+ * the effect is obvious on screen.
+ * @param data: The filename.
+ * @return Always true.
+ **************************************************************/
+static bool LoadImage(void *data) {
+    // The decoded image stays cached for resource_LoadBitmap
+    resource_Release(resource_LoadImage(data));
+    return true;
+}
+
+/*============================================================*
+ * Starting the loader
+ *============================================================*/
+bool loader_Start(int nThreads) {
+    LOADER *loader = &GlobalLoader;
+    assert(!loader->mutex);
+    if (nThreads < 1) {
+        nThreads = 1;
+    } else if (nThreads > MAX_LOADER_THREADS) {
+        nThreads = MAX_LOADER_THREADS;
+    }
+    loader->nJobs = 0;
+    loader->next = 0;
+    loader->done = 0;
+    loader->failed = 0;
+    loader->stopping = false;
+    loader->nThreads = 0;
+    loader->mutex = al_create_mutex();
+    loader->changed = al_create_cond();
+    if (!loader->mutex || !loader->changed) {
+        eprintf("Failed to create the loader lock.\n");
+        loader_Finish();
+        return false;
+    }
+    
+    // Start the workers
+    for (int i = 0; i < nThreads; i++) {
+        ALLEGRO_THREAD *thread = al_create_thread(Work, NULL);
+        if (!thread) {
+            eprintf("Failed to create a loader thread.\n");
+            loader_Finish();
+            return false;
+        }
+        loader->threads[loader->nThreads++] = thread;
+        al_start_thread(thread);
+    }
+    return true;
+}
+
+/*============================================================*
+ * Queueing jobs
+ *============================================================*/
+bool loader_Add(LOADER_FUNCTION function, void *data) {
+    LOADER *loader = &GlobalLoader;
+    assert(loader->mutex);
+    al_lock_mutex(loader->mutex);
+    if (loader->nJobs >= MAX_LOADER_JOBS) {
+        al_unlock_mutex(loader->mutex);
+        eprintf("Too many loader jobs.\n");
+        return false;
+    }
+    loader->jobs[loader->nJobs++] = (LOADER_JOB){function, data};
+    al_broadcast_cond(loader->changed);
+    al_unlock_mutex(loader->mutex);
+    return true;
+}
+
+bool loader_AddImage(const char *filename) {
+    return loader_Add(LoadImage, (void *)filename);
+}
+
+/*============================================================*
+ * Checking progress
+ *============================================================*/
+void loader_GetProgress(int *done, int *total) {
+    LOADER *loader = &GlobalLoader;
+    assert(loader->mutex);
+    al_lock_mutex(loader->mutex);
+    *done = loader->done;
+    *total = loader->nJobs;
+    al_unlock_mutex(loader->mutex);
+}
+
+bool loader_IsFinished(void) {
+    int done, total;
+    loader_GetProgress(&done, &total);
+    return done == total;
+}
+
+/*============================================================*
+ * Stopping the loader
+ *============================================================*/
+bool loader_Finish(void) {
+    LOADER *loader = &GlobalLoader;
+    
+    // Let the workers drain the queue and exit
+    if (loader->mutex && loader->changed) {
+        al_lock_mutex(loader->mutex);
+        loader->stopping = true;
+        al_broadcast_cond(loader->changed);
+        al_unlock_mutex(loader->mutex);
+    }
+    for (int i = 0; i < loader->nThreads; i++) {
+        al_join_thread(loader->threads[i], NULL);
+        al_destroy_thread(loader->threads[i]);
+    }
+    loader->nThreads = 0;
+    
+    // Nothing else can touch the queue now
+    if (loader->changed) {
+        al_destroy_cond(loader->changed);
+        loader->changed = NULL;
+    }
+    if (loader->mutex) {
+        al_destroy_mutex(loader->mutex);
+        loader->mutex = NULL;
+    }
+    return loader->failed == 0 && loader->done == loader->nJobs;
+}
+
+/*============================================================*/
@@ -0,0 +1,76 @@
+/**********************************************************//**
+ * @file loader.h
+ * @brief Header file for the background loader, which runs
+ * slow startup work on worker threads while the main thread
+ * opens the display and draws a loading screen.
+ **************************************************************/
+
+#ifndef _LOADER_H_
+#define _LOADER_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+
+//**************************************************************
+/// The maximum number of jobs queued before loader_Finish.
+#define MAX_LOADER_JOBS 64
+
+/// The maximum number of worker threads.
+#define MAX_LOADER_THREADS 4
+
+/**********************************************************//**
+ * @brief One job for the loader. Jobs run on a worker thread,
+ * so they must not touch the display or the atlas.
+ * @param data: Job-specific data.
+ * @return Whether the job succeeded.
+ **************************************************************/
+typedef bool (*LOADER_FUNCTION)(void *data);
+
+/**********************************************************//**
+ * @brief Starts the worker threads. Jobs run as soon as they
+ * are added.
+ * @param nThreads: Number of jobs that can run at once.
+ * @return Whether the threads were started.
+ **************************************************************/
+extern bool loader_Start(int nThreads);
+
+/**********************************************************//**
+ * @brief Queues a job.
+ * @param function: The job to run.
+ * @param data: Data passed to the job, which must stay valid
+ * until the job finishes.
+ * @return Whether the job was queued.
+ **************************************************************/
+extern bool loader_Add(LOADER_FUNCTION function, void *data);
+
+/**********************************************************//**
+ * @brief Queues decoding an image into the resource cache, so
+ * that resource_LoadBitmap finds it already decoded.
+ * @param filename: The image file, which must stay valid
+ * until the job finishes.
+ * @return Whether the job was queued.
+ **************************************************************/
+extern bool loader_AddImage(const char *filename);
+
+/**********************************************************//**
+ * @brief Gets how many of the queued jobs are done.
+ * @param done: Output parameter for the finished jobs.
+ * @param total: Output parameter for the queued jobs.
+ **************************************************************/
+extern void loader_GetProgress(int *done, int *total);
+
+/**********************************************************//**
+ * @brief Checks whether every queued job is done, without
+ * waiting.
+ * @return Whether the loader is idle.
+ **************************************************************/
+extern bool loader_IsFinished(void);
+
+/**********************************************************//**
+ * @brief Waits for every queued job and stops the threads.
+ * @return Whether every job succeeded.
+ **************************************************************/
+extern bool loader_Finish(void);
+
+/*============================================================*/
+#endif // _LOADER_H_
@@ -58,6 +58,7 @@ static inline void RemoveFromTeam(PLAYER *player, int index) {
         if (player->team[i] == index) {
             while (i < player->nTeam-1) {
                 player->team[i] = player->team[i+1];
+                i++;
             }
             player->nTeam--;
             break;
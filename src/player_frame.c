@@ -8,37 +8,106 @@
 #include "player.h"
 #include "word_frame.h"
 #include "player_frame.h"
+#include "frame.h"
+#include "redraw.h"
+#include "profile.h"
 
 #define PADDING 8
 
 #define BORDER 10
 
-void playerFrame_DrawTeam(const TEAM_MENU *menu) {
+/// Left edge of the team column.
+#define TEAM_X (BORDER+WORD_HUD_WIDTH+BORDER)
+
+/**********************************************************//**
+ * @brief Marks the scrolling box column for redraw.
+ **************************************************************/
+static inline void InvalidateBox(void) {
+    redraw_Invalidate(0, 0, TEAM_X, WINDOW_HEIGHT);
+}
+
+/**********************************************************//**
+ * @brief Marks the team column for redraw.
+ **************************************************************/
+static inline void InvalidateTeam(void) {
+    redraw_Invalidate(TEAM_X, 0, WORD_HUD_WIDTH+BORDER, WINDOW_HEIGHT);
+}
+
+/**********************************************************//**
+ * @brief Checks a displayed word against the state it was last
+ * drawn in, and remembers its current state.
+ * @param menu: The menu to inspect.
+ * @param index: Index of the word.
+ * @return Whether the word changed.
+ **************************************************************/
+static bool WordChanged(TEAM_MENU *menu, int index) {
+    const WORD *word = &menu->player->words[index];
+    SHOWN_WORD *shown = &menu->shown[index];
+    bool changed = shown->version != word->version || shown->flags != word->flags;
+    shown->version = word->version;
+    shown->flags = word->flags;
+    return changed;
+}
+
+/**********************************************************//**
+ * @brief Checks whether anything displayed changed since it was
+ * last checked. Only the words in view are visited, since
+ * scrolling redraws the box anyway.
+ * @param menu: The menu to inspect.
+ * @return Whether the display changed.
+ **************************************************************/
+static bool DisplayChanged(TEAM_MENU *menu) {
     const PLAYER *player = menu->player;
-    
-    // Draw the player data
-    float dy = WORD_HUD_HEIGHT_EXTENDED + PADDING;
-    
-    // Get the scroll endpoints
-    int start = (int)((menu->scroll - BORDER) / dy);
-    if (start < 0) {
-        start = 0;
+    bool changed = menu->shownNWords != player->nWords || menu->shownNTeam != player->nTeam;
+    menu->shownNWords = player->nWords;
+    menu->shownNTeam = player->nTeam;
+    int first, end;
+    vlist_GetVisible(&menu->box, menu->box.scroll, &first, &end);
+    for (int i = first; i < end; i++) {
+        changed |= WordChanged(menu, i);
     }
-    int end = (int)((menu->scroll + WINDOW_HEIGHT + dy) / dy);
-    if (end > player->nWords) {
-        end = player->nWords;
+    for (int i = 0; i < player->nTeam; i++) {
+        changed |= menu->shownTeam[i] != player->team[i];
+        menu->shownTeam[i] = player->team[i];
+        changed |= WordChanged(menu, player->team[i]);
     }
+    return changed;
+}
+
+/**********************************************************//**
+ * @brief Draws one word in the box.
+ * @param data: The team menu.
+ * @param index: Index of the word.
+ * @param x: Left edge of the HUD.
+ * @param y: Top edge of the HUD.
+ * @param selected: Whether the box cursor is on the word.
+ **************************************************************/
+static void DrawBoxWord(const void *data, int index, float x, float y, bool selected) {
+    const TEAM_MENU *menu = data;
+    wordFrame_DrawHUD(&menu->player->words[index], x, y, HUD_EXTENDED, selected && menu->column == 0);
+}
+
+void playerFrame_CreateTeam(TEAM_MENU *menu, PLAYER *player) {
+    menu->player = player;
+    vlist_Create(&menu->box, BORDER, BORDER, WINDOW_HEIGHT - BORDER, WORD_HUD_HEIGHT_EXTENDED + PADDING);
+    vlist_SetCount(&menu->box, player->nWords);
+    menu->teamSelect = 0;
+    menu->column = 0;
+    menu->state = TEAM_MENU_STATE_MAIN;
+    menu->shownNWords = -1;
+    menu->shownNTeam = -1;
+}
+
+void playerFrame_DrawTeam(const TEAM_MENU *menu) {
+    PROFILE_ZONE("playerFrame_DrawTeam");
+    
+    PLAYER *player = menu->player;
     
     // Draw the word HUDs for everything in the box
-    float x = BORDER;
-    float y = BORDER + start*dy - menu->scroll;
-    for (int i = start; i < end; i++) {
-        wordFrame_DrawHUD(&player->words[i], x, y, HUD_EXTENDED, menu->boxSelect == i && menu->column == 0);
-        y += dy;
-    }
+    vlist_Draw(&menu->box, DrawBoxWord, menu);
 	
 	// Draw words in the current team
-	float teamX = BORDER+WORD_HUD_WIDTH+BORDER;
+	float teamX = TEAM_X;
 	float teamY = BORDER;
 	for (int i = 0; i < player->nTeam; i++) {
 		wordFrame_DrawHUD(&player->words[player->team[i]], teamX, teamY, HUD_FULL, menu->teamSelect == player->team[i] && menu->column == 1);
@@ -51,19 +120,25 @@ void playerFrame_DrawTeam(const TEAM_MENU *menu) {
 
 void playerFrame_InteractTeam(TEAM_MENU *menu, TEAM_MENU_ACTION action) {
 	const PLAYER *player = menu->player;
-	
+    
+    // Selection highlights may change in either column
+    if (action != TEAM_MENU_NEUTRAL) {
+        InvalidateBox();
+        InvalidateTeam();
+    }
+    
     switch (action) {
     case TEAM_MENU_UP:
-        if (menu->column == 0 && menu->boxSelect > 0) {
-            menu->boxSelect--;
+        if (menu->column == 0) {
+            vlist_MoveCursor(&menu->box, -1);
         } else if (menu->column == 1 && menu->teamSelect > 0) {
             menu->teamSelect--;
         }
         break;
-		
+    
     case TEAM_MENU_DOWN:
-		if (menu->column == 0 && menu->boxSelect < player->nWords-1) {
-            menu->boxSelect++;
+		if (menu->column == 0) {
+            vlist_MoveCursor(&menu->box, 1);
         } else if (menu->column == 1 && menu->teamSelect < player->nTeam-1) {
             menu->teamSelect++;
         }
@@ -88,50 +163,24 @@ void playerFrame_InteractTeam(TEAM_MENU *menu, TEAM_MENU_ACTION action) {
 void playerFrame_UpdateTeam(TEAM_MENU *menu, float dt) {
     const PLAYER *player = menu->player;
     
-    // Total menu items height
-    float dy = WORD_HUD_HEIGHT_EXTENDED + PADDING;
-	float span = player->nWords*dy;
-	float spanMax = WINDOW_HEIGHT - BORDER;
-	if (span > spanMax) {
-		span = spanMax;
-	}
-	
-	// Minimum scroll
-    float scrollMin = 0;
-	
-	// Maximum scroll
-    float scrollMax = player->nWords*dy - span;
-    if (scrollMax < 0) {
-        scrollMax = 0;
+    // Scroll limits only change with the number of words
+    vlist_SetCount(&menu->box, player->nWords);
+    
+    // Redraw everything if any displayed word changed
+    if (DisplayChanged(menu)) {
+        InvalidateBox();
+        InvalidateTeam();
     }
     
     switch (menu->state) {
-    case TEAM_MENU_STATE_MAIN: {
-		// Get the target scroll
-		float targetScroll = menu->boxSelect*dy;
-		if (targetScroll > scrollMax) {
-			targetScroll = scrollMax;
-		} else if (targetScroll < scrollMin) {
-			targetScroll = scrollMin;
-		}
-		
-		// Velocity computation
-		float velocity = targetScroll - menu->scroll;
-		if (velocity > 8.0) {
-			velocity = 8.0;
-		} else if (velocity < -8.0) {
-			velocity = -8.0;
-		}
-		
-        // Menu physics update
-        menu->scroll += velocity;
-        if (menu->scroll > scrollMax) {
-            menu->scroll = scrollMax;
-        } else if (menu->scroll < scrollMin) {
-            menu->scroll = scrollMin;
+    case TEAM_MENU_STATE_MAIN:
+        // Keep redrawing until the drawn scroll settles
+        if (vlist_Update(&menu->box, dt)) {
+            InvalidateBox();
         }
-	}
+        break;
+    
     default:
         break;
     }
-}
\ No newline at end of file
+}
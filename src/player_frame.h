@@ -2,19 +2,36 @@
 #ifndef _PLAYER_FRAME_H_
 #define _PLAYER_FRAME_H_
 
+#include "player.h"
+#include "frame.h"
+
 typedef enum {
     TEAM_MENU_STATE_MAIN,
 } TEAM_MENU_STATE;
 
+/**********************************************************//**
+ * @struct SHOWN_WORD
+ * @brief The state a displayed word was last drawn in.
+ **************************************************************/
+typedef struct {
+    unsigned version;   ///< Version of the word when drawn.
+    WORD_FLAGS flags;   ///< Flags of the word when drawn.
+} SHOWN_WORD;
+
 typedef struct {
     PLAYER *player;
-    float scroll;
+    VLIST box;          ///< Every word, with the box selection.
     TEAM_MENU_STATE state;
     
     // Selection
-    int boxSelect;
     int teamSelect;
     int column;
+    
+    // Redraw tracking
+    SHOWN_WORD shown[MAX_WORDS]; ///< Each word when last displayed.
+    int shownTeam[TEAM_SIZE];   ///< The team when last displayed.
+    int shownNTeam;     ///< Team size when last displayed, or -1.
+    int shownNWords;    ///< Words owned when last displayed, or -1.
 } TEAM_MENU;
 
 typedef enum {
@@ -27,14 +44,7 @@ typedef enum {
     TEAM_MENU_SELECT,
 } TEAM_MENU_ACTION;
 
-static void playerFrame_CreateTeam(TEAM_MENU *menu, PLAYER *player) {
-    menu->player = player;
-    menu->scroll = 0.0;
-    menu->boxSelect = 0;
-    menu->teamSelect = 0;
-    menu->column = 0;
-    menu->state = TEAM_MENU_STATE_MAIN;
-}
+extern void playerFrame_CreateTeam(TEAM_MENU *menu, PLAYER *player);
 
 extern void playerFrame_DrawTeam(const TEAM_MENU *menu);
 
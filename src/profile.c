@@ -0,0 +1,131 @@
+/**********************************************************//**
+ * @file profile.c
+ * @brief Implementation of frame-time profiling.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>    // bool
+#include <stdio.h>      // FILE, fopen, fprintf
+#include <time.h>       // clock_gettime
+
+// This project
+#include "debug.h"      // eprintf
+#include "profile.h"    // PROFILE_ZONE
+
+/**********************************************************//**
+ * @struct ZONE
+ * @brief One timed zone.
+ **************************************************************/
+typedef struct {
+    const char *name;   ///< Name of the zone.
+    double start;       ///< Start time in seconds.
+    double end;         ///< End time, or negative while open.
+} ZONE;
+
+//**************************************************************
+/// Recent zones, used as a ring buffer.
+static ZONE GlobalZones[PROFILE_MAX_ZONES];
+
+/// Number of zones ever started.
+static unsigned GlobalZoneCount = 0;
+
+/// Recent frame times, used as a ring buffer.
+static float GlobalFrameTimes[PROFILE_HISTORY];
+
+/// Number of frames ever started.
+static unsigned GlobalFrameCount = 0;
+
+/// Zone of the frame in progress.
+static int GlobalFrameZone = -1;
+
+/// Time the first zone started.
+static double GlobalEpoch = -1.0;
+
+/**********************************************************//**
+ * @brief Gets a monotonic time stamp.
+ * @return The time in seconds.
+ **************************************************************/
+static double Now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec*1.0e-9;
+}
+
+/*============================================================*
+ * Frames
+ *============================================================*/
+void profile_BeginFrame(void) {
+    // Close the last frame and record how long it took
+    if (GlobalFrameZone >= 0) {
+        profile_EndZone(GlobalFrameZone);
+        const ZONE *last = &GlobalZones[(unsigned)GlobalFrameZone % PROFILE_MAX_ZONES];
+        GlobalFrameTimes[GlobalFrameCount % PROFILE_HISTORY] = last->end - last->start;
+        GlobalFrameCount++;
+    }
+    GlobalFrameZone = profile_BeginZone("frame");
+}
+
+float profile_GetFrameTime(int index) {
+    if (index < 0 || index >= PROFILE_HISTORY || (unsigned)index >= GlobalFrameCount) {
+        return 0.0;
+    }
+    return GlobalFrameTimes[(GlobalFrameCount - 1 - index) % PROFILE_HISTORY];
+}
+
+/*============================================================*
+ * Zones
+ *============================================================*/
+int profile_BeginZone(const char *name) {
+    double now = Now();
+    if (GlobalEpoch < 0.0) {
+        GlobalEpoch = now;
+    }
+    unsigned handle = GlobalZoneCount++;
+    ZONE *zone = &GlobalZones[handle % PROFILE_MAX_ZONES];
+    zone->name = name;
+    zone->start = now;
+    zone->end = -1.0;
+    return (int)(handle & 0x7FFFFFFF);
+}
+
+void profile_EndZone(int handle) {
+    // The zone may have been overwritten by newer ones
+    unsigned age = (GlobalZoneCount - (unsigned)handle) & 0x7FFFFFFF;
+    if (handle < 0 || age == 0 || age > PROFILE_MAX_ZONES) {
+        return;
+    }
+    GlobalZones[(unsigned)handle % PROFILE_MAX_ZONES].end = Now();
+}
+
+/*============================================================*
+ * Trace export
+ *============================================================*/
+bool profile_WriteTrace(const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        eprintf("Failed to open %s\n", filename);
+        return false;
+    }
+    
+    // Oldest to newest complete zones, in microseconds
+    unsigned count = GlobalZoneCount < PROFILE_MAX_ZONES? GlobalZoneCount: PROFILE_MAX_ZONES;
+    bool first = true;
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (unsigned i = GlobalZoneCount - count; i != GlobalZoneCount; i++) {
+        const ZONE *zone = &GlobalZones[i % PROFILE_MAX_ZONES];
+        if (zone->end < 0.0) {
+            continue;
+        }
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+            first? "": ",\n",
+            zone->name,
+            (zone->start - GlobalEpoch)*1.0e6,
+            (zone->end - zone->start)*1.0e6);
+        first = false;
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(file);
+    return true;
+}
+
+/*============================================================*/
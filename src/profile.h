@@ -0,0 +1,78 @@
+/**********************************************************//**
+ * @file profile.h
+ * @brief Header file for frame-time profiling. Zones are only
+ * recorded when PROFILE is defined; otherwise the macros
+ * compile to nothing.
+ **************************************************************/
+
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+
+//**************************************************************
+/// Number of recent frames whose times are kept.
+#define PROFILE_HISTORY 240
+
+/// Number of recent zones kept for trace export.
+#define PROFILE_MAX_ZONES 16384
+
+/**********************************************************//**
+ * @brief Marks the start of a frame.
+ **************************************************************/
+extern void profile_BeginFrame(void);
+
+/**********************************************************//**
+ * @brief Starts timing a zone. Zones may nest.
+ * @param name: Name of the zone. This must be a string that
+ * outlives the profiler, such as a literal.
+ * @return Handle to pass to profile_EndZone.
+ **************************************************************/
+extern int profile_BeginZone(const char *name);
+
+/**********************************************************//**
+ * @brief Stops timing a zone.
+ * @param zone: Handle from profile_BeginZone.
+ **************************************************************/
+extern void profile_EndZone(int zone);
+
+/**********************************************************//**
+ * @brief Gets the time between recent frames.
+ * @param index: 0 for the latest frame, up to
+ * PROFILE_HISTORY-1 for the oldest.
+ * @return The frame time in seconds, or 0.0 if there was no
+ * such frame.
+ **************************************************************/
+extern float profile_GetFrameTime(int index);
+
+/**********************************************************//**
+ * @brief Writes the recent zones as a Chrome trace, which can
+ * be opened in chrome://tracing or Perfetto.
+ * @param filename: The file to write.
+ * @return Whether the file was written.
+ **************************************************************/
+extern bool profile_WriteTrace(const char *filename);
+
+/**********************************************************//**
+ * @brief Ends a zone when its scope exits.
+ * @param zone: The zone handle.
+ **************************************************************/
+static inline void profile_EndScope(int *zone) {
+    profile_EndZone(*zone);
+}
+
+#ifdef PROFILE
+/// Times the rest of the enclosing scope as a zone.
+#define PROFILE_ZONE(name) \
+    int _profileZone __attribute__((cleanup(profile_EndScope))) = profile_BeginZone(name)
+
+/// Marks the start of a frame.
+#define PROFILE_FRAME() profile_BeginFrame()
+#else
+#define PROFILE_ZONE(name) do {} while (0)
+#define PROFILE_FRAME() do {} while (0)
+#endif
+
+/*============================================================*/
+#endif // _PROFILE_H_
@@ -0,0 +1,52 @@
+/**********************************************************//**
+ * @file profile_frame.c
+ * @brief Implementation of the frame-time graph.
+ **************************************************************/
+
+// Allegro
+#include <allegro5/allegro.h>
+
+// This project
+#include "profile.h"        // profile_GetFrameTime
+#include "profile_frame.h"  // PROFILE_GRAPH_WIDTH
+#include "atlas.h"          // atlas_DrawRectangle
+
+//**************************************************************
+/// Length of one frame at 60 FPS, in seconds.
+#define TARGET_TIME (1.0/60.0)
+
+/// Frame time at the top of the graph.
+#define GRAPH_TIME (2*TARGET_TIME)
+
+/*============================================================*
+ * Drawing the graph
+ *============================================================*/
+void profileFrame_Draw(int x, int y) {
+    // Background
+    int bottom = y + PROFILE_GRAPH_HEIGHT;
+    atlas_DrawRectangle(x, y, x + PROFILE_GRAPH_WIDTH, bottom, al_map_rgba(0, 0, 0, 192));
+    
+    // One bar per frame, colored by how late it was
+    ALLEGRO_COLOR good = al_map_rgb(64, 192, 64);
+    ALLEGRO_COLOR late = al_map_rgb(224, 192, 64);
+    ALLEGRO_COLOR slow = al_map_rgb(224, 64, 64);
+    for (int i = 0; i < PROFILE_HISTORY; i++) {
+        float time = profile_GetFrameTime(i);
+        if (time <= 0.0) {
+            break;
+        }
+        float height = time / GRAPH_TIME * PROFILE_GRAPH_HEIGHT;
+        if (height > PROFILE_GRAPH_HEIGHT) {
+            height = PROFILE_GRAPH_HEIGHT;
+        }
+        ALLEGRO_COLOR color = time <= 1.1*TARGET_TIME? good: time <= 2*TARGET_TIME? late: slow;
+        int left = x + PROFILE_GRAPH_WIDTH - 1 - i;
+        atlas_DrawRectangle(left, bottom - height, left + 1, bottom, color);
+    }
+    
+    // One frame at the target rate
+    int line = bottom - TARGET_TIME / GRAPH_TIME * PROFILE_GRAPH_HEIGHT;
+    atlas_DrawRectangle(x, line, x + PROFILE_GRAPH_WIDTH, line + 1, al_map_rgb(255, 255, 255));
+}
+
+/*============================================================*/
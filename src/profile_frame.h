@@ -0,0 +1,29 @@
+/**********************************************************//**
+ * @file profile_frame.h
+ * @brief Header file for drawing the frame-time graph.
+ **************************************************************/
+
+#ifndef _PROFILE_FRAME_H_
+#define _PROFILE_FRAME_H_
+
+// This project
+#include "profile.h"    // PROFILE_HISTORY
+
+//**************************************************************
+/// Width of the frame-time graph, one pixel per frame.
+#define PROFILE_GRAPH_WIDTH PROFILE_HISTORY
+
+/// Height of the frame-time graph.
+#define PROFILE_GRAPH_HEIGHT 64
+
+/**********************************************************//**
+ * @brief Draws the time of recent frames as a rolling bar
+ * graph, newest on the right. The top of the graph is two
+ * frames at 60 FPS, and a line marks one frame.
+ * @param x: Left edge of the graph.
+ * @param y: Top edge of the graph.
+ **************************************************************/
+extern void profileFrame_Draw(int x, int y);
+
+/*============================================================*/
+#endif // _PROFILE_FRAME_H_
@@ -0,0 +1,194 @@
+/**********************************************************//**
+ * @file rcu.c
+ * @brief Implementation of read-copy-update with per-thread
+ * epochs.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>        // bool
+#include <stddef.h>         // NULL
+#include <sched.h>          // sched_yield
+#include <pthread.h>        // pthread_key_create, pthread_mutex_lock
+
+// This project
+#include "debug.h"          // assert, eprintf
+#include "rcu.h"            // RCU_MAX_READERS
+
+/**********************************************************//**
+ * @struct RCU_READER
+ * @brief The epoch one thread entered its read-side section
+ * in, padded to a cache line so readers never share one.
+ **************************************************************/
+typedef struct {
+    unsigned long epoch;    ///< Epoch when the section began, or 0.
+    bool used;              ///< Whether a thread owns the slot.
+} __attribute__((aligned(64))) RCU_READER;
+
+//**************************************************************
+/// Sections a thread without a slot runs before trying to get
+/// one again, as slots free up when their threads exit.
+#define RCU_RETRY 256
+
+/// Current epoch, bumped by every synchronize. Never 0.
+static unsigned long GlobalEpoch = 1;
+
+/// Reader slots.
+static RCU_READER GlobalReaders[RCU_MAX_READERS];
+
+/// Readers inside a section that didn't get a slot, by the
+/// parity of the epoch they began in.
+static unsigned long GlobalOverflow[2] = {0, 0};
+
+/// Lets one writer wait at a time, so each only has to wait
+/// for the epoch it bumped.
+static pthread_mutex_t GlobalWriter = PTHREAD_MUTEX_INITIALIZER;
+
+/// Frees the slot of each thread when it exits.
+static pthread_key_t GlobalReaderKey;
+
+/// Creates GlobalReaderKey once.
+static pthread_once_t GlobalReaderKeyOnce = PTHREAD_ONCE_INIT;
+
+/// Slot of this thread, or NULL if it has none yet.
+static __thread RCU_READER *LocalReader = NULL;
+
+/// Sections left before this thread looks for a slot again.
+static __thread int LocalRetry = 0;
+
+/// Parity of the overflow count this thread's section is in.
+static __thread int LocalParity = 0;
+
+/// Depth of nested sections on this thread.
+static __thread int LocalDepth = 0;
+
+/**********************************************************//**
+ * @brief Gives a reader slot back when its thread exits.
+ * @param data: The slot.
+ **************************************************************/
+static void Release(void *data) {
+    RCU_READER *reader = data;
+    __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&reader->used, false, __ATOMIC_RELEASE);
+}
+
+/**********************************************************//**
+ * @brief Creates the key that frees slots at thread exit.
+ **************************************************************/
+static void CreateKey(void) {
+    if (pthread_key_create(&GlobalReaderKey, Release)) {
+        eprintf("Failed to create the RCU reader key.\n");
+    }
+}
+
+/**********************************************************//**
+ * @brief Claims a reader slot for this thread, which is given
+ * back automatically when the thread exits.
+ * @return Whether a slot was free.
+ **************************************************************/
+static bool Register(void) {
+    pthread_once(&GlobalReaderKeyOnce, CreateKey);
+    for (int i = 0; i < RCU_MAX_READERS; i++) {
+        bool expected = false;
+        if (__atomic_compare_exchange_n(&GlobalReaders[i].used, &expected, true, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            if (pthread_setspecific(GlobalReaderKey, &GlobalReaders[i])) {
+                // Without the key the slot would never come back
+                __atomic_store_n(&GlobalReaders[i].used, false, __ATOMIC_RELEASE);
+                break;
+            }
+            LocalReader = &GlobalReaders[i];
+            return true;
+        }
+    }
+    LocalRetry = RCU_RETRY;
+    return false;
+}
+
+/*============================================================*
+ * Read-side sections
+ *============================================================*/
+void rcu_ReadLock(void) {
+    if (LocalDepth++ > 0) {
+        return;
+    }
+    if (!LocalReader && (LocalRetry-- > 0 || !Register())) {
+        // Count the section under the parity of its epoch, and
+        // make sure the epoch didn't move before it was counted,
+        // so a writer only waits for sections older than its bump
+        while (true) {
+            unsigned long epoch = __atomic_load_n(&GlobalEpoch, __ATOMIC_ACQUIRE);
+            LocalParity = epoch & 1;
+            __atomic_add_fetch(&GlobalOverflow[LocalParity], 1, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&GlobalEpoch, __ATOMIC_SEQ_CST) == epoch) {
+                return;
+            }
+            __atomic_sub_fetch(&GlobalOverflow[LocalParity], 1, __ATOMIC_RELEASE);
+        }
+    }
+    
+    // Announce the epoch before loading any shared pointer. The
+    // acquire pairs with the bump in rcu_Synchronize, so a reader
+    // in the new epoch sees everything unpublished before it.
+    unsigned long epoch = __atomic_load_n(&GlobalEpoch, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&LocalReader->epoch, epoch, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void rcu_ReadUnlock(void) {
+    assert(LocalDepth > 0);
+    if (--LocalDepth > 0) {
+        return;
+    }
+    if (!LocalReader) {
+        __atomic_sub_fetch(&GlobalOverflow[LocalParity], 1, __ATOMIC_RELEASE);
+        return;
+    }
+    __atomic_store_n(&LocalReader->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/*============================================================*
+ * Waiting for readers
+ *============================================================*/
+void rcu_Synchronize(void) {
+    assert(LocalDepth == 0);
+    pthread_mutex_lock(&GlobalWriter);
+    
+    // Readers that announce after this fence see the new data
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    unsigned long epoch = __atomic_add_fetch(&GlobalEpoch, 1, __ATOMIC_SEQ_CST);
+    
+    // Wait out every section that began in an older epoch
+    for (int i = 0; i < RCU_MAX_READERS; i++) {
+        const RCU_READER *reader = &GlobalReaders[i];
+        while (true) {
+            unsigned long seen = __atomic_load_n(&reader->epoch, __ATOMIC_ACQUIRE);
+            if (seen == 0 || seen >= epoch) {
+                break;
+            }
+            sched_yield();
+        }
+    }
+    
+    // Sections without a slot that began before the bump are
+    // counted under the old epoch's parity. Newer ones count
+    // under the other, so they can't hold this up.
+    const unsigned long *overflow = &GlobalOverflow[(epoch - 1) & 1];
+    while (__atomic_load_n(overflow, __ATOMIC_ACQUIRE) != 0) {
+        sched_yield();
+    }
+    pthread_mutex_unlock(&GlobalWriter);
+}
+
+/*============================================================*
+ * Thread exit
+ *============================================================*/
+void rcu_ForgetThread(void) {
+    assert(LocalDepth == 0);
+    if (LocalReader) {
+        pthread_setspecific(GlobalReaderKey, NULL);
+        Release(LocalReader);
+        LocalReader = NULL;
+    }
+    LocalRetry = 0;
+}
+
+/*============================================================*/
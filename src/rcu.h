@@ -0,0 +1,47 @@
+/**********************************************************//**
+ * @file rcu.h
+ * @brief Header file for read-copy-update. Readers mark the
+ * code that uses shared data without ever blocking, and a
+ * writer that has swapped the data out waits for every reader
+ * that might still see the old copy before freeing it.
+ **************************************************************/
+
+#ifndef _RCU_H_
+#define _RCU_H_
+
+//**************************************************************
+/// Number of threads that get their own reader slot. Threads
+/// past this share a counter, which still works but contends.
+/// Slots are given back when their threads exit.
+#define RCU_MAX_READERS 64
+
+/**********************************************************//**
+ * @brief Starts a read-side section on this thread. Shared
+ * pointers loaded until rcu_ReadUnlock stay valid. Sections
+ * nest, and this never blocks.
+ **************************************************************/
+extern void rcu_ReadLock(void);
+
+/**********************************************************//**
+ * @brief Ends the read-side section started by rcu_ReadLock.
+ **************************************************************/
+extern void rcu_ReadUnlock(void);
+
+/**********************************************************//**
+ * @brief Waits until every read-side section that started
+ * before this call has ended. Call this after unpublishing
+ * data and before freeing it. It must not be called inside a
+ * read-side section.
+ **************************************************************/
+extern void rcu_Synchronize(void);
+
+/**********************************************************//**
+ * @brief Gives this thread's reader slot back early. Slots
+ * are given back when their threads exit anyway, so this is
+ * only needed by a thread that stops reading but keeps
+ * running.
+ **************************************************************/
+extern void rcu_ForgetThread(void);
+
+/*============================================================*/
+#endif // _RCU_H_
@@ -0,0 +1,166 @@
+/**********************************************************//**
+ * @file redraw.c
+ * @brief Implementation of screen damage tracking.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>        // bool
+#include <stddef.h>         // NULL
+
+// Allegro
+#include <allegro5/allegro.h>
+
+// This project
+#include "debug.h"          // assert, eprintf
+#include "redraw.h"         // redraw_Invalidate
+
+/**********************************************************//**
+ * @struct DAMAGE
+ * @brief Stores the bounding box of everything that changed
+ * since the last redraw.
+ **************************************************************/
+typedef struct {
+    int x1;         ///< Left edge of the damage.
+    int y1;         ///< Top edge of the damage.
+    int x2;         ///< Right edge of the damage.
+    int y2;         ///< Bottom edge of the damage.
+    bool dirty;     ///< Whether anything is damaged.
+} DAMAGE;
+
+/// Canvas holding the last rendered frame.
+static ALLEGRO_BITMAP *GlobalCanvas;
+
+/// Size of the screen.
+static int GlobalWidth, GlobalHeight;
+
+/// Damage since the last redraw. Everything starts damaged.
+static DAMAGE GlobalDamage = {0, 0, 0, 0, true};
+
+/// Damage made by the latest simulation steps.
+static DAMAGE GlobalStepDamage = {0, 0, 0, 0, false};
+
+/// State saved while drawing into the canvas.
+static ALLEGRO_STATE GlobalState;
+
+/*============================================================*
+ * Creating the canvas
+ *============================================================*/
+bool redraw_Initialize(int width, int height) {
+    GlobalWidth = width;
+    GlobalHeight = height;
+    GlobalCanvas = al_create_bitmap(width, height);
+    if (!GlobalCanvas) {
+        eprintf("Failed to create the redraw canvas.\n");
+    }
+    redraw_InvalidateAll();
+    return GlobalCanvas != NULL;
+}
+
+void redraw_Destroy(void) {
+    if (GlobalCanvas) {
+        al_destroy_bitmap(GlobalCanvas);
+        GlobalCanvas = NULL;
+    }
+}
+
+/**********************************************************//**
+ * @brief Grows damage to cover an area.
+ * @param damage: The damage to grow.
+ * @param area: The area to cover.
+ **************************************************************/
+static void Extend(DAMAGE *damage, const DAMAGE *area) {
+    if (!area->dirty) {
+        return;
+    }
+    if (!damage->dirty) {
+        *damage = *area;
+        return;
+    }
+    if (area->x1 < damage->x1) {
+        damage->x1 = area->x1;
+    }
+    if (area->y1 < damage->y1) {
+        damage->y1 = area->y1;
+    }
+    if (area->x2 > damage->x2) {
+        damage->x2 = area->x2;
+    }
+    if (area->y2 > damage->y2) {
+        damage->y2 = area->y2;
+    }
+}
+
+/*============================================================*
+ * Tracking damage
+ *============================================================*/
+void redraw_Invalidate(int x, int y, int width, int height) {
+    // Clip to the screen
+    int x1 = x < 0? 0: x;
+    int y1 = y < 0? 0: y;
+    int x2 = x + width > GlobalWidth? GlobalWidth: x + width;
+    int y2 = y + height > GlobalHeight? GlobalHeight: y + height;
+    if (x1 >= x2 || y1 >= y2) {
+        return;
+    }
+    
+    // Grow the bounding boxes
+    DAMAGE area = {x1, y1, x2, y2, true};
+    Extend(&GlobalDamage, &area);
+    Extend(&GlobalStepDamage, &area);
+}
+
+void redraw_InvalidateAll(void) {
+    GlobalDamage = (DAMAGE){0, 0, GlobalWidth, GlobalHeight, true};
+}
+
+bool redraw_IsNeeded(void) {
+    return GlobalDamage.dirty;
+}
+
+/*============================================================*
+ * Damage between simulation steps
+ *============================================================*/
+void redraw_BeginStep(void) {
+    GlobalStepDamage.dirty = false;
+}
+
+void redraw_RepeatStep(void) {
+    Extend(&GlobalDamage, &GlobalStepDamage);
+}
+
+/*============================================================*
+ * Drawing the damage
+ *============================================================*/
+void redraw_Begin(ALLEGRO_COLOR background) {
+    // Without a canvas the back buffer is redrawn in full
+    if (!GlobalCanvas) {
+        al_clear_to_color(background);
+        return;
+    }
+    
+    // Only touch the damaged part of the canvas
+    al_store_state(&GlobalState, ALLEGRO_STATE_TARGET_BITMAP);
+    al_set_target_bitmap(GlobalCanvas);
+    al_set_clipping_rectangle(
+        GlobalDamage.x1,
+        GlobalDamage.y1,
+        GlobalDamage.x2 - GlobalDamage.x1,
+        GlobalDamage.y2 - GlobalDamage.y1
+    );
+    al_clear_to_color(background);
+}
+
+void redraw_End(void) {
+    GlobalDamage.dirty = false;
+    if (!GlobalCanvas) {
+        return;
+    }
+    
+    // Present the whole canvas, since the back buffer's
+    // contents are undefined after a flip.
+    al_reset_clipping_rectangle();
+    al_restore_state(&GlobalState);
+    al_draw_bitmap(GlobalCanvas, 0, 0, 0);
+}
+
+/*============================================================*/
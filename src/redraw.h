@@ -0,0 +1,79 @@
+/**********************************************************//**
+ * @file redraw.h
+ * @brief Header file for tracking which parts of the screen
+ * need to be redrawn.
+ **************************************************************/
+
+#ifndef _REDRAW_H_
+#define _REDRAW_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+
+// Allegro
+#include <allegro5/allegro.h>
+
+/**********************************************************//**
+ * @brief Creates the canvas that keeps the last rendered frame,
+ * so only damaged areas need to be drawn again. This must be
+ * called after the display is created.
+ * @param width: Width of the screen.
+ * @param height: Height of the screen.
+ * @return Whether the canvas was created. Without the canvas,
+ * damaged frames are redrawn in full.
+ **************************************************************/
+extern bool redraw_Initialize(int width, int height);
+
+/**********************************************************//**
+ * @brief Destroys the canvas.
+ **************************************************************/
+extern void redraw_Destroy(void);
+
+/**********************************************************//**
+ * @brief Marks an area of the screen as changed.
+ * @param x: The x position of the area.
+ * @param y: The y position of the area.
+ * @param width: Width of the area.
+ * @param height: Height of the area.
+ **************************************************************/
+extern void redraw_Invalidate(int x, int y, int width, int height);
+
+/**********************************************************//**
+ * @brief Marks the whole screen as changed.
+ **************************************************************/
+extern void redraw_InvalidateAll(void);
+
+/**********************************************************//**
+ * @brief Checks if anything on the screen changed.
+ * @return Whether the screen needs to be redrawn.
+ **************************************************************/
+extern bool redraw_IsNeeded(void);
+
+/**********************************************************//**
+ * @brief Starts recording the damage made by a new batch of
+ * simulation steps.
+ **************************************************************/
+extern void redraw_BeginStep(void);
+
+/**********************************************************//**
+ * @brief Marks the damage of the latest simulation steps again.
+ * Call this when the screen is drawn between the same two steps
+ * as before, so that moving things are blended further along.
+ **************************************************************/
+extern void redraw_RepeatStep(void);
+
+/**********************************************************//**
+ * @brief Starts drawing the damaged part of the screen. Drawing
+ * is clipped to the damage, which is cleared to the background.
+ * @param background: The color to clear the damage to.
+ **************************************************************/
+extern void redraw_Begin(ALLEGRO_COLOR background);
+
+/**********************************************************//**
+ * @brief Finishes drawing, copies the canvas to the display's
+ * back buffer, and forgets the damage. The caller flips.
+ **************************************************************/
+extern void redraw_End(void);
+
+/*============================================================*/
+#endif // _REDRAW_H_
@@ -0,0 +1,208 @@
+/**********************************************************//**
+ * @file render.c
+ * @brief Implementation of the rendering backends.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>        // bool
+#include <stddef.h>         // NULL
+
+// Allegro
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_primitives.h>
+
+// This project
+#include "debug.h"          // assert, eprintf
+#include "render.h"         // RENDER_BACKEND
+
+/**********************************************************//**
+ * @struct RENDER_FUNCTIONS
+ * @brief Drawing functions of one backend. A NULL function
+ * drops the request.
+ **************************************************************/
+typedef struct {
+    void (*drawBitmap)(ALLEGRO_BITMAP *, ALLEGRO_COLOR, float, float);
+    void (*drawBitmapRegion)(ALLEGRO_BITMAP *, float, float, float, float, float, float);
+    void (*drawScaledBitmap)(ALLEGRO_BITMAP *, ALLEGRO_COLOR, float, float, float, float, float, float, float, float);
+    void (*drawRectangle)(float, float, float, float, ALLEGRO_COLOR);
+    void (*drawText)(const ALLEGRO_FONT *, ALLEGRO_COLOR, float, float, int, const char *);
+    void (*drawTransformedText)(const ALLEGRO_FONT *, ALLEGRO_COLOR, const ALLEGRO_TRANSFORM *, const char *);
+    void (*drawTriangles)(const ALLEGRO_VERTEX *, int, ALLEGRO_BITMAP *);
+    void (*holdDrawing)(bool);
+} RENDER_FUNCTIONS;
+
+/*============================================================*
+ * Allegro backend
+ *============================================================*/
+static void AllegroDrawBitmap(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR tint, float x, float y) {
+    al_draw_tinted_bitmap(bitmap, tint, x, y, 0);
+}
+
+static void AllegroDrawBitmapRegion(ALLEGRO_BITMAP *bitmap, float sx, float sy, float sw, float sh, float x, float y) {
+    al_draw_bitmap_region(bitmap, sx, sy, sw, sh, x, y, 0);
+}
+
+static void AllegroDrawScaledBitmap(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR tint, float sx, float sy, float sw, float sh, float dx, float dy, float dw, float dh) {
+    al_draw_tinted_scaled_bitmap(bitmap, tint, sx, sy, sw, sh, dx, dy, dw, dh, 0);
+}
+
+static void AllegroDrawRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color) {
+    al_draw_filled_rectangle(x1, y1, x2, y2, color);
+}
+
+static void AllegroDrawText(const ALLEGRO_FONT *font, ALLEGRO_COLOR color, float x, float y, int flags, const char *text) {
+    al_draw_text(font, color, x, y, flags, text);
+}
+
+static void AllegroDrawTransformedText(const ALLEGRO_FONT *font, ALLEGRO_COLOR color, const ALLEGRO_TRANSFORM *transform, const char *text) {
+    // Apply the placement on top of the current transform
+    ALLEGRO_TRANSFORM old;
+    ALLEGRO_TRANSFORM combined;
+    al_copy_transform(&old, al_get_current_transform());
+    al_copy_transform(&combined, transform);
+    al_compose_transform(&combined, &old);
+    
+    // Draw with this transform, then restore the old one
+    al_use_transform(&combined);
+    al_draw_text(font, color, 0, 0, ALLEGRO_ALIGN_LEFT, text);
+    al_use_transform(&old);
+}
+
+static void AllegroDrawTriangles(const ALLEGRO_VERTEX *vertices, int count, ALLEGRO_BITMAP *texture) {
+    al_draw_prim(vertices, NULL, texture, 0, count, ALLEGRO_PRIM_TRIANGLE_LIST);
+}
+
+/// Functions that draw with Allegro.
+static const RENDER_FUNCTIONS AllegroFunctions = {
+    .drawBitmap = AllegroDrawBitmap,
+    .drawBitmapRegion = AllegroDrawBitmapRegion,
+    .drawScaledBitmap = AllegroDrawScaledBitmap,
+    .drawRectangle = AllegroDrawRectangle,
+    .drawText = AllegroDrawText,
+    .drawTransformedText = AllegroDrawTransformedText,
+    .drawTriangles = AllegroDrawTriangles,
+    .holdDrawing = al_hold_bitmap_drawing,
+};
+
+/*============================================================*
+ * Null backend
+ *============================================================*/
+/// Functions that drop every request, all left NULL.
+static const RENDER_FUNCTIONS NullFunctions;
+
+//**************************************************************
+/// Backend in use.
+static RENDER_BACKEND GlobalBackend = RENDER_BACKEND_ALLEGRO;
+
+/// Functions of the backend in use.
+static const RENDER_FUNCTIONS *GlobalFunctions = &AllegroFunctions;
+
+/// Requests made since the last reset.
+static RENDER_STATS GlobalStats;
+
+/*============================================================*
+ * Selecting the backend
+ *============================================================*/
+void render_SetBackend(RENDER_BACKEND backend) {
+    switch (backend) {
+    case RENDER_BACKEND_ALLEGRO:
+        GlobalFunctions = &AllegroFunctions;
+        break;
+    case RENDER_BACKEND_NULL:
+        GlobalFunctions = &NullFunctions;
+        break;
+    default:
+        eprintf("Invalid render backend: %d\n", backend);
+        return;
+    }
+    GlobalBackend = backend;
+}
+
+RENDER_BACKEND render_GetBackend(void) {
+    return GlobalBackend;
+}
+
+/*============================================================*
+ * Recording requests
+ *============================================================*/
+void render_GetStats(RENDER_STATS *stats) {
+    *stats = GlobalStats;
+}
+
+void render_ResetStats(void) {
+    GlobalStats = (RENDER_STATS){0, 0, 0, 0, 0, 0};
+}
+
+/*============================================================*
+ * Drawing bitmaps
+ *============================================================*/
+void render_DrawBitmap(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR tint, float x, float y) {
+    GlobalStats.bitmaps++;
+    if (GlobalFunctions->drawBitmap) {
+        GlobalFunctions->drawBitmap(bitmap, tint, x, y);
+    }
+}
+
+void render_DrawBitmapRegion(ALLEGRO_BITMAP *bitmap, float sx, float sy, float sw, float sh, float x, float y) {
+    GlobalStats.bitmaps++;
+    if (GlobalFunctions->drawBitmapRegion) {
+        GlobalFunctions->drawBitmapRegion(bitmap, sx, sy, sw, sh, x, y);
+    }
+}
+
+void render_DrawScaledBitmap(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR tint, float sx, float sy, float sw, float sh, float dx, float dy, float dw, float dh) {
+    GlobalStats.bitmaps++;
+    if (GlobalFunctions->drawScaledBitmap) {
+        GlobalFunctions->drawScaledBitmap(bitmap, tint, sx, sy, sw, sh, dx, dy, dw, dh);
+    }
+}
+
+/*============================================================*
+ * Drawing shapes
+ *============================================================*/
+void render_DrawRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color) {
+    GlobalStats.rectangles++;
+    if (GlobalFunctions->drawRectangle) {
+        GlobalFunctions->drawRectangle(x1, y1, x2, y2, color);
+    }
+}
+
+void render_DrawTriangles(const ALLEGRO_VERTEX *vertices, int count, ALLEGRO_BITMAP *texture) {
+    GlobalStats.primitives++;
+    GlobalStats.vertices += count;
+    if (GlobalFunctions->drawTriangles) {
+        GlobalFunctions->drawTriangles(vertices, count, texture);
+    }
+}
+
+/*============================================================*
+ * Drawing text
+ *============================================================*/
+void render_DrawText(const ALLEGRO_FONT *font, ALLEGRO_COLOR color, float x, float y, int flags, const char *text) {
+    GlobalStats.texts++;
+    if (GlobalFunctions->drawText) {
+        GlobalFunctions->drawText(font, color, x, y, flags, text);
+    }
+}
+
+void render_DrawTransformedText(const ALLEGRO_FONT *font, ALLEGRO_COLOR color, const ALLEGRO_TRANSFORM *transform, const char *text) {
+    GlobalStats.texts++;
+    if (GlobalFunctions->drawTransformedText) {
+        GlobalFunctions->drawTransformedText(font, color, transform, text);
+    }
+}
+
+/*============================================================*
+ * Batching
+ *============================================================*/
+void render_HoldDrawing(bool hold) {
+    if (hold) {
+        GlobalStats.batches++;
+    }
+    if (GlobalFunctions->holdDrawing) {
+        GlobalFunctions->holdDrawing(hold);
+    }
+}
+
+/*============================================================*/
@@ -0,0 +1,149 @@
+/**********************************************************//**
+ * @file render.h
+ * @brief Header file for the rendering backend that all
+ * drawing on the screen goes through.
+ **************************************************************/
+
+#ifndef _RENDER_H_
+#define _RENDER_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+
+// Allegro
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_primitives.h>
+
+/**********************************************************//**
+ * @enum RENDER_BACKEND
+ * @brief Where drawing requests end up.
+ **************************************************************/
+typedef enum {
+    RENDER_BACKEND_ALLEGRO, ///< Draw to the target bitmap.
+    RENDER_BACKEND_NULL,    ///< Only record the requests.
+} RENDER_BACKEND;
+
+/**********************************************************//**
+ * @struct RENDER_STATS
+ * @brief Counts of the drawing requests made since the last
+ * reset. These are recorded with every backend.
+ **************************************************************/
+typedef struct {
+    int bitmaps;        ///< Bitmaps and bitmap regions drawn.
+    int rectangles;     ///< Filled rectangles drawn.
+    int texts;          ///< Strings drawn with a font.
+    int primitives;     ///< Triangle lists drawn.
+    int vertices;       ///< Vertices in all triangle lists.
+    int batches;        ///< Times bitmap drawing was held.
+} RENDER_STATS;
+
+/**********************************************************//**
+ * @brief Selects where drawing requests go. The null backend
+ * needs no display, so rendering code can be run and measured
+ * headless.
+ * @param backend: The backend to use.
+ **************************************************************/
+extern void render_SetBackend(RENDER_BACKEND backend);
+
+/**********************************************************//**
+ * @brief Gets the backend in use.
+ * @return The current backend.
+ **************************************************************/
+extern RENDER_BACKEND render_GetBackend(void);
+
+/**********************************************************//**
+ * @brief Gets the drawing requests made since the last reset.
+ * @param stats: Output counts.
+ **************************************************************/
+extern void render_GetStats(RENDER_STATS *stats);
+
+/**********************************************************//**
+ * @brief Sets all the drawing request counts to zero.
+ **************************************************************/
+extern void render_ResetStats(void);
+
+/**********************************************************//**
+ * @brief Draws a tinted bitmap.
+ * @param bitmap: The bitmap to draw.
+ * @param tint: Color multiplied with the bitmap.
+ * @param x: Left edge on the target.
+ * @param y: Top edge on the target.
+ **************************************************************/
+extern void render_DrawBitmap(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR tint, float x, float y);
+
+/**********************************************************//**
+ * @brief Draws part of a bitmap.
+ * @param bitmap: The bitmap to draw from.
+ * @param sx: Left edge of the region.
+ * @param sy: Top edge of the region.
+ * @param sw: Width of the region.
+ * @param sh: Height of the region.
+ * @param x: Left edge on the target.
+ * @param y: Top edge on the target.
+ **************************************************************/
+extern void render_DrawBitmapRegion(ALLEGRO_BITMAP *bitmap, float sx, float sy, float sw, float sh, float x, float y);
+
+/**********************************************************//**
+ * @brief Draws part of a bitmap tinted and stretched.
+ * @param bitmap: The bitmap to draw from.
+ * @param tint: Color multiplied with the bitmap.
+ * @param sx: Left edge of the region.
+ * @param sy: Top edge of the region.
+ * @param sw: Width of the region.
+ * @param sh: Height of the region.
+ * @param dx: Left edge on the target.
+ * @param dy: Top edge on the target.
+ * @param dw: Width on the target.
+ * @param dh: Height on the target.
+ **************************************************************/
+extern void render_DrawScaledBitmap(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR tint, float sx, float sy, float sw, float sh, float dx, float dy, float dw, float dh);
+
+/**********************************************************//**
+ * @brief Draws a filled rectangle.
+ * @param x1: Left edge.
+ * @param y1: Top edge.
+ * @param x2: Right edge.
+ * @param y2: Bottom edge.
+ * @param color: Fill color.
+ **************************************************************/
+extern void render_DrawRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color);
+
+/**********************************************************//**
+ * @brief Draws a string with a font.
+ * @param font: The font to use.
+ * @param color: Color of the text.
+ * @param x: X position of the text.
+ * @param y: Y position of the text.
+ * @param flags: Allegro text alignment flags.
+ * @param text: The text to draw.
+ **************************************************************/
+extern void render_DrawText(const ALLEGRO_FONT *font, ALLEGRO_COLOR color, float x, float y, int flags, const char *text);
+
+/**********************************************************//**
+ * @brief Draws a string with a font at the origin of a
+ * transform, applied on top of the current transform.
+ * @param font: The font to use.
+ * @param color: Color of the text.
+ * @param transform: Placement of the text.
+ * @param text: The text to draw.
+ **************************************************************/
+extern void render_DrawTransformedText(const ALLEGRO_FONT *font, ALLEGRO_COLOR color, const ALLEGRO_TRANSFORM *transform, const char *text);
+
+/**********************************************************//**
+ * @brief Draws a list of textured triangles.
+ * @param vertices: Three vertices per triangle.
+ * @param count: Number of vertices.
+ * @param texture: Texture of the triangles, or NULL.
+ **************************************************************/
+extern void render_DrawTriangles(const ALLEGRO_VERTEX *vertices, int count, ALLEGRO_BITMAP *texture);
+
+/**********************************************************//**
+ * @brief Starts or stops deferring bitmap drawing, so that
+ * bitmaps from one texture go out in a single call.
+ * @param hold: Whether to hold bitmap drawing.
+ **************************************************************/
+extern void render_HoldDrawing(bool hold);
+
+/*============================================================*/
+#endif // _RENDER_H_
@@ -0,0 +1,384 @@
+/**********************************************************//**
+ * @file resource.c
+ * @brief Implementation of the resource cache.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>        // bool
+#include <stddef.h>         // NULL, size_t
+#include <stdio.h>          // FILE, fprintf, fopen
+#include <string.h>         // strcmp, strcpy, strlen
+
+// Allegro
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_ttf.h>
+
+// This project
+#include "debug.h"          // assert, eprintf
+#include "atlas.h"          // atlas_AddBitmap
+#include "resource.h"       // MAX_RESOURCES
+
+/**********************************************************//**
+ * @enum RESOURCE_TYPE
+ * @brief What kind of object a resource holds.
+ **************************************************************/
+typedef enum {
+    RESOURCE_FONT,      ///< An ALLEGRO_FONT owned by the cache.
+    RESOURCE_IMAGE,     ///< A memory bitmap owned by the cache.
+    RESOURCE_BITMAP,    ///< A bitmap owned by the atlas.
+} RESOURCE_TYPE;
+
+/**********************************************************//**
+ * @enum RESOURCE_STATE
+ * @brief How far along a resource is.
+ **************************************************************/
+typedef enum {
+    RESOURCE_EMPTY,     ///< The slot is free.
+    RESOURCE_LOADING,   ///< Some thread is loading it.
+    RESOURCE_READY,     ///< The data can be used.
+    RESOURCE_FAILED,    ///< It could not be loaded.
+} RESOURCE_STATE;
+
+/**********************************************************//**
+ * @struct RESOURCE
+ * @brief One cached font or image.
+ **************************************************************/
+typedef struct {
+    RESOURCE_TYPE type;     ///< Kind of object.
+    RESOURCE_STATE state;   ///< Whether it is loaded.
+    char filename[MAX_RESOURCE_NAME]; ///< File it was loaded from.
+    int size;               ///< Font size, or 0.
+    int flags;              ///< Font flags, or 0.
+    int references;         ///< Number of holders.
+    size_t bytes;           ///< Estimated resident size.
+    void *data;             ///< The loaded object.
+} RESOURCE;
+
+/// Names of the resource types for the memory report.
+static const char *const ResourceTypeNames[] = {
+    [RESOURCE_FONT] = "font",
+    [RESOURCE_IMAGE] = "image",
+    [RESOURCE_BITMAP] = "atlas",
+};
+
+//**************************************************************
+/// Every resource requested so far.
+static RESOURCE GlobalResources[MAX_RESOURCES];
+
+/// Number of slots that have ever been used.
+static int GlobalCount = 0;
+
+/// Guards the cache against the loader threads.
+static ALLEGRO_MUTEX *GlobalMutex;
+
+/// Signaled whenever a resource finishes loading.
+static ALLEGRO_COND *GlobalLoaded;
+
+/**********************************************************//**
+ * @brief Finds a resource, waiting for it if another thread
+ * is loading it, or claims a new slot for the caller to load.
+ * @param type: Kind of object.
+ * @param filename: File to load it from.
+ * @param size: Font size, or 0.
+ * @param flags: Font flags, or 0.
+ * @param claimed: Output parameter for whether the caller
+ * must load the resource and pass it to Finish.
+ * @return The resource, or NULL if it failed to load before or
+ * the cache is full.
+ **************************************************************/
+static RESOURCE *Acquire(RESOURCE_TYPE type, const char *filename, int size, int flags, bool *claimed) {
+    assert(GlobalMutex);
+    *claimed = false;
+    if (strlen(filename) >= MAX_RESOURCE_NAME) {
+        eprintf("Resource name too long: %s\n", filename);
+        return NULL;
+    }
+    al_lock_mutex(GlobalMutex);
+    
+    // Share a resource someone else asked for
+    RESOURCE *empty = NULL;
+    for (int i = 0; i < GlobalCount; i++) {
+        RESOURCE *resource = &GlobalResources[i];
+        if (resource->state == RESOURCE_EMPTY) {
+            empty = empty? empty: resource;
+            continue;
+        }
+        if (resource->type == type && resource->size == size && resource->flags == flags
+                && !strcmp(resource->filename, filename)) {
+            while (resource->state == RESOURCE_LOADING) {
+                al_wait_cond(GlobalLoaded, GlobalMutex);
+            }
+            if (resource->state != RESOURCE_READY) {
+                resource = NULL;
+            } else {
+                resource->references++;
+            }
+            al_unlock_mutex(GlobalMutex);
+            return resource;
+        }
+    }
+    
+    // Claim a slot so other threads wait instead of loading it
+    if (!empty && GlobalCount >= MAX_RESOURCES) {
+        al_unlock_mutex(GlobalMutex);
+        eprintf("Too many resources.\n");
+        return NULL;
+    }
+    RESOURCE *resource = empty? empty: &GlobalResources[GlobalCount++];
+    resource->type = type;
+    resource->state = RESOURCE_LOADING;
+    strcpy(resource->filename, filename);
+    resource->size = size;
+    resource->flags = flags;
+    resource->references = 0;
+    resource->bytes = 0;
+    resource->data = NULL;
+    *claimed = true;
+    al_unlock_mutex(GlobalMutex);
+    return resource;
+}
+
+/**********************************************************//**
+ * @brief Gets the size of a file.
+ * @param filename: The file.
+ * @return Its size in bytes, or 0 if it can't be read.
+ **************************************************************/
+static size_t FileSize(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size > 0? (size_t)size: 0;
+}
+
+/**********************************************************//**
+ * @brief Estimates the memory held by a bitmap.
+ * @param bitmap: The bitmap.
+ * @return Its size in bytes at four bytes per pixel.
+ **************************************************************/
+static size_t BitmapSize(ALLEGRO_BITMAP *bitmap) {
+    return (size_t)al_get_bitmap_width(bitmap) * al_get_bitmap_height(bitmap) * 4;
+}
+
+/**********************************************************//**
+ * @brief Frees the object held by a resource. The cache must
+ * be locked.
+ * @param resource: The resource to empty.
+ **************************************************************/
+static void Free(RESOURCE *resource) {
+    if (resource->state == RESOURCE_READY) {
+        switch (resource->type) {
+        case RESOURCE_FONT:
+            al_destroy_font(resource->data);
+            break;
+        case RESOURCE_IMAGE:
+            al_destroy_bitmap(resource->data);
+            break;
+        default:
+            // Atlas regions go with the atlas
+            break;
+        }
+    }
+    resource->state = RESOURCE_EMPTY;
+    resource->data = NULL;
+    resource->references = 0;
+    resource->bytes = 0;
+}
+
+/**********************************************************//**
+ * @brief Publishes a resource claimed by Acquire and wakes up
+ * any threads waiting for it.
+ * @param resource: The claimed resource.
+ * @param data: The loaded object, or NULL if loading failed.
+ * The caller holds the first reference to it.
+ * @param bytes: Estimated resident size of the object.
+ * @return The loaded object.
+ **************************************************************/
+static void *Finish(RESOURCE *resource, void *data, size_t bytes) {
+    al_lock_mutex(GlobalMutex);
+    resource->data = data;
+    resource->state = data? RESOURCE_READY: RESOURCE_FAILED;
+    resource->references = data? 1: 0;
+    resource->bytes = data? bytes: 0;
+    al_broadcast_cond(GlobalLoaded);
+    al_unlock_mutex(GlobalMutex);
+    return data;
+}
+
+/*============================================================*
+ * Setting up the cache
+ *============================================================*/
+bool resource_Initialize(void) {
+    if (GlobalMutex) {
+        return true;
+    }
+    GlobalMutex = al_create_mutex();
+    GlobalLoaded = al_create_cond();
+    if (!GlobalMutex || !GlobalLoaded) {
+        eprintf("Failed to create the resource cache lock.\n");
+        resource_Destroy();
+        return false;
+    }
+    GlobalCount = 0;
+    return true;
+}
+
+/*============================================================*
+ * Destroying the cache
+ *============================================================*/
+void resource_Destroy(void) {
+    for (int i = 0; i < GlobalCount; i++) {
+        Free(&GlobalResources[i]);
+    }
+    GlobalCount = 0;
+    if (GlobalLoaded) {
+        al_destroy_cond(GlobalLoaded);
+        GlobalLoaded = NULL;
+    }
+    if (GlobalMutex) {
+        al_destroy_mutex(GlobalMutex);
+        GlobalMutex = NULL;
+    }
+}
+
+/*============================================================*
+ * Releasing resources
+ *============================================================*/
+void resource_Release(const void *data) {
+    if (!data) {
+        return;
+    }
+    al_lock_mutex(GlobalMutex);
+    for (int i = 0; i < GlobalCount; i++) {
+        RESOURCE *resource = &GlobalResources[i];
+        if (resource->state == RESOURCE_READY && resource->data == data) {
+            if (resource->references > 0) {
+                resource->references--;
+            } else {
+                eprintf("Released %s too many times.\n", resource->filename);
+            }
+            al_unlock_mutex(GlobalMutex);
+            return;
+        }
+    }
+    al_unlock_mutex(GlobalMutex);
+    eprintf("Released a resource that isn't cached.\n");
+}
+
+size_t resource_Purge(void) {
+    size_t freed = 0;
+    al_lock_mutex(GlobalMutex);
+    for (int i = 0; i < GlobalCount; i++) {
+        // Atlas regions can't be reclaimed one at a time, so
+        // they are kept to avoid packing an image twice.
+        RESOURCE *resource = &GlobalResources[i];
+        if ((resource->state == RESOURCE_READY || resource->state == RESOURCE_FAILED)
+                && resource->references == 0 && resource->type != RESOURCE_BITMAP) {
+            freed += resource->bytes;
+            Free(resource);
+        }
+    }
+    al_unlock_mutex(GlobalMutex);
+    return freed;
+}
+
+/*============================================================*
+ * Reporting memory
+ *============================================================*/
+size_t resource_GetResidentBytes(void) {
+    size_t total = 0;
+    al_lock_mutex(GlobalMutex);
+    for (int i = 0; i < GlobalCount; i++) {
+        total += GlobalResources[i].bytes;
+    }
+    al_unlock_mutex(GlobalMutex);
+    return total;
+}
+
+void resource_Report(FILE *file) {
+    size_t total = 0;
+    al_lock_mutex(GlobalMutex);
+    fprintf(file, "%-6s %4s %10s  %s\n", "type", "refs", "bytes", "file");
+    for (int i = 0; i < GlobalCount; i++) {
+        const RESOURCE *resource = &GlobalResources[i];
+        if (resource->state != RESOURCE_READY) {
+            continue;
+        }
+        fprintf(file, "%-6s %4d %10zu  %s", ResourceTypeNames[resource->type], resource->references, resource->bytes, resource->filename);
+        if (resource->type == RESOURCE_FONT) {
+            fprintf(file, " (%dpx)", resource->size);
+        }
+        fprintf(file, "\n");
+        total += resource->bytes;
+    }
+    al_unlock_mutex(GlobalMutex);
+    fprintf(file, "%-6s %4s %10zu\n", "total", "", total);
+}
+
+/*============================================================*
+ * Loading fonts
+ *============================================================*/
+ALLEGRO_FONT *resource_LoadFont(const char *filename, int size, int flags) {
+    bool claimed;
+    RESOURCE *resource = Acquire(RESOURCE_FONT, filename, size, flags, &claimed);
+    if (!resource) {
+        return NULL;
+    }
+    if (!claimed) {
+        return resource->data;
+    }
+    ALLEGRO_FONT *font = al_load_ttf_font(filename, size, flags);
+    if (!font) {
+        eprintf("Failed to load %s\n", filename);
+    }
+    return Finish(resource, font, FileSize(filename));
+}
+
+/*============================================================*
+ * Loading images
+ *============================================================*/
+ALLEGRO_BITMAP *resource_LoadImage(const char *filename) {
+    bool claimed;
+    RESOURCE *resource = Acquire(RESOURCE_IMAGE, filename, 0, 0, &claimed);
+    if (!resource) {
+        return NULL;
+    }
+    if (!claimed) {
+        return resource->data;
+    }
+    
+    // Decode into memory, which works without a display
+    ALLEGRO_STATE state;
+    al_store_state(&state, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS);
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    ALLEGRO_BITMAP *image = al_load_bitmap(filename);
+    al_restore_state(&state);
+    if (!image) {
+        eprintf("Failed to load %s\n", filename);
+    }
+    return Finish(resource, image, image? BitmapSize(image): 0);
+}
+
+ALLEGRO_BITMAP *resource_LoadBitmap(const char *filename) {
+    bool claimed;
+    RESOURCE *resource = Acquire(RESOURCE_BITMAP, filename, 0, 0, &claimed);
+    if (!resource) {
+        return NULL;
+    }
+    if (!claimed) {
+        return resource->data;
+    }
+    
+    // Upload the decoded image into the atlas. The decoded copy
+    // stays cached until the next purge.
+    ALLEGRO_BITMAP *image = resource_LoadImage(filename);
+    ALLEGRO_BITMAP *bitmap = image? atlas_AddBitmap(image): NULL;
+    resource_Release(image);
+    return Finish(resource, bitmap, bitmap? BitmapSize(bitmap): 0);
+}
+
+/*============================================================*/
@@ -0,0 +1,106 @@
+/**********************************************************//**
+ * @file resource.h
+ * @brief Header file for the resource cache, which loads each
+ * font and image once no matter how many modules ask for it.
+ * Every load takes a reference that must be given back with
+ * resource_Release. Resources nobody holds stay cached until
+ * resource_Purge, and are loaded again the next time they are
+ * asked for.
+ **************************************************************/
+
+#ifndef _RESOURCE_H_
+#define _RESOURCE_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+#include <stddef.h>     // size_t
+#include <stdio.h>      // FILE
+
+// Allegro
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+
+//**************************************************************
+/// The maximum number of cached resources.
+#define MAX_RESOURCES 64
+
+/// The maximum length of a resource's filename.
+#define MAX_RESOURCE_NAME 128
+
+/**********************************************************//**
+ * @brief Sets up the cache. This must be called after Allegro
+ * is initialized and before any resource is loaded.
+ * @return Whether the cache could be set up.
+ **************************************************************/
+extern bool resource_Initialize(void);
+
+/**********************************************************//**
+ * @brief Destroys every cached font and image, whether or not
+ * it is still held.
+ **************************************************************/
+extern void resource_Destroy(void);
+
+/**********************************************************//**
+ * @brief Gives back a reference taken by one of the load
+ * functions.
+ * @param data: The font or bitmap that was loaded. NULL is
+ * ignored.
+ **************************************************************/
+extern void resource_Release(const void *data);
+
+/**********************************************************//**
+ * @brief Frees every font and image that nobody holds. Atlas
+ * regions are kept, since the atlas can't reuse their space.
+ * @return Estimated number of bytes freed.
+ **************************************************************/
+extern size_t resource_Purge(void);
+
+/**********************************************************//**
+ * @brief Estimates the memory held by the cache. Images count
+ * four bytes per pixel and fonts count their file size, which
+ * leaves out glyph pages.
+ * @return The estimate in bytes.
+ **************************************************************/
+extern size_t resource_GetResidentBytes(void);
+
+/**********************************************************//**
+ * @brief Writes the references and estimated size of every
+ * cached resource.
+ * @param file: Where to write the report.
+ **************************************************************/
+extern void resource_Report(FILE *file);
+
+/**********************************************************//**
+ * @brief Loads a TrueType font, or gets it from the cache.
+ * Fonts should be loaded from the thread that owns the
+ * display, since their glyph pages take the bitmap flags of
+ * the thread that loads them.
+ * @param filename: The font file.
+ * @param size: Size of the font in pixels.
+ * @param flags: Allegro TTF flags.
+ * @return The font, owned by the cache, or NULL if it could
+ * not be loaded. Release it when done.
+ **************************************************************/
+extern ALLEGRO_FONT *resource_LoadFont(const char *filename, int size, int flags);
+
+/**********************************************************//**
+ * @brief Decodes an image into a memory bitmap, or gets it
+ * from the cache. This may be called from any thread.
+ * @param filename: The image file.
+ * @return The image, owned by the cache, or NULL if it could
+ * not be loaded. Release it when done.
+ **************************************************************/
+extern ALLEGRO_BITMAP *resource_LoadImage(const char *filename);
+
+/**********************************************************//**
+ * @brief Gets an image as a region of the texture atlas,
+ * decoding it first if no loader has yet. This must be called
+ * from the thread that owns the display.
+ * @param filename: The image file.
+ * @return A bitmap owned by the atlas, or NULL if the image
+ * could not be loaded. Release it when done.
+ **************************************************************/
+extern ALLEGRO_BITMAP *resource_LoadBitmap(const char *filename);
+
+/*============================================================*/
+#endif // _RESOURCE_H_
@@ -7,13 +7,13 @@
 #include <stddef.h>     // size_t
 #include <stdbool.h>    // bool
 #include <string.h>     // strlen, strcpy
-#include <ctype.h>      // tolower
 
 // This project
 #include "debug.h"      // assert, eprintf
 #include "word.h"       // WORD
 #include "technique.h"  // TECHNIQUE
-#include "word_table.h" // WORD_TABLE
+#include "language.h"   // language_Fold
+#include "word_trie.h"  // wordTrie_Step
 
 //**************************************************************
 /// Initial base stat value.
@@ -26,51 +26,17 @@
 #define OVERFLOW_BOOST 5
 
 //**************************************************************
-/// Maps each letter (0-25) to the stat it's associated with.
-static const char LETTER_STATS[N_LETTERS] = {
-    STAT_MAXHP,  // A
-    STAT_DEFEND, // B
-    STAT_SPEED,  // C
-    STAT_DEFEND, // D
-    STAT_MAXHP,  // E
-    STAT_ATTACK, // F
-    STAT_DEFEND, // G
-    STAT_SPEED,  // H
-    STAT_MAXHP,  // I
-    STAT_ATTACK, // J
-    STAT_ATTACK, // K
-    STAT_SPEED,  // L
-    STAT_DEFEND, // M
-    STAT_SPEED,  // N
-    STAT_MAXHP,  // O
-    STAT_SPEED,  // P
-    STAT_SPEED,  // Q
-    STAT_ATTACK, // R
-    STAT_ATTACK, // S
-    STAT_DEFEND, // T
-    STAT_MAXHP,  // U
-    STAT_ATTACK, // V
-    STAT_DEFEND, // W
-    STAT_ATTACK, // X
-    STAT_MAXHP,  // Y
-    STAT_SPEED,  // Z
-};
+/// Last version stamp handed out to a word. Words may be made on
+/// several threads at once, so it is only changed atomically.
+static unsigned GlobalVersion = 0;
 
 /**********************************************************//**
- * @brief Maps each letter to a corresponding stat using the
- * LETTER_STATS lookup table.
- * @param letter: An uppercase or lowercase letter.
- * @return The stat associated to the letter or -1 on failure.
+ * @brief Stamps the word with a new version so that cached
+ * renderings and labels of it are redone.
+ * @param word: The word that changed.
  **************************************************************/
-static int LetterStat(char letter) {
-    // Assume input is in English
-    int index = tolower(letter) - 'a';
-    if (index >= 0 && index < N_LETTERS) {
-        return LETTER_STATS[index];
-    }
-    
-    // Default to MAX HP if not a latin letter.
-    return STAT_MAXHP;
+static inline void Touch(WORD *word) {
+    word->version = __atomic_add_fetch(&GlobalVersion, 1, __ATOMIC_RELAXED);
 }
 
 /**********************************************************//**
@@ -85,9 +51,6 @@ static inline int StatCodon(STAT first, STAT second) {
     return ((first & 3) << 2) | (second & 3);
 }
 
-/// The total number of unique technique codons.
-#define N_CODONS (N_STATS*N_STATS)
-
 /// Total number of codon stacks.
 #define N_STACKS 2
 
@@ -152,121 +115,148 @@ static inline int ExperienceNeeded(int n) {
 }
     
 /*============================================================*
- * Creating a word
+ * Reading letters
  *============================================================*/
-bool word_Create(WORD *word, const char *text, int level) {
-    // Set word text
-    int length = strlen(text);
-    if (length < MIN_WORD_LENGTH || length > MAX_WORD_LENGTH) {
-        eprintf("The word \"%s\" is of invalid length.\n", text);
-        return false;
-    }
+
+/**********************************************************//**
+ * @brief Clears the letters of a word being typed.
+ * @param builder: The word to clear.
+ * @param language: The language of the letters.
+ * @param trie: The language's dictionary, or NULL.
+ **************************************************************/
+static void ClearBuilder(WORD_BUILDER *builder, const LANGUAGE *language, const WORD_TRIE *trie) {
+    builder->language = language;
+    builder->trie = trie;
+    builder->length = 0;
+    builder->lower[0] = '\0';
+    builder->upper[0] = '\0';
+    builder->lowerEnd = 0;
+    builder->upperEnd = 0;
+    builder->nodes[0] = trie? WORD_TRIE_ROOT: -1;
+    builder->nTechs = 0;
     
-    // Convert entire word to lowercase
-    char lowercase[MAX_WORD_LENGTH+1];
-    for (int i = 0; i < length; i++) {
-        word->text[i] = toupper(text[i]);
-        lowercase[i] = tolower(text[i]);
+    // The word gets points for each letter, with one point
+    // of HP to start
+    for (int i = 0; i < N_STATS; i++) {
+        builder->acc[i] = 0;
+        builder->boosts[i] = 0;
+    }
+    builder->acc[STAT_MAXHP] = 1;
+    for (int i = 0; i < N_CODONS; i++) {
+        builder->codonStacks[i] = 0;
+    }
+}
+
+/**********************************************************//**
+ * @brief Reads the stat of the next letter of a word, and the
+ * codon it ends.
+ * @param builder: The word being read.
+ * @param stat: The stat of the letter.
+ **************************************************************/
+static void AddStat(WORD_BUILDER *builder, STAT stat) {
+    int i = builder->length++;
+    builder->stats[i] = stat;
+    builder->acc[stat] += 1;
+    builder->taught[i] = false;
+    if (i == 0) {
+        return;
     }
-    word->text[length] = '\0';
-    lowercase[length] = '\0';
     
-    // Check if this is a real word (need to check lowercase)
-    if (!wordTable_IsValid()) {
-        eprintf("Word table has not been initialized.\n");
-        return false;
+    // Read the codon this letter ends. A repeat codon boosts
+    // both its stats instead, if the word turns out to be real.
+    // It is impossible for tech to already exist in the word's
+    // moveset so long as the mapping array is configured
+    // properly.
+    STAT first = builder->stats[i-1];
+    int codon = StatCodon(first, stat);
+    TECHNIQUE tech = CodonTechnique(codon, builder->codonStacks[codon]++);
+    if (tech != NONE && builder->nTechs < MAX_TECHNIQUES) {
+        builder->techs[builder->nTechs++] = tech;
+        builder->taught[i] = true;
+    } else {
+        builder->boosts[first]++;
+        builder->boosts[stat]++;
+    }
+}
+
+/**********************************************************//**
+ * @brief Forgets the stat of the last letter of a word, and
+ * the codon it ends.
+ * @param builder: The word being read, with a letter.
+ **************************************************************/
+static void RemoveStat(WORD_BUILDER *builder) {
+    int i = --builder->length;
+    STAT stat = builder->stats[i];
+    builder->acc[stat] -= 1;
+    if (i == 0) {
+        return;
     }
-    if (wordTable_Contains(lowercase)) {
-		word->flags = WORD_REAL;
-	} else {
-		word->flags = 0;
-	}
     
+    // Techniques are taught in order, so the last codon
+    // taught the last technique
+    STAT first = builder->stats[i-1];
+    builder->codonStacks[StatCodon(first, stat)]--;
+    if (builder->taught[i]) {
+        builder->nTechs--;
+    } else {
+        builder->boosts[first]--;
+        builder->boosts[stat]--;
+    }
+}
+
+/*============================================================*
+ * Creating a word
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Makes a word from the letters read.
+ * @param word: Output parameter for the word which is being
+ * constructed.
+ * @param builder: The letters of the word.
+ * @param real: Whether it is a real word.
+ * @param level: Initial level of the word
+ * @return Whether the word was successfully constructed.
+ **************************************************************/
+static bool FinishWord(WORD *word, const WORD_BUILDER *builder, bool real, int level) {
     // Set level
     if (level < MIN_LEVEL || level > MAX_LEVEL) {
         eprintf("Invalid initial word level: %d\n", level);
         return false;
     }
     word->level = level;
-    
-    // Accumulate total base stats for the letter
-    // The word gets points for each letter, with letters located
-    // earlier in the word having more weight. After this is
-    // completed, the word certainly contains only valid stats.
-    int acc[N_STATS] = {1};
-    int stat;
-    for (int i = 0; i < length; i++) {
-        // Weight each letter according to its position in the word
-        if ((stat = LetterStat(text[i])) < 0) {
-            eprintf("Invalid stat discovered: %d\n", stat);
-            return false;
-        }
-        acc[stat] += 1;
-    }
+    word->flags = real? WORD_REAL: 0;
+    strcpy(word->text, builder->upper);
     
     // Scale base stat totals (balancing)
     int total = 0;
     for (int i = 0; i < N_STATS; i++) {
-        total += acc[i];
+        total += builder->acc[i];
     }
     int statAverage = 1 + (total + 3) / 4;
     
     // Get the initial base stat modifier
     int initial = INITIAL_STAT;
-    if (word->flags & WORD_REAL) {
+    if (real) {
         initial += REAL_BOOST;
     }
     
-    // Set initial base stats
+    // Set initial base stats. Only real words get repeat codon
+    // boosts so we can prevent spamming stuff like
+    // "aaaaaaaaaaaaaaaa".
     for (int i = 0; i < N_STATS; i++) {
         // Multiply first to avoid truncation errors
-        word->base[i] = initial + (acc[i] * 60) / statAverage;
-    }
-    
-    // Set up codon reading
-    int codon;
-    int codonStacks[N_CODONS];
-    for (int i = 0; i < N_CODONS; i++) {
-        codonStacks[i] = 0;
-    }
-    
-    // Read all codons
-    int first, second = LetterStat(text[0]);
-    int index;
-    int tech;
-    word->nTechs = 0;
-    for (int i = 1; i < length; i++) {
-        // Read the next codon (loop if invalid)
-        first = second;
-        index = i % length;
-        second = LetterStat(text[index]);
-        codon = StatCodon(first, second);
-        if ((tech = CodonTechnique(codon, codonStacks[codon]++)) < 0) {
-            eprintf("Invalid technique: %d\n", tech);
-            return false;
-        }
-        
-        // Boost base stat if a repeat codon was discovered.
-        // It is OK if the stats boosted are the same.
-        // It is also impossible for tech to already exist in
-        // the word's moveset so long as the mapping array is
-        // configured properly.
-        if (tech != NONE && word->nTechs < MAX_TECHNIQUES) {
-            word->techs[word->nTechs++] = tech;
-        } else if (word->flags & WORD_REAL) {
-            // Only get these boosts for real words so we can prevent
-            // spamming stuff like "aaaaaaaaaaaaaaaa"
-            word->base[first] += OVERFLOW_BOOST;
-            word->base[second] += OVERFLOW_BOOST;
+        word->base[i] = initial + (builder->acc[i] * 60) / statAverage;
+        if (real) {
+            word->base[i] += builder->boosts[i]*OVERFLOW_BOOST;
         }
-    }
-    
-    // Base stat restriction
-    for (int i = 0; i < N_STATS; i++) {
         if (word->base[i] > MAX_BASE_STAT) {
             word->base[i] = MAX_BASE_STAT;
         }
     }
+    word->nTechs = builder->nTechs;
+    for (int i = 0; i < builder->nTechs; i++) {
+        word->techs[i] = builder->techs[i];
+    }
     
     // Find the word rank.
     int bst = word->base[STAT_MAXHP] + word->base[STAT_ATTACK] + word->base[STAT_DEFEND] + word->base[STAT_SPEED];
@@ -288,9 +278,151 @@ bool word_Create(WORD *word, const char *text, int level) {
     word->expNeed = word->exp = ExperienceNeeded(level);
     word_UpdateStats(word);
     word->hp = word->stat[STAT_MAXHP];
+    word->labels.version = 0;
+    Touch(word);
+    return true;
+}
+
+bool word_Create(WORD *word, const char *text, int level) {
+    return word_CreateIn(word, language_GetEnglish(), text, level);
+}
+
+bool word_CreateIn(WORD *word, const LANGUAGE *language, const char *text, int level) {
+    // Fold the text and get the stat of each letter in one pass
+    WORD_BUILDER builder;
+    ClearBuilder(&builder, language, NULL);
+    unsigned char stats[MAX_WORD_LENGTH];
+    int length = language_Fold(language, text, builder.lower, builder.upper, stats, MAX_WORD_LENGTH);
+    if (length < MIN_WORD_LENGTH) {
+        eprintf("The word \"%s\" is of invalid length or encoding.\n", text);
+        return false;
+    }
+    
+    // Check if this is a real word (need to check lowercase)
+    if (!language_HasDictionary(language)) {
+        eprintf("Word table has not been initialized.\n");
+        return false;
+    }
+    bool real = language_Contains(language, builder.lower);
+    
+    // Read every letter
+    for (int i = 0; i < length; i++) {
+        AddStat(&builder, stats[i]);
+    }
+    return FinishWord(word, &builder, real, level);
+}
+
+/*============================================================*
+ * Making the dictionary
+ *============================================================*/
+
+/**********************************************************//**
+ * @struct DICTIONARY_WALK
+ * @brief Where the words of a dictionary walk go.
+ **************************************************************/
+typedef struct {
+    const LANGUAGE *language;   ///< Language of the dictionary.
+    WORD_MADE visit;            ///< Called with each word.
+    void *data;                 ///< Passed to visit.
+} DICTIONARY_WALK;
+
+/**********************************************************//**
+ * @brief Makes one dictionary word and visits it, if it is
+ * a valid WORD.
+ * @param data: The DICTIONARY_WALK.
+ * @param text: The word as it is in the dictionary.
+ **************************************************************/
+static void MakeWord(void *data, const char *text) {
+    // Check the length first, as words that are too long or
+    // short can't be made without complaint
+    const DICTIONARY_WALK *walk = data;
+    WORD_BUILDER builder;
+    ClearBuilder(&builder, walk->language, NULL);
+    unsigned char stats[MAX_WORD_LENGTH];
+    int length = language_Fold(walk->language, text, builder.lower, builder.upper, stats, MAX_WORD_LENGTH);
+    if (length < MIN_WORD_LENGTH) {
+        return;
+    }
+    for (int i = 0; i < length; i++) {
+        AddStat(&builder, stats[i]);
+    }
+    WORD word;
+    if (FinishWord(&word, &builder, true, MIN_LEVEL)) {
+        walk->visit(walk->data, text, &word, length);
+    }
+}
+
+bool word_WalkDictionary(const LANGUAGE *language, WORD_MADE visit, void *data) {
+    DICTIONARY_WALK walk = {
+        .language = language,
+        .visit = visit,
+        .data = data,
+    };
+    return language_Walk(language, MakeWord, &walk);
+}
+
+/*============================================================*
+ * Typing a word
+ *============================================================*/
+void word_StartBuilder(WORD_BUILDER *builder, const LANGUAGE *language, const WORD_TRIE *trie) {
+    ClearBuilder(builder, language, trie);
+}
+
+bool word_PushLetter(WORD_BUILDER *builder, const char *letter) {
+    if (builder->length >= MAX_WORD_LENGTH) {
+        return false;
+    }
+    
+    // Fold the letter onto the end of the text
+    int i = builder->length;
+    int nLower = builder->lowerEnd;
+    int nUpper = builder->upperEnd;
+    unsigned char stat;
+    if (language_Fold(builder->language, letter, builder->lower + nLower, builder->upper + nUpper, &stat, 1) != 1) {
+        builder->lower[nLower] = '\0';
+        builder->upper[nUpper] = '\0';
+        return false;
+    }
+    builder->lowerStart[i] = nLower;
+    builder->upperStart[i] = nUpper;
+    builder->lowerEnd = nLower + strlen(builder->lower + nLower);
+    builder->upperEnd = nUpper + strlen(builder->upper + nUpper);
+    AddStat(builder, stat);
+    
+    // Step down the trie, unless no word starts this way
+    int node = builder->nodes[i];
+    builder->nodes[i+1] = node < 0? -1: wordTrie_Step(builder->trie, node, builder->lower + nLower);
     return true;
 }
 
+bool word_PopLetter(WORD_BUILDER *builder) {
+    if (builder->length == 0) {
+        return false;
+    }
+    RemoveStat(builder);
+    builder->lowerEnd = builder->lowerStart[builder->length];
+    builder->upperEnd = builder->upperStart[builder->length];
+    builder->lower[builder->lowerEnd] = '\0';
+    builder->upper[builder->upperEnd] = '\0';
+    return true;
+}
+
+bool word_BuilderIsReal(const WORD_BUILDER *builder) {
+    return builder->length >= MIN_WORD_LENGTH && wordTrie_IsWord(builder->trie, builder->nodes[builder->length]);
+}
+
+bool word_BuilderCanBeReal(const WORD_BUILDER *builder) {
+    return builder->nodes[builder->length] >= 0;
+}
+
+bool word_CreateFromBuilder(WORD *word, const WORD_BUILDER *builder, int level) {
+    if (builder->length < MIN_WORD_LENGTH) {
+        eprintf("The word \"%s\" is of invalid length or encoding.\n", builder->upper);
+        return false;
+    }
+    return FinishWord(word, builder, word_BuilderIsReal(builder), level);
+}
+
 /*============================================================*
  * Changing HP
  *============================================================*/
@@ -305,7 +437,7 @@ void word_ChangeCurrentHP(WORD *word, int delta) {
     } else {
         word->hp = temp;
     }
-    return;
+    Touch(word);
 }
 
 /*============================================================*
@@ -318,6 +450,7 @@ void word_ChangeExperience(WORD *word, int delta) {
         word->exp += word->expNeed = ExperienceNeeded(word->level);
     }
     word_UpdateStats(word);
+    Touch(word);
 }
 
 /*============================================================*/
@@ -11,11 +11,11 @@
 
 // This project
 #include "technique.h"  // TECHNIQUE
+#include "format.h"     // FORMAT_INT_SIZE
+#include "language.h"   // LANGUAGE
+#include "word_trie.h"  // WORD_TRIE
 
 //**************************************************************
-/// Number of letters supported (a-z)
-#define N_LETTERS 26
-
 /// The maximum number of special techniques any word can have.
 #define MAX_TECHNIQUES 4
 
@@ -23,6 +23,12 @@
 #define MIN_WORD_LENGTH 2   ///< Length of the smallest word
 #define MAX_WORD_LENGTH 16  ///< Length of the longest word.
 
+/// Number of lengths a word can have.
+#define N_WORD_LENGTHS (MAX_WORD_LENGTH - MIN_WORD_LENGTH + 1)
+
+/// Bytes of UTF-8 text in the longest word.
+#define MAX_WORD_BYTES (MAX_WORD_LENGTH*MAX_LETTER_BYTES)
+
 // Word level range
 #define MIN_LEVEL 1         ///< The minimum word level.
 #define MAX_LEVEL 100       ///< The maximum word level.
@@ -63,19 +69,38 @@ typedef enum {
     RANK_S=5,       ///< Best rank. 500 <= BST
 } RANK;
 
+/// The total number of ranks.
+#define N_RANKS 6
+
+/// The total number of unique technique codons.
+#define N_CODONS (N_STATS*N_STATS)
+
 typedef enum {
 	WORD_REAL=0x1,
 	WORD_LOCKED=0x2,
     WORD_IN_TEAM=0x4,
 } WORD_FLAGS;
 
+/**********************************************************//**
+ * @struct WORD_LABELS
+ * @brief Text of the numbers shown for a word. The labels are
+ * written when the word is drawn and kept until its version
+ * changes, so making words never formats them.
+ **************************************************************/
+typedef struct {
+    char level[FORMAT_INT_SIZE];    ///< The level.
+    char hp[FORMAT_RATIO_SIZE];     ///< Current and maximum HP.
+    char stat[N_STATS][FORMAT_INT_SIZE]; ///< Current stats.
+    unsigned version;               ///< Version of the word written, or 0.
+} WORD_LABELS;
+
 /**********************************************************//**
  * @struct WORD
  * @brief Defines all the data in one word.
  **************************************************************/
 typedef struct {
     // Constant properties
-    char text[MAX_WORD_LENGTH+1];   ///< Actual text of the word
+    char text[MAX_WORD_BYTES+1];    ///< Actual text of the word
     TECHNIQUE techs[MAX_TECHNIQUES];///< Techniques known.
     int base[N_STATS];  ///< Constant base stats.
     int nTechs;         ///< Number of techniques.
@@ -88,8 +113,50 @@ typedef struct {
     int exp;            ///< Current EXP
     int expNeed;        ///< Required experience to level up.
     int stat[N_STATS];  ///< Current stats
+    WORD_LABELS labels; ///< Text of the numbers, written when drawn.
+    
+    /// Stamp that changes whenever displayed data changes. Stamps
+    /// are unique across all words, so copies share a stamp only
+    /// while their contents are identical.
+    unsigned version;
 } WORD;
 
+/**********************************************************//**
+ * @struct WORD_BUILDER
+ * @brief A word being typed one letter at a time. Every letter
+ * added or removed updates the stats, codons and techniques it
+ * changes and steps through the dictionary trie, so the word
+ * can be shown after each key without being made again.
+ **************************************************************/
+typedef struct {
+    const LANGUAGE *language;       ///< Language of the letters.
+    const WORD_TRIE *trie;          ///< Prefixes of its dictionary.
+    int length;                     ///< Letters typed.
+    char lower[MAX_WORD_BYTES+1];   ///< Lowercase text.
+    char upper[MAX_WORD_BYTES+1];   ///< Uppercase text.
+    unsigned char lowerStart[MAX_WORD_LENGTH]; ///< Start of each lowercase letter.
+    unsigned char upperStart[MAX_WORD_LENGTH]; ///< Start of each uppercase letter.
+    unsigned char lowerEnd;         ///< Bytes of lowercase text typed.
+    unsigned char upperEnd;         ///< Bytes of uppercase text typed.
+    unsigned char stats[MAX_WORD_LENGTH];      ///< Stat of each letter.
+    bool taught[MAX_WORD_LENGTH];   ///< Whether each letter's codon taught a technique.
+    int nodes[MAX_WORD_LENGTH+1];   ///< Trie node after each letter, or -1.
+    int acc[N_STATS];               ///< Points for each stat.
+    int boosts[N_STATS];            ///< Repeat codons of each stat, for real words.
+    int codonStacks[N_CODONS];      ///< Times each codon has been read.
+    TECHNIQUE techs[MAX_TECHNIQUES];///< Techniques taught.
+    int nTechs;                     ///< Number of techniques.
+} WORD_BUILDER;
+
+/**********************************************************//**
+ * @brief Visits a dictionary word that makes a valid WORD.
+ * @param data: Data given to word_WalkDictionary.
+ * @param text: The word as it is in the dictionary.
+ * @param word: The word, made real at MIN_LEVEL.
+ * @param length: Number of letters in the word.
+ **************************************************************/
+typedef void (*WORD_MADE)(void *data, const char *text, const WORD *word, int length);
+
 /**********************************************************//**
  * @brief Create a word
  * @param word: Output parameter for the word which is being
@@ -100,6 +167,81 @@ typedef struct {
  **************************************************************/
 extern bool word_Create(WORD *word, const char *text, int level);
 
+/**********************************************************//**
+ * @brief Create a word in any language.
+ * @param word: Output parameter for the word which is being
+ * constructed.
+ * @param language: The language of the text.
+ * @param text: The UTF-8 text of the word.
+ * @param level: Initial level of the word
+ * @return Whether the word was successfully constructed.
+ **************************************************************/
+extern bool word_CreateIn(WORD *word, const LANGUAGE *language, const char *text, int level);
+
+/**********************************************************//**
+ * @brief Makes every word of a language's dictionary that is
+ * a valid WORD, in dictionary order. Each word is folded once
+ * and isn't looked up again, as it is known to be real.
+ * @param language: The language of the dictionary.
+ * @param visit: Called with each word.
+ * @param data: Passed to visit.
+ * @return Whether the dictionary is loaded.
+ **************************************************************/
+extern bool word_WalkDictionary(const LANGUAGE *language, WORD_MADE visit, void *data);
+
+/**********************************************************//**
+ * @brief Starts typing a word.
+ * @param builder: The word to start.
+ * @param language: The language of the letters.
+ * @param trie: The language's dictionary, from wordTrie_Create.
+ * It must outlive the builder.
+ **************************************************************/
+extern void word_StartBuilder(WORD_BUILDER *builder, const LANGUAGE *language, const WORD_TRIE *trie);
+
+/**********************************************************//**
+ * @brief Adds a letter to the end of a word being typed.
+ * @param builder: The word being typed.
+ * @param letter: The UTF-8 text of one letter.
+ * @return Whether the letter was added. The word can't grow
+ * past MAX_WORD_LENGTH letters.
+ **************************************************************/
+extern bool word_PushLetter(WORD_BUILDER *builder, const char *letter);
+
+/**********************************************************//**
+ * @brief Removes the last letter of a word being typed.
+ * @param builder: The word being typed.
+ * @return Whether there was a letter to remove.
+ **************************************************************/
+extern bool word_PopLetter(WORD_BUILDER *builder);
+
+/**********************************************************//**
+ * @brief Checks if a word being typed is a real word.
+ * @param builder: The word being typed.
+ * @return Whether it is in the trie's dictionary and long
+ * enough to be made.
+ **************************************************************/
+extern bool word_BuilderIsReal(const WORD_BUILDER *builder);
+
+/**********************************************************//**
+ * @brief Checks if more letters could make a word being typed
+ * a real word.
+ * @param builder: The word being typed.
+ * @return Whether any word in the trie's dictionary starts
+ * with it, including the word itself.
+ **************************************************************/
+extern bool word_BuilderCanBeReal(const WORD_BUILDER *builder);
+
+/**********************************************************//**
+ * @brief Makes the word typed so far, the same as word_CreateIn
+ * would. Whether it is real comes from the trie.
+ * @param word: Output parameter for the word which is being
+ * constructed.
+ * @param builder: The word being typed.
+ * @param level: Initial level of the word
+ * @return Whether the word was successfully constructed.
+ **************************************************************/
+extern bool word_CreateFromBuilder(WORD *word, const WORD_BUILDER *builder, int level);
+
 /**********************************************************//**
  * @brief Heal or damage the word.
  * @param word: The word to read.
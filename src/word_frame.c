@@ -5,7 +5,7 @@
 
 // Standard library
 #include <stdbool.h>        // bool
-#include <stdio.h>          // sprintf
+#include <stdint.h>         // uintptr_t
 
 // Allegro
 #include <allegro5/allegro.h>
@@ -14,10 +14,16 @@
 
 // This project
 #include "debug.h"          // eprintf, assert
-#include "frame.h"          // FRAME
+#include "frame.h"          // frame_DrawText, frame_GetThemeVersion
 #include "bar.h"            // BAR
 #include "word.h"           // WORD
 #include "word_frame.h"     // HUD_MODE
+#include "format.h"         // format_Int
+#include "atlas.h"          // atlas_Allocate
+#include "resource.h"       // resource_LoadBitmap, resource_Release
+#include "loader.h"         // loader_AddImage
+#include "render.h"         // render_DrawBitmap
+#include "profile.h"        // PROFILE_ZONE
 
 
 //**************************************************************
@@ -54,26 +60,91 @@ static ALLEGRO_BITMAP *GlobalRankD;
 /// Icon denoting a word is RANK F.
 static ALLEGRO_BITMAP *GlobalRankF;
 
+//**************************************************************
+/// Number of word HUDs that can be cached at once.
+#define HUD_CACHE_SIZE 64
+
+/// Number of cached HUDs in one row of the cache sheet.
+#define HUD_CACHE_COLUMNS 8
+
+/// Number of distinct HUD modes.
+#define N_HUD_MODES 3
+
+/**********************************************************//**
+ * @struct HUD_CACHE_ENTRY
+ * @brief Stores one pre-rendered word HUD and the state of the
+ * word it was rendered from.
+ **************************************************************/
+typedef struct {
+    ALLEGRO_BITMAP *bitmap; ///< Region of the cache sheet.
+    const WORD *word;       ///< The word the HUD was rendered for.
+    unsigned version;       ///< Version of the word when rendered.
+    WORD_FLAGS flags;       ///< Flags of the word when rendered.
+    int theme;              ///< Theme version when rendered.
+    HUD_MODE mode;          ///< Mode the HUD was rendered in.
+    bool selected;          ///< Whether the HUD was rendered selected.
+    bool valid;             ///< Whether the entry holds a rendering.
+} HUD_CACHE_ENTRY;
+
+/// Bitmap holding every cached HUD, so blits share a texture.
+static ALLEGRO_BITMAP *GlobalHUDSheet;
+
+/// Pre-rendered word HUDs.
+static HUD_CACHE_ENTRY GlobalHUDCache[HUD_CACHE_SIZE];
+
+/**********************************************************//**
+ * @struct IMAGE_FILE
+ * @brief Where one HUD image is loaded from and kept.
+ **************************************************************/
+typedef struct {
+    const char *filename;       ///< The image file.
+    ALLEGRO_BITMAP **bitmap;    ///< Where the loaded image goes.
+} IMAGE_FILE;
+
+/// Every image used by the HUD.
+static const IMAGE_FILE GlobalImages[] = {
+    // HUD backgrounds
+    {"data/image/hud.png", &GlobalHUD},
+    {"data/image/hud_exp.png", &GlobalHUDExp},
+    {"data/image/hud_stats.png", &GlobalHUDFull},
+    
+    // HUD icons
+    {"data/image/flag_real.png", &GlobalFlagReal},
+    {"data/image/flag_locked.png", &GlobalFlagLocked},
+    
+    // Rank icons
+    {"data/image/rank_s.png", &GlobalRankS},
+    {"data/image/rank_a.png", &GlobalRankA},
+    {"data/image/rank_b.png", &GlobalRankB},
+    {"data/image/rank_c.png", &GlobalRankC},
+    {"data/image/rank_d.png", &GlobalRankD},
+    {"data/image/rank_f.png", &GlobalRankF},
+};
+
+/// Number of images used by the HUD.
+#define N_IMAGES ((int)(sizeof(GlobalImages)/sizeof(GlobalImages[0])))
+
 /*============================================================*
  * Images
  *============================================================*/
+void wordFrame_Preload(void) {
+    for (int i = 0; i < N_IMAGES; i++) {
+        loader_AddImage(GlobalImages[i].filename);
+    }
+}
+
 void wordFrame_Initialize(void) {
-    // Load HUD images
-    GlobalHUD = al_load_bitmap("data/image/hud.png");
-    GlobalHUDExp = al_load_bitmap("data/image/hud_exp.png");
-    GlobalHUDFull = al_load_bitmap("data/image/hud_stats.png");
-    
-    // Load HUD icons
-    GlobalFlagReal = al_load_bitmap("data/image/flag_real.png");
-	GlobalFlagLocked = al_load_bitmap("data/image/flag_locked.png");
-    
-    // Load rank icons
-    GlobalRankS = al_load_bitmap("data/image/rank_s.png");
-    GlobalRankA = al_load_bitmap("data/image/rank_a.png");
-    GlobalRankB = al_load_bitmap("data/image/rank_b.png");
-    GlobalRankC = al_load_bitmap("data/image/rank_c.png");
-    GlobalRankD = al_load_bitmap("data/image/rank_d.png");
-    GlobalRankF = al_load_bitmap("data/image/rank_f.png");
+    // Move the decoded images into the shared atlas
+    for (int i = 0; i < N_IMAGES; i++) {
+        *GlobalImages[i].bitmap = resource_LoadBitmap(GlobalImages[i].filename);
+    }
+}
+
+void wordFrame_Destroy(void) {
+    for (int i = 0; i < N_IMAGES; i++) {
+        resource_Release(*GlobalImages[i].bitmap);
+        *GlobalImages[i].bitmap = NULL;
+    }
 }
 
 /**********************************************************//**
@@ -94,7 +165,7 @@ static ALLEGRO_COLOR HealthColor(float ratio) {
         }
         r = 255;
         g = balance;
-        
+    
     } else {
         // Balance yellow and green
         balance = 255 * 2 * (ratio - 0.5);
@@ -109,10 +180,32 @@ static ALLEGRO_COLOR HealthColor(float ratio) {
     return al_map_rgb(r, g, 60);
 }
 
-/*============================================================*
- * Draw the word HUD
- *============================================================*/
-void wordFrame_DrawHUD(const WORD *word, int x, int y, HUD_MODE mode, bool selected) {
+/**********************************************************//**
+ * @brief Get the height of the HUD in the given mode.
+ * @param mode: The kind of HUD.
+ * @return The height in pixels.
+ **************************************************************/
+static int HUDHeight(HUD_MODE mode) {
+    switch (mode) {
+    case HUD_EXTENDED:
+        return WORD_HUD_HEIGHT_EXTENDED;
+    case HUD_FULL:
+        return WORD_HUD_HEIGHT_FULL;
+    case HUD_BASIC:
+    default:
+        return WORD_HUD_HEIGHT_BASIC;
+    }
+}
+
+/**********************************************************//**
+ * @brief Draws the word's HUD without using the cache.
+ * @param word: The word to display.
+ * @param x: The x position of the frame.
+ * @param y: The y position of the frame.
+ * @param mode: The kind of HUD to draw.
+ * @param selected: Whether the HUD is tinted as selected.
+ **************************************************************/
+static void DrawHUD(const WORD *word, int x, int y, HUD_MODE mode, bool selected) {
     // Get the frame tint
     ALLEGRO_COLOR tint;
     if (selected) {
@@ -124,28 +217,24 @@ void wordFrame_DrawHUD(const WORD *word, int x, int y, HUD_MODE mode, bool selec
     // Choose whether to draw experience or not
     switch (mode) {
     case HUD_EXTENDED:
-        al_draw_tinted_bitmap(GlobalHUDExp, tint, x, y, 0);
+        render_DrawBitmap(GlobalHUDExp, tint, x, y);
         break;
     
     case HUD_FULL:
-        al_draw_tinted_bitmap(GlobalHUDFull, tint, x, y, 0);
+        render_DrawBitmap(GlobalHUDFull, tint, x, y);
         break;
     
     case HUD_BASIC:
     default:
-        al_draw_tinted_bitmap(GlobalHUD, tint, x, y, 0);
+        render_DrawBitmap(GlobalHUD, tint, x, y);
         break;
     }
     
     // Draw the word's name
     frame_DrawText(x+8, y+7, word->text);
     
-    // Buffer for all strings
-    char string[32];
-    
     // Draw the word's level
-    sprintf(string, "%d", word->level);
-    frame_DrawText(x+144, y+7, string);
+    frame_DrawText(x+144, y+7, word->labels.level);
     
     // Draw the word's health bar
     BAR health;
@@ -159,8 +248,7 @@ void wordFrame_DrawHUD(const WORD *word, int x, int y, HUD_MODE mode, bool selec
     bar_Draw(&health);
     
     // Draw the word's health fraction
-    sprintf(string, "%d/%d", word->hp, word->stat[STAT_MAXHP]);
-    frame_DrawOutlinedText(x+7, y+19, string);
+    frame_DrawOutlinedText(x+7, y+19, word->labels.hp);
     
     // Draw the rank
 	if (mode != HUD_BASIC) {
@@ -186,17 +274,17 @@ void wordFrame_DrawHUD(const WORD *word, int x, int y, HUD_MODE mode, bool selec
 			rank = GlobalRankF;
 			break;
 		}
-		al_draw_bitmap(rank, x+137, y+19, 0);
+		render_DrawBitmap(rank, al_map_rgb_f(1.0, 1.0, 1.0), x+137, y+19);
 	}
 	
 	// Draw the word flags
     if (word->flags & WORD_REAL) {
-        al_draw_bitmap(GlobalFlagReal, x+148, y+19, 0);
+        render_DrawBitmap(GlobalFlagReal, al_map_rgb_f(1.0, 1.0, 1.0), x+148, y+19);
     }
 	if (word->flags & WORD_LOCKED) {
-		al_draw_bitmap(GlobalFlagLocked, x+159, y+19, 0);
+		render_DrawBitmap(GlobalFlagLocked, al_map_rgb_f(1.0, 1.0, 1.0), x+159, y+19);
     }
-
+    
     // Draw the word's experience bar
     if (mode == HUD_EXTENDED || mode == HUD_FULL) {
         BAR exp;
@@ -213,14 +301,9 @@ void wordFrame_DrawHUD(const WORD *word, int x, int y, HUD_MODE mode, bool selec
     // Draw the full stats
     if (mode == HUD_FULL) {
         // Draw all the stats
-        sprintf(string, "%d", word->stat[STAT_ATTACK]);
-        frame_DrawText(x+146, y+41, string);
-        
-        sprintf(string, "%d", word->stat[STAT_DEFEND]);
-        frame_DrawText(x+146, y+53, string);
-        
-        sprintf(string, "%d", word->stat[STAT_SPEED]);
-        frame_DrawText(x+146, y+65, string);
+        frame_DrawText(x+146, y+41, word->labels.stat[STAT_ATTACK]);
+        frame_DrawText(x+146, y+53, word->labels.stat[STAT_DEFEND]);
+        frame_DrawText(x+146, y+65, word->labels.stat[STAT_SPEED]);
         
         // Draw the techniques
         const TECHNIQUE_DATA *data;
@@ -233,4 +316,123 @@ void wordFrame_DrawHUD(const WORD *word, int x, int y, HUD_MODE mode, bool selec
     }
 }
 
+/**********************************************************//**
+ * @brief Creates the sheet that cached HUDs are rendered into.
+ * This must happen after the display exists.
+ * @return Whether the cache is usable.
+ **************************************************************/
+static bool CreateHUDCache(void) {
+    if (GlobalHUDSheet) {
+        return true;
+    }
+    
+    // One slot per entry, each large enough for the full HUD
+    int rows = (HUD_CACHE_SIZE + HUD_CACHE_COLUMNS - 1) / HUD_CACHE_COLUMNS;
+    GlobalHUDSheet = al_create_bitmap(HUD_CACHE_COLUMNS*WORD_HUD_WIDTH, rows*WORD_HUD_HEIGHT_FULL);
+    if (!GlobalHUDSheet) {
+        eprintf("Failed to create the HUD cache.\n");
+        return false;
+    }
+    for (int i = 0; i < HUD_CACHE_SIZE; i++) {
+        HUD_CACHE_ENTRY *entry = &GlobalHUDCache[i];
+        int sx = (i % HUD_CACHE_COLUMNS) * WORD_HUD_WIDTH;
+        int sy = (i / HUD_CACHE_COLUMNS) * WORD_HUD_HEIGHT_FULL;
+        entry->bitmap = al_create_sub_bitmap(GlobalHUDSheet, sx, sy, WORD_HUD_WIDTH, WORD_HUD_HEIGHT_FULL);
+        entry->valid = false;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Gets the cache entry the word's HUD is stored in.
+ * @param word: The word to display.
+ * @param mode: The kind of HUD.
+ * @return The cache entry used by the word and mode.
+ **************************************************************/
+static inline HUD_CACHE_ENTRY *HUDCacheEntry(const WORD *word, HUD_MODE mode) {
+    // Words stored in arrays land in consecutive slots.
+    uintptr_t key = (uintptr_t)word / sizeof(WORD);
+    return &GlobalHUDCache[(key*N_HUD_MODES + mode) % HUD_CACHE_SIZE];
+}
+
+/**********************************************************//**
+ * @brief Checks whether the entry holds the current rendering.
+ * @param entry: The cache entry.
+ * @param word: The word to display.
+ * @param mode: The kind of HUD.
+ * @param selected: Whether the HUD is tinted as selected.
+ * @return Whether the entry can be blitted as is.
+ **************************************************************/
+static inline bool HUDCacheHit(const HUD_CACHE_ENTRY *entry, const WORD *word, HUD_MODE mode, bool selected) {
+    return entry->valid
+        && entry->word == word
+        && entry->version == word->version
+        && entry->flags == word->flags
+        && entry->theme == frame_GetThemeVersion()
+        && entry->mode == mode
+        && entry->selected == selected;
+}
+
+/**********************************************************//**
+ * @brief Writes the word's labels if they are older than the
+ * word.
+ * @param word: The word to display.
+ **************************************************************/
+static void UpdateLabels(WORD *word) {
+    if (word->labels.version == word->version) {
+        return;
+    }
+    format_Int(word->labels.level, word->level);
+    format_Ratio(word->labels.hp, word->hp, word->stat[STAT_MAXHP]);
+    for (int i = 0; i < N_STATS; i++) {
+        format_Int(word->labels.stat[i], word->stat[i]);
+    }
+    word->labels.version = word->version;
+}
+
+/*============================================================*
+ * Draw the word HUD
+ *============================================================*/
+void wordFrame_DrawHUD(WORD *word, int x, int y, HUD_MODE mode, bool selected) {
+    PROFILE_ZONE("wordFrame_DrawHUD");
+    
+    // Draw directly if the cache can't be made
+    if (!CreateHUDCache()) {
+        UpdateLabels(word);
+        DrawHUD(word, x, y, mode, selected);
+        return;
+    }
+    
+    // Re-render the HUD only when the word changed
+    HUD_CACHE_ENTRY *entry = HUDCacheEntry(word, mode);
+    if (!HUDCacheHit(entry, word, mode, selected)) {
+        UpdateLabels(word);
+        
+        // Deferred drawing must be flushed before retargeting
+        atlas_PauseBatch();
+        ALLEGRO_STATE state;
+        al_store_state(&state, ALLEGRO_STATE_TARGET_BITMAP | ALLEGRO_STATE_BLENDER);
+        al_set_target_bitmap(entry->bitmap);
+        al_set_separate_blender(ALLEGRO_ADD, ALLEGRO_ALPHA, ALLEGRO_INVERSE_ALPHA, ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_INVERSE_ALPHA);
+        al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+        render_HoldDrawing(true);
+        DrawHUD(word, 0, 0, mode, selected);
+        render_HoldDrawing(false);
+        al_restore_state(&state);
+        atlas_ResumeBatch();
+        
+        // Remember what was rendered
+        entry->word = word;
+        entry->version = word->version;
+        entry->flags = word->flags;
+        entry->theme = frame_GetThemeVersion();
+        entry->mode = mode;
+        entry->selected = selected;
+        entry->valid = true;
+    }
+    
+    // Blit the cached HUD
+    render_DrawBitmapRegion(entry->bitmap, 0, 0, WORD_HUD_WIDTH, HUDHeight(mode), x, y);
+}
+
 /*============================================================*/
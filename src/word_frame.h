@@ -28,18 +28,36 @@ typedef enum {
 } HUD_MODE;
 
 /**********************************************************//**
- * @brief Initializes the word_frame module.
+ * @brief Queues the HUD images on the background loader so
+ * that they are decoded while the game starts up.
+ **************************************************************/
+extern void wordFrame_Preload(void);
+
+/**********************************************************//**
+ * @brief Initializes the word_frame module, moving the HUD
+ * images into the atlas. This must be called from the thread
+ * that owns the display, after the loader has finished.
  **************************************************************/
 extern void wordFrame_Initialize(void);
 
 /**********************************************************//**
- * @brief Draw the word's heads-up display.
+ * @brief Releases the HUD images. HUDs must not be drawn
+ * afterwards.
+ **************************************************************/
+extern void wordFrame_Destroy(void);
+
+/**********************************************************//**
+ * @brief Draw the word's heads-up display. The HUD is rendered
+ * into a cache the first time and only re-rendered when the
+ * word's version, flags, mode or selection or the theme change,
+ * writing its labels first if they are older than the word.
  * @param word: The word to display.
  * @param x: The x position of the frame.
  * @param y: The y position of the frame.
  * @param mode: The kind of HUD to draw.
+ * @param selected: Whether the HUD is tinted as selected.
  **************************************************************/
-extern void wordFrame_DrawHUD(const WORD *word, int x, int y, HUD_MODE mode, bool selected);
+extern void wordFrame_DrawHUD(WORD *word, int x, int y, HUD_MODE mode, bool selected);
 
 /*============================================================*/
 #endif // _WORD_FRAME_H_
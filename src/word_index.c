@@ -0,0 +1,799 @@
+/**********************************************************//**
+ * @file word_index.c
+ * @brief Implementation of the dictionary index.
+ **************************************************************/
+
+// Standard library
+#include <stddef.h>         // size_t
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint16_t, uint32_t, uint64_t
+#include <stdlib.h>         // malloc, calloc, realloc, free
+#include <string.h>         // strlen, memcpy, memset
+
+// This project
+#include "debug.h"          // eprintf
+#include "word_index.h"     // WORD_INDEX
+#include "word.h"           // word_WalkDictionary
+#include "language.h"       // LANGUAGE
+#include "technique.h"      // N_TECHNIQUES
+
+//**************************************************************
+// First set of each kind. Lengths and ranks are ordered, so
+// their sets hold every word at least that long or good, and a
+// range is one set without another.
+#define SET_LENGTH 0                                ///< Words by least length.
+#define SET_RANK (SET_LENGTH + N_WORD_LENGTHS)      ///< Words by least rank.
+#define SET_TECHNIQUE (SET_RANK + N_RANKS)          ///< Words by technique.
+#define N_SETS (SET_TECHNIQUE + N_TECHNIQUES)       ///< Number of sets.
+
+// Sets are split into chunks of word numbers
+#define CHUNK_SIZE 65536                ///< Word numbers in one chunk.
+#define CHUNK_WORDS (CHUNK_SIZE/64)     ///< 64-bit words in a chunk bitmap.
+#define MAX_ARRAY (CHUNK_SIZE/16)       ///< Most members kept as a list.
+
+/// Bits of a word number, which is sorted with its base stats.
+#define ID_BITS 24
+
+/**********************************************************//**
+ * @struct CONTAINER
+ * @brief The members of one set in one chunk. Sparse chunks
+ * list their members, which is smaller than a bitmap when there
+ * are at most MAX_ARRAY of them; dense chunks are a bitmap.
+ **************************************************************/
+typedef struct {
+    int count;          ///< Members in the chunk.
+    uint16_t *array;    ///< Sorted members, if sparse.
+    uint64_t *bits;     ///< Bitmap of members, if dense.
+} CONTAINER;
+
+/**********************************************************//**
+ * @struct STAT_POINT
+ * @brief Base stats of some words of one rank, as a point in a
+ * k-d tree. Base stats repeat a lot, so each point is shared by
+ * every word with them.
+ **************************************************************/
+typedef struct {
+    uint32_t first;             ///< First of the words in the ids.
+    uint32_t count;             ///< Number of words.
+    uint8_t base[N_STATS];      ///< Their base stats.
+} STAT_POINT;
+
+/**********************************************************//**
+ * @struct WORD_INDEX
+ * @brief Stores the words, the containers of every set and a
+ * k-d tree of base stats for each rank. Each tree is implicit:
+ * the point in the middle of a range splits it, by the stat
+ * the range is most spread out in.
+ **************************************************************/
+struct WORD_INDEX {
+    int size;               ///< Words in the index.
+    int nChunks;            ///< Chunks each set is split into.
+    char *text;             ///< Every word, each ended by '\0'.
+    uint32_t *offsets;      ///< Start of each word in the text.
+    uint8_t *lengths;       ///< Letters in each word.
+    CONTAINER *containers;  ///< The chunks of each set in turn.
+    STAT_POINT *points;     ///< Every base stats, as k-d trees.
+    uint8_t *splits;        ///< Stat each point splits its range by.
+    uint32_t *ids;          ///< Words of each point, in order.
+    int trees[N_RANKS+1];   ///< First point of each rank's tree.
+};
+
+/**********************************************************//**
+ * @struct INDEX_WORD
+ * @brief What is kept about a word while an index is built.
+ **************************************************************/
+typedef struct {
+    uint8_t base[N_STATS];  ///< Base stats.
+    uint8_t rank;           ///< Rank.
+    uint8_t length;         ///< Letters.
+} INDEX_WORD;
+
+/**********************************************************//**
+ * @struct INDEX_BUILD
+ * @brief The words found so far while an index is built. Each
+ * set lists its members in order, as they are numbered in the
+ * order they are found.
+ **************************************************************/
+typedef struct {
+    char *text;                 ///< Every word, each ended by '\0'.
+    size_t used;                ///< Bytes of text used.
+    size_t capacity;            ///< Bytes of text allocated.
+    uint32_t *offsets;          ///< Start of each word.
+    INDEX_WORD *words;          ///< What is kept about each word.
+    int count;                  ///< Number of words.
+    int capacityOffsets;        ///< Offsets allocated.
+    int capacityWords;          ///< Words allocated.
+    uint32_t *members[N_SETS];  ///< Members of each set.
+    int nMembers[N_SETS];       ///< Number of members of each set.
+    int capacityMembers[N_SETS];///< Members allocated for each set.
+    bool failed;                ///< Whether memory ran out.
+} INDEX_BUILD;
+
+/**********************************************************//**
+ * @brief Grows an array if it is full.
+ * @param array: The array to grow.
+ * @param capacity: Number of elements allocated, updated.
+ * @param count: Number of elements used.
+ * @param size: Size of one element.
+ * @return Whether there is room for one more element.
+ **************************************************************/
+static bool Reserve(void **array, int *capacity, int count, size_t size) {
+    if (count < *capacity) {
+        return true;
+    }
+    int grown = 2*(*capacity) + 1024;
+    void *resized = realloc(*array, grown*size);
+    if (!resized) {
+        return false;
+    }
+    *array = resized;
+    *capacity = grown;
+    return true;
+}
+
+/*============================================================*
+ * Finding the words
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Adds a word to one set being built.
+ * @param build: The index being built.
+ * @param set: The set to add to.
+ * @param id: The number of the word.
+ **************************************************************/
+static void AddMember(INDEX_BUILD *build, int set, uint32_t id) {
+    if (!Reserve((void **)&build->members[set], &build->capacityMembers[set], build->nMembers[set], sizeof(uint32_t))) {
+        build->failed = true;
+        return;
+    }
+    build->members[set][build->nMembers[set]++] = id;
+}
+
+/**********************************************************//**
+ * @brief Adds a dictionary word to the index being built.
+ * @param data: The INDEX_BUILD.
+ * @param text: The lowercase word.
+ * @param word: The word made from it.
+ * @param length: Letters in the word.
+ **************************************************************/
+static void AddWord(void *data, const char *text, const WORD *word, int length) {
+    INDEX_BUILD *build = data;
+    if (build->failed) {
+        return;
+    }
+    
+    // Keep the text
+    size_t bytes = strlen(text) + 1;
+    if (build->used + bytes > build->capacity) {
+        size_t capacity = 2*build->capacity + bytes;
+        char *grown = realloc(build->text, capacity);
+        if (!grown) {
+            build->failed = true;
+            return;
+        }
+        build->text = grown;
+        build->capacity = capacity;
+    }
+    if (!Reserve((void **)&build->offsets, &build->capacityOffsets, build->count, sizeof(uint32_t))
+            || !Reserve((void **)&build->words, &build->capacityWords, build->count, sizeof(INDEX_WORD))) {
+        build->failed = true;
+        return;
+    }
+    memcpy(build->text + build->used, text, bytes);
+    build->offsets[build->count] = build->used;
+    build->used += bytes;
+    INDEX_WORD *kept = &build->words[build->count];
+    for (int i = 0; i < N_STATS; i++) {
+        kept->base[i] = word->base[i];
+    }
+    kept->rank = word->rank;
+    kept->length = length;
+    
+    // The word is in the sets of every length and rank up to
+    // its own, and of its techniques
+    uint32_t id = build->count++;
+    for (int i = MIN_WORD_LENGTH; i <= length; i++) {
+        AddMember(build, SET_LENGTH + i - MIN_WORD_LENGTH, id);
+    }
+    for (int i = RANK_F; i <= (int)word->rank; i++) {
+        AddMember(build, SET_RANK + i, id);
+    }
+    for (int i = 0; i < word->nTechs; i++) {
+        AddMember(build, SET_TECHNIQUE + word->techs[i], id);
+    }
+}
+
+/*============================================================*
+ * Creating an index
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Makes the containers of one set from its members.
+ * @param containers: Gets the chunks of the set.
+ * @param nChunks: Number of chunks.
+ * @param members: The members, in order.
+ * @param count: Number of members.
+ * @return Whether there was enough memory.
+ **************************************************************/
+static bool BuildSet(CONTAINER *containers, int nChunks, const uint32_t *members, int count) {
+    int i = 0;
+    for (int c = 0; c < nChunks; c++) {
+        // Find the members in this chunk
+        int start = i;
+        while (i < count && members[i] / CHUNK_SIZE == (uint32_t)c) {
+            i++;
+        }
+        CONTAINER *container = &containers[c];
+        container->count = i - start;
+        if (container->count == 0) {
+            continue;
+        }
+        
+        // List the members or set their bits
+        if (container->count <= MAX_ARRAY) {
+            container->array = malloc(container->count*sizeof(uint16_t));
+            if (!container->array) {
+                return false;
+            }
+            for (int j = start; j < i; j++) {
+                container->array[j - start] = members[j] % CHUNK_SIZE;
+            }
+        } else {
+            container->bits = calloc(CHUNK_WORDS, sizeof(uint64_t));
+            if (!container->bits) {
+                return false;
+            }
+            for (int j = start; j < i; j++) {
+                uint32_t low = members[j] % CHUNK_SIZE;
+                container->bits[low / 64] |= (uint64_t)1 << (low % 64);
+            }
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Moves the point that would be at some position if a
+ * range were sorted by one stat there, with no greater point
+ * before it and no smaller one after.
+ * @param points: The points.
+ * @param start: The first point of the range.
+ * @param end: One past the last point of the range.
+ * @param middle: The position to fill.
+ * @param stat: The stat to order by.
+ **************************************************************/
+static void Select(STAT_POINT *points, int start, int end, int middle, int stat) {
+    // Hoare partitioning, which splits runs of equal stats
+    // evenly, as base stats repeat a lot
+    while (end - start > 1) {
+        int pivot = points[start + (end - start) / 2].base[stat];
+        int i = start;
+        int j = end - 1;
+        while (i <= j) {
+            while (points[i].base[stat] < pivot) {
+                i++;
+            }
+            while (points[j].base[stat] > pivot) {
+                j--;
+            }
+            if (i <= j) {
+                STAT_POINT swap = points[i];
+                points[i++] = points[j];
+                points[j--] = swap;
+            }
+        }
+        if (middle <= j) {
+            end = j + 1;
+        } else if (middle >= i) {
+            start = i;
+        } else {
+            return;
+        }
+    }
+}
+
+/**********************************************************//**
+ * @brief Arranges a range of points into a k-d tree.
+ * @param index: The index being built.
+ * @param start: The first point of the range.
+ * @param end: One past the last point of the range.
+ **************************************************************/
+static void BuildTree(WORD_INDEX *index, int start, int end) {
+    while (start < end) {
+        // Split by the stat with the widest spread
+        int low[N_STATS] = {MAX_BASE_STAT, MAX_BASE_STAT, MAX_BASE_STAT, MAX_BASE_STAT};
+        int high[N_STATS] = {0};
+        for (int i = start; i < end; i++) {
+            for (int j = 0; j < N_STATS; j++) {
+                if (index->points[i].base[j] < low[j]) {
+                    low[j] = index->points[i].base[j];
+                }
+                if (index->points[i].base[j] > high[j]) {
+                    high[j] = index->points[i].base[j];
+                }
+            }
+        }
+        int stat = 0;
+        for (int j = 1; j < N_STATS; j++) {
+            if (high[j] - low[j] > high[stat] - low[stat]) {
+                stat = j;
+            }
+        }
+        
+        // The middle point splits the range
+        int middle = start + (end - start) / 2;
+        Select(index->points, start, end, middle, stat);
+        index->splits[middle] = stat;
+        BuildTree(index, start, middle);
+        start = middle + 1;
+    }
+}
+
+/**********************************************************//**
+ * @brief Orders keys for qsort.
+ * @param a: The first key.
+ * @param b: The second key.
+ * @return Which key comes first.
+ **************************************************************/
+static int CompareKeys(const void *a, const void *b) {
+    uint64_t left = *(const uint64_t *)a;
+    uint64_t right = *(const uint64_t *)b;
+    return (left > right) - (left < right);
+}
+
+/**********************************************************//**
+ * @brief Builds a k-d tree of the base stats of each rank.
+ * @param index: The index being built.
+ * @param words: What is kept about each word.
+ * @return Whether there was enough memory.
+ **************************************************************/
+static bool BuildTrees(WORD_INDEX *index, const INDEX_WORD *words) {
+    // Sort the words by rank, base stats and number
+    uint64_t *keys = malloc(index->size*sizeof(uint64_t) + 1);
+    index->ids = malloc(index->size*sizeof(uint32_t) + 1);
+    if (!keys || !index->ids) {
+        free(keys);
+        return false;
+    }
+    for (int i = 0; i < index->size; i++) {
+        uint64_t key = words[i].rank;
+        for (int j = 0; j < N_STATS; j++) {
+            key = key << 8 | words[i].base[j];
+        }
+        keys[i] = key << ID_BITS | i;
+    }
+    qsort(keys, index->size, sizeof(uint64_t), CompareKeys);
+    
+    // Each run of equal base stats in a rank is one point
+    int nPoints = 0;
+    for (int i = 0; i < index->size; i++) {
+        if (i == 0 || keys[i] >> ID_BITS != keys[i-1] >> ID_BITS) {
+            nPoints++;
+        }
+    }
+    index->points = malloc(nPoints*sizeof(STAT_POINT) + 1);
+    index->splits = malloc(nPoints + 1);
+    if (!index->points || !index->splits) {
+        free(keys);
+        return false;
+    }
+    memset(index->trees, 0, sizeof(index->trees));
+    STAT_POINT *point = index->points - 1;
+    for (int i = 0; i < index->size; i++) {
+        uint32_t id = keys[i] & ((1 << ID_BITS) - 1);
+        index->ids[i] = id;
+        if (i == 0 || keys[i] >> ID_BITS != keys[i-1] >> ID_BITS) {
+            point++;
+            point->first = i;
+            point->count = 0;
+            memcpy(point->base, words[id].base, N_STATS);
+            index->trees[words[id].rank + 1]++;
+        }
+        point->count++;
+    }
+    free(keys);
+    for (int r = 0; r < N_RANKS; r++) {
+        index->trees[r+1] += index->trees[r];
+    }
+    for (int r = 0; r < N_RANKS; r++) {
+        BuildTree(index, index->trees[r], index->trees[r+1]);
+    }
+    return true;
+}
+
+WORD_INDEX *wordIndex_Create(const LANGUAGE *language) {
+    // Make every word once
+    INDEX_BUILD build;
+    memset(&build, 0, sizeof(build));
+    if (!word_WalkDictionary(language, AddWord, &build)) {
+        eprintf("Word table has not been initialized.\n");
+        return NULL;
+    }
+    bool tooMany = build.count > 1 << ID_BITS;
+    
+    // The index keeps the text and offsets
+    WORD_INDEX *index = calloc(1, sizeof(WORD_INDEX));
+    if (index) {
+        index->size = build.count;
+        index->nChunks = (build.count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        index->text = build.text;
+        index->offsets = build.offsets;
+        index->lengths = malloc(build.count + 1);
+        index->containers = calloc(N_SETS*index->nChunks + 1, sizeof(CONTAINER));
+        build.text = NULL;
+        build.offsets = NULL;
+    }
+    bool built = index && index->lengths && index->containers && !build.failed && !tooMany;
+    for (int i = 0; built && i < build.count; i++) {
+        index->lengths[i] = build.words[i].length;
+    }
+    for (int s = 0; built && s < N_SETS; s++) {
+        built = BuildSet(&index->containers[s*index->nChunks], index->nChunks, build.members[s], build.nMembers[s]);
+    }
+    built = built && BuildTrees(index, build.words);
+    if (!built) {
+        eprintf(tooMany? "Too many words to index.\n": "Out of memory.\n");
+        wordIndex_Free(index);
+        index = NULL;
+    }
+    free(build.text);
+    free(build.offsets);
+    free(build.words);
+    for (int s = 0; s < N_SETS; s++) {
+        free(build.members[s]);
+    }
+    return index;
+}
+
+void wordIndex_Free(WORD_INDEX *index) {
+    if (index) {
+        if (index->containers) {
+            for (int i = 0; i < N_SETS*index->nChunks; i++) {
+                free(index->containers[i].array);
+                free(index->containers[i].bits);
+            }
+        }
+        free(index->containers);
+        free(index->text);
+        free(index->offsets);
+        free(index->lengths);
+        free(index->points);
+        free(index->splits);
+        free(index->ids);
+        free(index);
+    }
+}
+
+int wordIndex_GetSize(const WORD_INDEX *index) {
+    return index->size;
+}
+
+const char *wordIndex_GetText(const WORD_INDEX *index, int id) {
+    return index->text + index->offsets[id];
+}
+
+/*============================================================*
+ * Combining sets
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Keeps only the members of a container in a chunk
+ * bitmap. Whole bitmaps are combined 64 bits at a time, in a
+ * loop the compiler turns into vector instructions.
+ * @param bits: The bitmap to narrow.
+ * @param container: The members to keep.
+ * @param scratch: Room for a chunk bitmap.
+ **************************************************************/
+static void And(uint64_t *restrict bits, const CONTAINER *container, uint64_t *restrict scratch) {
+    if (container->bits) {
+        const uint64_t *restrict other = container->bits;
+        for (int i = 0; i < CHUNK_WORDS; i++) {
+            bits[i] &= other[i];
+        }
+        return;
+    }
+    
+    // Only listed members can survive, so test just those
+    memset(scratch, 0, CHUNK_WORDS*sizeof(uint64_t));
+    for (int i = 0; i < container->count; i++) {
+        uint16_t low = container->array[i];
+        scratch[low / 64] |= bits[low / 64] & ((uint64_t)1 << (low % 64));
+    }
+    memcpy(bits, scratch, CHUNK_WORDS*sizeof(uint64_t));
+}
+
+/**********************************************************//**
+ * @brief Removes the members of a container from a chunk
+ * bitmap.
+ * @param bits: The bitmap to narrow.
+ * @param container: The members to remove.
+ **************************************************************/
+static void AndNot(uint64_t *restrict bits, const CONTAINER *container) {
+    if (container->bits) {
+        const uint64_t *restrict other = container->bits;
+        for (int i = 0; i < CHUNK_WORDS; i++) {
+            bits[i] &= ~other[i];
+        }
+    } else {
+        for (int i = 0; i < container->count; i++) {
+            uint16_t low = container->array[i];
+            bits[low / 64] &= ~((uint64_t)1 << (low % 64));
+        }
+    }
+}
+
+/*============================================================*
+ * Queries
+ *============================================================*/
+void wordIndex_ClearQuery(WORD_QUERY *query) {
+    query->nTechs = 0;
+    query->minRank = RANK_F;
+    query->maxRank = RANK_S;
+    query->minLength = MIN_WORD_LENGTH;
+    query->maxLength = MAX_WORD_LENGTH;
+}
+
+/**********************************************************//**
+ * @brief Clamps the ranges of a query to the sets that exist.
+ * @param query: The query to clamp.
+ * @param clamped: Gets the clamped query.
+ * @return Whether any word could match.
+ **************************************************************/
+static bool Clamp(const WORD_QUERY *query, WORD_QUERY *clamped) {
+    *clamped = *query;
+    if (clamped->minRank < RANK_F) {
+        clamped->minRank = RANK_F;
+    }
+    if (clamped->maxRank > RANK_S) {
+        clamped->maxRank = RANK_S;
+    }
+    if (clamped->minLength < MIN_WORD_LENGTH) {
+        clamped->minLength = MIN_WORD_LENGTH;
+    }
+    if (clamped->maxLength > MAX_WORD_LENGTH) {
+        clamped->maxLength = MAX_WORD_LENGTH;
+    }
+    if (clamped->minRank > clamped->maxRank || clamped->minLength > clamped->maxLength) {
+        return false;
+    }
+    if (clamped->nTechs < 0 || clamped->nTechs > MAX_TECHNIQUES) {
+        return false;
+    }
+    for (int t = 0; t < clamped->nTechs; t++) {
+        if (clamped->techs[t] < 0 || clamped->techs[t] >= N_TECHNIQUES) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int wordIndex_Query(const WORD_INDEX *index, const WORD_QUERY *query, int *ids, int maxIds) {
+    WORD_QUERY clamped;
+    if (!Clamp(query, &clamped)) {
+        return 0;
+    }
+    int minRank = clamped.minRank;
+    int maxRank = clamped.maxRank;
+    int minLength = clamped.minLength;
+    int maxLength = clamped.maxLength;
+    
+    // Each chunk is narrowed down on its own, starting with
+    // every word in it
+    uint64_t bits[CHUNK_WORDS];
+    uint64_t scratch[CHUNK_WORDS];
+    int count = 0;
+    for (int c = 0; c < index->nChunks; c++) {
+        int inChunk = index->size - c*CHUNK_SIZE < CHUNK_SIZE? index->size - c*CHUNK_SIZE: CHUNK_SIZE;
+        memset(bits, 0xFF, inChunk / 64 * sizeof(uint64_t));
+        memset(bits + inChunk / 64, 0, (CHUNK_WORDS - inChunk / 64) * sizeof(uint64_t));
+        if (inChunk % 64) {
+            bits[inChunk / 64] = ((uint64_t)1 << (inChunk % 64)) - 1;
+        }
+        
+        // The rarest sets are the techniques, so they go first.
+        // Each range keeps the words at least its low end and
+        // drops those past its high end.
+        const CONTAINER *containers = index->containers + c;
+        for (int t = 0; t < query->nTechs; t++) {
+            And(bits, &containers[(SET_TECHNIQUE + query->techs[t])*index->nChunks], scratch);
+        }
+        if (minRank > RANK_F) {
+            And(bits, &containers[(SET_RANK + minRank)*index->nChunks], scratch);
+        }
+        if (maxRank < RANK_S) {
+            AndNot(bits, &containers[(SET_RANK + maxRank + 1)*index->nChunks]);
+        }
+        if (minLength > MIN_WORD_LENGTH) {
+            And(bits, &containers[(SET_LENGTH + minLength - MIN_WORD_LENGTH)*index->nChunks], scratch);
+        }
+        if (maxLength < MAX_WORD_LENGTH) {
+            AndNot(bits, &containers[(SET_LENGTH + maxLength + 1 - MIN_WORD_LENGTH)*index->nChunks]);
+        }
+        
+        // Read the matches out in order
+        for (int i = 0; i < CHUNK_WORDS; i++) {
+            uint64_t word = bits[i];
+            if (!ids || count >= maxIds) {
+                count += __builtin_popcountll(word);
+                continue;
+            }
+            while (word) {
+                if (count < maxIds) {
+                    ids[count] = c*CHUNK_SIZE + i*64 + __builtin_ctzll(word);
+                }
+                count++;
+                word &= word - 1;
+            }
+        }
+    }
+    return count;
+}
+
+/*============================================================*
+ * Nearest words
+ *============================================================*/
+
+/**********************************************************//**
+ * @struct NEAREST
+ * @brief A search for the words closest to some base stats.
+ **************************************************************/
+typedef struct {
+    const WORD_INDEX *index;    ///< The index to search.
+    const WORD_QUERY *filter;   ///< Words that may be found.
+    int base[N_STATS];          ///< The base stats to be close to.
+    int offsets[N_STATS];       ///< Distance to the box searched in each stat.
+    WORD_NEIGHBOR *neighbors;   ///< Closest words so far.
+    int count;                  ///< Number of words so far.
+    int max;                    ///< Most words to find.
+} NEAREST;
+
+/**********************************************************//**
+ * @brief Checks if a container has a member.
+ * @param container: The container to search.
+ * @param low: The member, within the chunk.
+ * @return Whether it is a member.
+ **************************************************************/
+static bool Has(const CONTAINER *container, uint16_t low) {
+    if (container->bits) {
+        return container->bits[low / 64] >> (low % 64) & 1;
+    }
+    int start = 0;
+    int end = container->count;
+    while (start < end) {
+        int middle = start + (end - start) / 2;
+        if (container->array[middle] < low) {
+            start = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+    return start < container->count && container->array[start] == low;
+}
+
+/**********************************************************//**
+ * @brief Checks if a word has the length and techniques a
+ * search wants. Its rank is known from the tree it is in.
+ * @param search: The search.
+ * @param id: The number of the word.
+ * @return Whether the word may be found.
+ **************************************************************/
+static bool Wanted(const NEAREST *search, uint32_t id) {
+    const WORD_INDEX *index = search->index;
+    const WORD_QUERY *filter = search->filter;
+    if (index->lengths[id] < filter->minLength || index->lengths[id] > filter->maxLength) {
+        return false;
+    }
+    for (int t = 0; t < filter->nTechs; t++) {
+        int set = SET_TECHNIQUE + filter->techs[t];
+        if (!Has(&index->containers[set*index->nChunks + id / CHUNK_SIZE], id % CHUNK_SIZE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Adds a word if it is among the closest so far. Ties
+ * go to the word first in the dictionary.
+ * @param search: The search.
+ * @param id: The number of the word.
+ * @param distance: Its distance.
+ **************************************************************/
+static void AddNeighbor(NEAREST *search, int id, int distance) {
+    WORD_NEIGHBOR *neighbors = search->neighbors;
+    int i = search->count < search->max? search->count++: search->max - 1;
+    while (i > 0 && (neighbors[i-1].distance > distance
+            || (neighbors[i-1].distance == distance && neighbors[i-1].id > id))) {
+        neighbors[i] = neighbors[i-1];
+        i--;
+    }
+    neighbors[i].id = id;
+    neighbors[i].distance = distance;
+}
+
+/**********************************************************//**
+ * @brief Searches a range of a k-d tree. The side of each
+ * split the stats are on is searched first, and the other
+ * side only if its box is closer than the furthest word found.
+ * @param search: The search.
+ * @param start: The first point of the range.
+ * @param end: One past the last point of the range.
+ * @param reach: The distance to the box of the range.
+ **************************************************************/
+static void Search(NEAREST *search, int start, int end, int reach) {
+    if (start >= end) {
+        return;
+    }
+    const WORD_INDEX *index = search->index;
+    int middle = start + (end - start) / 2;
+    const STAT_POINT *point = &index->points[middle];
+    int distance = 0;
+    for (int j = 0; j < N_STATS; j++) {
+        int difference = search->base[j] - point->base[j];
+        distance += difference*difference;
+    }
+    
+    // Only closer words, or as close and earlier, get in
+    const WORD_NEIGHBOR *worst = &search->neighbors[search->max-1];
+    for (uint32_t i = 0; i < point->count; i++) {
+        uint32_t id = index->ids[point->first + i];
+        if (search->count == search->max && (distance > worst->distance
+                || (distance == worst->distance && id > (uint32_t)worst->id))) {
+            break;
+        }
+        if (Wanted(search, id)) {
+            AddNeighbor(search, id, distance);
+        }
+    }
+    
+    // Near side first
+    int stat = index->splits[middle];
+    int split = search->base[stat] - point->base[stat];
+    if (split < 0) {
+        Search(search, start, middle, reach);
+    } else {
+        Search(search, middle + 1, end, reach);
+    }
+    
+    // The far side is at least split away in this stat
+    int offset = search->offsets[stat];
+    reach += split*split - offset*offset;
+    if (search->count == search->max && reach > worst->distance) {
+        return;
+    }
+    search->offsets[stat] = split;
+    if (split < 0) {
+        Search(search, middle + 1, end, reach);
+    } else {
+        Search(search, start, middle, reach);
+    }
+    search->offsets[stat] = offset;
+}
+
+int wordIndex_FindNearest(const WORD_INDEX *index, const WORD *word, const WORD_QUERY *filter, WORD_NEIGHBOR *neighbors, int maxNeighbors) {
+    WORD_QUERY any;
+    wordIndex_ClearQuery(&any);
+    WORD_QUERY clamped;
+    if (maxNeighbors <= 0 || !Clamp(filter? filter: &any, &clamped)) {
+        return 0;
+    }
+    
+    // Search the tree of each rank wanted
+    NEAREST search = {
+        .index = index,
+        .filter = &clamped,
+        .neighbors = neighbors,
+        .count = 0,
+        .max = maxNeighbors,
+    };
+    for (int j = 0; j < N_STATS; j++) {
+        search.base[j] = word->base[j];
+        search.offsets[j] = 0;
+    }
+    for (int r = clamped.minRank; r <= (int)clamped.maxRank; r++) {
+        Search(&search, index->trees[r], index->trees[r+1], 0);
+    }
+    return search.count;
+}
+
+/*============================================================*/
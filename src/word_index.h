@@ -0,0 +1,118 @@
+/**********************************************************//**
+ * @file word_index.h
+ * @brief Header file for searching the dictionary by what its
+ * words become. Every word is made once when the index is
+ * created, and each technique, rank and length keeps a bitmap
+ * of its words, so a query only combines bitmaps. Base stats
+ * are kept in k-d trees to find words close to each other.
+ **************************************************************/
+
+#ifndef _WORD_INDEX_H_
+#define _WORD_INDEX_H_
+
+// This project
+#include "word.h"       // RANK, MAX_TECHNIQUES
+#include "technique.h"  // TECHNIQUE
+#include "language.h"   // LANGUAGE
+
+/**********************************************************//**
+ * @struct WORD_INDEX
+ * @brief The words of a dictionary, indexed by technique, rank
+ * and length. Words are numbered from 0 in dictionary order.
+ * The contents are private to word_index.c and never change
+ * after creation.
+ **************************************************************/
+typedef struct WORD_INDEX WORD_INDEX;
+
+/**********************************************************//**
+ * @struct WORD_QUERY
+ * @brief Words to find. A word matches if it knows every
+ * technique listed and its rank and length are in range.
+ **************************************************************/
+typedef struct {
+    TECHNIQUE techs[MAX_TECHNIQUES];    ///< Techniques the word must know.
+    int nTechs;         ///< Number of techniques.
+    RANK minRank;       ///< Lowest rank.
+    RANK maxRank;       ///< Highest rank.
+    int minLength;      ///< Fewest letters.
+    int maxLength;      ///< Most letters.
+} WORD_QUERY;
+
+/**********************************************************//**
+ * @struct WORD_NEIGHBOR
+ * @brief A word with base stats close to another's.
+ **************************************************************/
+typedef struct {
+    int id;             ///< The number of the word.
+    int distance;       ///< Sum of the squared base stat differences.
+} WORD_NEIGHBOR;
+
+/**********************************************************//**
+ * @brief Creates an index over every word of a language's
+ * dictionary that is a valid WORD. The words are copied, so
+ * the dictionary may be replaced or freed afterwards.
+ * @param language: The language of the dictionary.
+ * @return The index, which must be freed with wordIndex_Free,
+ * or NULL on failure.
+ **************************************************************/
+extern WORD_INDEX *wordIndex_Create(const LANGUAGE *language);
+
+/**********************************************************//**
+ * @brief Frees an index. No thread may be querying it.
+ * @param index: The index to free. NULL is ignored.
+ **************************************************************/
+extern void wordIndex_Free(WORD_INDEX *index);
+
+/**********************************************************//**
+ * @brief Gets the number of words in an index.
+ * @param index: The index to inspect.
+ * @return The number of words.
+ **************************************************************/
+extern int wordIndex_GetSize(const WORD_INDEX *index);
+
+/**********************************************************//**
+ * @brief Gets the text of a word in an index.
+ * @param index: The index to inspect.
+ * @param id: The number of the word.
+ * @return The lowercase word, which lives as long as the
+ * index.
+ **************************************************************/
+extern const char *wordIndex_GetText(const WORD_INDEX *index, int id);
+
+/**********************************************************//**
+ * @brief Sets a query to match every word, so only the limits
+ * wanted need to be filled in.
+ * @param query: The query to clear.
+ **************************************************************/
+extern void wordIndex_ClearQuery(WORD_QUERY *query);
+
+/**********************************************************//**
+ * @brief Finds the words matching a query. This is safe to
+ * call from any thread.
+ * @param index: The index to search.
+ * @param query: The words to find.
+ * @param ids: Gets the numbers of the first matches, in
+ * dictionary order. May be NULL to only count them.
+ * @param maxIds: Most numbers to write to ids.
+ * @return The number of words matching, which may be more
+ * than maxIds.
+ **************************************************************/
+extern int wordIndex_Query(const WORD_INDEX *index, const WORD_QUERY *query, int *ids, int maxIds);
+
+/**********************************************************//**
+ * @brief Finds the words with base stats closest to a word's,
+ * such as fair opponents for it. Words with similar base stats
+ * also have a similar base stat total. This is safe to call
+ * from any thread.
+ * @param index: The index to search.
+ * @param word: The word to match.
+ * @param filter: Words that may be found, or NULL for any.
+ * @param neighbors: Gets the closest words, closest first and
+ * in dictionary order among equals.
+ * @param maxNeighbors: Most words to find.
+ * @return The number of words found.
+ **************************************************************/
+extern int wordIndex_FindNearest(const WORD_INDEX *index, const WORD *word, const WORD_QUERY *filter, WORD_NEIGHBOR *neighbors, int maxNeighbors);
+
+/*============================================================*/
+#endif // _WORD_INDEX_H_
@@ -0,0 +1,400 @@
+/**********************************************************//**
+ * @file word_sampler.c
+ * @brief Implementation of random word draws.
+ **************************************************************/
+
+// Standard library
+#include <stddef.h>         // size_t
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint32_t, uint64_t
+#include <stdlib.h>         // malloc, calloc, realloc, free
+#include <string.h>         // strlen, memcpy
+
+// This project
+#include "debug.h"          // eprintf
+#include "word_sampler.h"   // WORD_SAMPLER
+#include "word.h"           // word_WalkDictionary
+#include "language.h"       // LANGUAGE
+#include "technique.h"      // N_TECHNIQUES
+
+//**************************************************************
+// First bucket of each condition
+#define BUCKET_ANY 0                                ///< Every word.
+#define BUCKET_LENGTH (BUCKET_ANY + 1)              ///< Words by length.
+#define BUCKET_RANK (BUCKET_LENGTH + N_WORD_LENGTHS)///< Words by rank.
+#define BUCKET_TECHNIQUE (BUCKET_RANK + N_RANKS)    ///< Words by technique.
+#define N_BUCKETS (BUCKET_TECHNIQUE + N_TECHNIQUES) ///< Number of buckets.
+
+/// Most buckets one word can be in.
+#define MAX_MEMBERSHIPS (3 + MAX_TECHNIQUES)
+
+/**********************************************************//**
+ * @struct WORD_SAMPLER
+ * @brief Stores the words in every bucket a draw can be
+ * limited to. Each member of a bucket keeps the chance that it
+ * is drawn when picked, and the member drawn instead, so a
+ * weighted draw is one pick and one coin flip.
+ **************************************************************/
+struct WORD_SAMPLER {
+    int size;                   ///< Words that can be drawn.
+    char *text;                 ///< Every word, each ended by '\0'.
+    uint32_t *offsets;          ///< Start of each word in the text.
+    int starts[N_BUCKETS+1];    ///< First member of each bucket.
+    bool weighted[N_BUCKETS];   ///< Whether each bucket has any weight.
+    uint32_t *members;          ///< The word of each member.
+    uint32_t *thresholds;       ///< Chance each member is kept, or NULL.
+    uint32_t *aliases;          ///< Member in the same bucket drawn instead.
+};
+
+/**********************************************************//**
+ * @struct SAMPLE_WORD
+ * @brief What is known about a word while a sampler is built.
+ **************************************************************/
+typedef struct {
+    uint32_t buckets[MAX_MEMBERSHIPS];  ///< Buckets the word is in.
+    int nBuckets;                       ///< Number of buckets.
+    double weight;                      ///< Weight of the word.
+} SAMPLE_WORD;
+
+/**********************************************************//**
+ * @struct SAMPLE_BUILD
+ * @brief The words found so far while a sampler is built.
+ **************************************************************/
+typedef struct {
+    WORD_WEIGHT weight;         ///< Weighs each word, or NULL.
+    const void *data;           ///< Passed to weight.
+    char *text;                 ///< Every word, each ended by '\0'.
+    size_t used;                ///< Bytes of text used.
+    size_t capacity;            ///< Bytes of text allocated.
+    uint32_t *offsets;          ///< Start of each word.
+    SAMPLE_WORD *words;         ///< What is known about each word.
+    int count;                  ///< Number of words.
+    int capacityWords;          ///< Words allocated.
+    bool failed;                ///< Whether memory ran out.
+} SAMPLE_BUILD;
+
+/**********************************************************//**
+ * @brief Finds the bucket of a condition.
+ * @param by: What a draw is limited to.
+ * @param value: The length, RANK or TECHNIQUE to match.
+ * @return The bucket, or -1 if the condition can't match.
+ **************************************************************/
+static int Bucket(SAMPLE_BY by, int value) {
+    switch (by) {
+    case SAMPLE_ANY:
+        return BUCKET_ANY;
+    case SAMPLE_LENGTH:
+        return value >= MIN_WORD_LENGTH && value <= MAX_WORD_LENGTH? BUCKET_LENGTH + value - MIN_WORD_LENGTH: -1;
+    case SAMPLE_RANK:
+        return value >= 0 && value < N_RANKS? BUCKET_RANK + value: -1;
+    case SAMPLE_TECHNIQUE:
+        return value >= 0 && value < N_TECHNIQUES? BUCKET_TECHNIQUE + value: -1;
+    }
+    return -1;
+}
+
+/*============================================================*
+ * Random numbers
+ *============================================================*/
+void wordSampler_Seed(WORD_RNG *rng, uint64_t seed) {
+    rng->state = seed;
+}
+
+uint64_t wordSampler_Random(WORD_RNG *rng) {
+    // SplitMix64: any seed works, including 0
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/*============================================================*
+ * Finding the words
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Adds a dictionary word to the sampler being built.
+ * @param data: The SAMPLE_BUILD.
+ * @param text: The lowercase word.
+ * @param word: The word made from it.
+ * @param length: Letters in the word.
+ **************************************************************/
+static void AddWord(void *data, const char *text, const WORD *word, int length) {
+    SAMPLE_BUILD *build = data;
+    if (build->failed) {
+        return;
+    }
+    
+    // Make room for the word
+    size_t bytes = strlen(text) + 1;
+    if (build->used + bytes > build->capacity) {
+        size_t capacity = 2*build->capacity + bytes;
+        char *grown = realloc(build->text, capacity);
+        if (!grown) {
+            build->failed = true;
+            return;
+        }
+        build->text = grown;
+        build->capacity = capacity;
+    }
+    if (build->count == build->capacityWords) {
+        int capacity = 2*build->capacityWords + 1024;
+        uint32_t *offsets = realloc(build->offsets, capacity*sizeof(*offsets));
+        if (offsets) {
+            build->offsets = offsets;
+        }
+        SAMPLE_WORD *words = realloc(build->words, capacity*sizeof(*words));
+        if (words) {
+            build->words = words;
+        }
+        if (!offsets || !words) {
+            build->failed = true;
+            return;
+        }
+        build->capacityWords = capacity;
+    }
+    
+    // Every word is in the buckets for any word, its length,
+    // its rank and each of its techniques
+    SAMPLE_WORD *sample = &build->words[build->count];
+    sample->nBuckets = 0;
+    sample->buckets[sample->nBuckets++] = BUCKET_ANY;
+    sample->buckets[sample->nBuckets++] = Bucket(SAMPLE_LENGTH, length);
+    sample->buckets[sample->nBuckets++] = Bucket(SAMPLE_RANK, word->rank);
+    for (int i = 0; i < word->nTechs; i++) {
+        sample->buckets[sample->nBuckets++] = Bucket(SAMPLE_TECHNIQUE, word->techs[i]);
+    }
+    sample->weight = 1.0;
+    if (build->weight) {
+        sample->weight = build->weight(build->data, word);
+        if (!(sample->weight > 0.0)) {
+            sample->weight = 0.0;
+        }
+    }
+    memcpy(build->text + build->used, text, bytes);
+    build->offsets[build->count++] = build->used;
+    build->used += bytes;
+}
+
+/*============================================================*
+ * Building the alias tables
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Builds the alias table of one bucket with Vose's
+ * method. Members are split into those less likely than
+ * average and the rest; each unlikely member is paired with a
+ * likely one, which gives it the rest of its share.
+ * @param sampler: The sampler being built.
+ * @param words: What is known about each word.
+ * @param start: The first member of the bucket.
+ * @param size: Members in the bucket.
+ * @param scaled: Room for the scaled weight of each member.
+ * @param work: Room for the index of each member.
+ * @return Whether the bucket has any weight.
+ **************************************************************/
+static bool BuildAlias(WORD_SAMPLER *sampler, const SAMPLE_WORD *words, int start, int size, double *scaled, uint32_t *work) {
+    double total = 0.0;
+    for (int i = 0; i < size; i++) {
+        total += words[sampler->members[start + i]].weight;
+    }
+    if (!(total > 0.0)) {
+        return false;
+    }
+    
+    // Scale the weights so the average is 1. The unlikely
+    // members fill work from the front and the rest from the
+    // back.
+    int nSmall = 0;
+    int nLarge = 0;
+    for (int i = 0; i < size; i++) {
+        scaled[i] = words[sampler->members[start + i]].weight * size / total;
+        if (scaled[i] < 1.0) {
+            work[nSmall++] = i;
+        } else {
+            work[size - ++nLarge] = i;
+        }
+    }
+    
+    // Pair them off until one side runs out
+    uint32_t *thresholds = sampler->thresholds + start;
+    uint32_t *aliases = sampler->aliases + start;
+    while (nSmall > 0 && nLarge > 0) {
+        uint32_t small = work[--nSmall];
+        uint32_t large = work[size - nLarge];
+        thresholds[small] = scaled[small] * 4294967296.0;
+        aliases[small] = large;
+        scaled[large] -= 1.0 - scaled[small];
+        if (scaled[large] < 1.0) {
+            nLarge--;
+            work[nSmall++] = large;
+        }
+    }
+    
+    // What is left is always kept, give or take rounding
+    while (nSmall > 0) {
+        uint32_t i = work[--nSmall];
+        thresholds[i] = UINT32_MAX;
+        aliases[i] = i;
+    }
+    while (nLarge > 0) {
+        uint32_t i = work[size - nLarge--];
+        thresholds[i] = UINT32_MAX;
+        aliases[i] = i;
+    }
+    return true;
+}
+
+/**********************************************************//**
+ * @brief Fills every bucket and builds the alias tables.
+ * @param sampler: The sampler being built, with its words.
+ * @param words: What is known about each word.
+ * @param weighted: Whether to build the alias tables.
+ * @return Whether there was enough memory.
+ **************************************************************/
+static bool BuildBuckets(WORD_SAMPLER *sampler, const SAMPLE_WORD *words, bool weighted) {
+    // Count the members of each bucket, then where they start
+    int counts[N_BUCKETS] = {0};
+    for (int i = 0; i < sampler->size; i++) {
+        for (int j = 0; j < words[i].nBuckets; j++) {
+            counts[words[i].buckets[j]]++;
+        }
+    }
+    int largest = 0;
+    sampler->starts[0] = 0;
+    for (int b = 0; b < N_BUCKETS; b++) {
+        sampler->starts[b+1] = sampler->starts[b] + counts[b];
+        if (counts[b] > largest) {
+            largest = counts[b];
+        }
+    }
+    
+    // Words go into their buckets in order
+    int total = sampler->starts[N_BUCKETS];
+    sampler->members = malloc(total*sizeof(uint32_t) + 1);
+    if (!sampler->members) {
+        return false;
+    }
+    int next[N_BUCKETS];
+    memcpy(next, sampler->starts, sizeof(next));
+    for (int i = 0; i < sampler->size; i++) {
+        for (int j = 0; j < words[i].nBuckets; j++) {
+            sampler->members[next[words[i].buckets[j]]++] = i;
+        }
+    }
+    if (!weighted) {
+        return true;
+    }
+    
+    // One alias table per bucket
+    sampler->thresholds = malloc(total*sizeof(uint32_t) + 1);
+    sampler->aliases = malloc(total*sizeof(uint32_t) + 1);
+    double *scaled = malloc(largest*sizeof(double) + 1);
+    uint32_t *work = malloc(largest*sizeof(uint32_t) + 1);
+    bool built = sampler->thresholds && sampler->aliases && scaled && work;
+    for (int b = 0; built && b < N_BUCKETS; b++) {
+        sampler->weighted[b] = BuildAlias(sampler, words, sampler->starts[b], counts[b], scaled, work);
+    }
+    free(scaled);
+    free(work);
+    return built;
+}
+
+/*============================================================*
+ * Creating a sampler
+ *============================================================*/
+WORD_SAMPLER *wordSampler_Create(const LANGUAGE *language, WORD_WEIGHT weight, const void *data) {
+    // Find every word that can be drawn
+    SAMPLE_BUILD build = {
+        .weight = weight,
+        .data = data,
+        .text = NULL,
+        .used = 0,
+        .capacity = 0,
+        .offsets = NULL,
+        .words = NULL,
+        .count = 0,
+        .capacityWords = 0,
+        .failed = false,
+    };
+    if (!word_WalkDictionary(language, AddWord, &build)) {
+        eprintf("Word table has not been initialized.\n");
+        return NULL;
+    }
+    
+    // The sampler keeps the text and offsets
+    WORD_SAMPLER *sampler = calloc(1, sizeof(WORD_SAMPLER));
+    if (sampler) {
+        sampler->size = build.count;
+        sampler->text = build.text;
+        sampler->offsets = build.offsets;
+        build.text = NULL;
+        build.offsets = NULL;
+    }
+    if (!sampler || build.failed || !BuildBuckets(sampler, build.words, weight != NULL)) {
+        eprintf("Out of memory.\n");
+        wordSampler_Free(sampler);
+        sampler = NULL;
+    }
+    free(build.text);
+    free(build.offsets);
+    free(build.words);
+    return sampler;
+}
+
+void wordSampler_Free(WORD_SAMPLER *sampler) {
+    if (sampler) {
+        free(sampler->text);
+        free(sampler->offsets);
+        free(sampler->members);
+        free(sampler->thresholds);
+        free(sampler->aliases);
+        free(sampler);
+    }
+}
+
+/*============================================================*
+ * Drawing words
+ *============================================================*/
+int wordSampler_Count(const WORD_SAMPLER *sampler, SAMPLE_BY by, int value) {
+    int bucket = Bucket(by, value);
+    return bucket < 0? 0: sampler->starts[bucket+1] - sampler->starts[bucket];
+}
+
+const char *wordSampler_Draw(const WORD_SAMPLER *sampler, WORD_RNG *rng, SAMPLE_BY by, int value) {
+    int bucket = Bucket(by, value);
+    if (bucket < 0 || sampler->starts[bucket] == sampler->starts[bucket+1]) {
+        return NULL;
+    }
+    
+    // Scale the high half of the number to the bucket size,
+    // which is unbiased enough for any bucket that fits
+    uint64_t size = sampler->starts[bucket+1] - sampler->starts[bucket];
+    uint32_t pick = ((wordSampler_Random(rng) >> 32) * size) >> 32;
+    uint32_t word = sampler->members[sampler->starts[bucket] + pick];
+    return sampler->text + sampler->offsets[word];
+}
+
+const char *wordSampler_DrawWeighted(const WORD_SAMPLER *sampler, WORD_RNG *rng, SAMPLE_BY by, int value) {
+    if (!sampler->thresholds) {
+        return wordSampler_Draw(sampler, rng, by, value);
+    }
+    int bucket = Bucket(by, value);
+    if (bucket < 0 || !sampler->weighted[bucket]) {
+        return NULL;
+    }
+    
+    // The high half picks a member and the low half decides
+    // whether to keep it or take its alias
+    int start = sampler->starts[bucket];
+    uint64_t size = sampler->starts[bucket+1] - start;
+    uint64_t random = wordSampler_Random(rng);
+    uint32_t pick = ((random >> 32) * size) >> 32;
+    if ((uint32_t)random >= sampler->thresholds[start + pick]) {
+        pick = sampler->aliases[start + pick];
+    }
+    uint32_t word = sampler->members[start + pick];
+    return sampler->text + sampler->offsets[word];
+}
+
+/*============================================================*/
@@ -0,0 +1,129 @@
+/**********************************************************//**
+ * @file word_sampler.h
+ * @brief Header file for drawing random real words, such as
+ * enemies and loot. Draws can be limited to a length, rank or
+ * technique and weighted, and each takes constant time: the
+ * words for every condition, and an alias table to weight
+ * them, are found once when the sampler is created.
+ **************************************************************/
+
+#ifndef _WORD_SAMPLER_H_
+#define _WORD_SAMPLER_H_
+
+// Standard library
+#include <stdint.h>     // uint64_t
+
+// This project
+#include "word.h"       // WORD, RANK
+#include "language.h"   // LANGUAGE
+
+/**********************************************************//**
+ * @struct WORD_RNG
+ * @brief State of a random number generator. Each thread
+ * drawing words should have its own.
+ **************************************************************/
+typedef struct {
+    uint64_t state;     ///< Advances with every number drawn.
+} WORD_RNG;
+
+/**********************************************************//**
+ * @enum SAMPLE_BY
+ * @brief What a draw is limited to.
+ **************************************************************/
+typedef enum {
+    SAMPLE_ANY,         ///< Any word.
+    SAMPLE_LENGTH,      ///< Words with a number of letters.
+    SAMPLE_RANK,        ///< Words of a RANK.
+    SAMPLE_TECHNIQUE,   ///< Words that know a TECHNIQUE.
+} SAMPLE_BY;
+
+/**********************************************************//**
+ * @struct WORD_SAMPLER
+ * @brief Draws random words from a dictionary. The contents
+ * are private to word_sampler.c and never change after
+ * creation.
+ **************************************************************/
+typedef struct WORD_SAMPLER WORD_SAMPLER;
+
+/**********************************************************//**
+ * @brief Weighs a word for weighted draws.
+ * @param data: Data given to wordSampler_Create.
+ * @param word: The word, made at MIN_LEVEL.
+ * @return The weight, which can't be negative. Words weighing
+ * 0 are never drawn by wordSampler_DrawWeighted.
+ **************************************************************/
+typedef double (*WORD_WEIGHT)(const void *data, const WORD *word);
+
+/**********************************************************//**
+ * @brief Seeds a random number generator.
+ * @param rng: The generator to seed.
+ * @param seed: Any number. The same seed gives the same draws.
+ **************************************************************/
+extern void wordSampler_Seed(WORD_RNG *rng, uint64_t seed);
+
+/**********************************************************//**
+ * @brief Draws a random number.
+ * @param rng: The generator to draw from.
+ * @return A uniformly random 64-bit number.
+ **************************************************************/
+extern uint64_t wordSampler_Random(WORD_RNG *rng);
+
+/**********************************************************//**
+ * @brief Creates a sampler over every word of a language's
+ * dictionary that is a valid WORD. Only the text and weight
+ * of each word are kept, and the dictionary isn't needed once
+ * this returns.
+ * @param language: The language to draw words from.
+ * @param weight: Weighs each word, or NULL if only uniform
+ * draws will be made.
+ * @param data: Passed to weight.
+ * @return The sampler, which must be freed with
+ * wordSampler_Free, or NULL on failure.
+ **************************************************************/
+extern WORD_SAMPLER *wordSampler_Create(const LANGUAGE *language, WORD_WEIGHT weight, const void *data);
+
+/**********************************************************//**
+ * @brief Frees a sampler. No thread may be drawing from it.
+ * @param sampler: The sampler to free. NULL is ignored.
+ **************************************************************/
+extern void wordSampler_Free(WORD_SAMPLER *sampler);
+
+/**********************************************************//**
+ * @brief Counts the words a draw can give.
+ * @param sampler: The sampler to inspect.
+ * @param by: What the draw is limited to.
+ * @param value: The length, RANK or TECHNIQUE to match.
+ * Ignored for SAMPLE_ANY.
+ * @return The number of words.
+ **************************************************************/
+extern int wordSampler_Count(const WORD_SAMPLER *sampler, SAMPLE_BY by, int value);
+
+/**********************************************************//**
+ * @brief Draws a word, with every matching word equally
+ * likely. This is safe to call from any thread.
+ * @param sampler: The sampler to draw from.
+ * @param rng: The caller's random number generator.
+ * @param by: What the draw is limited to.
+ * @param value: The length, RANK or TECHNIQUE to match.
+ * Ignored for SAMPLE_ANY.
+ * @return The lowercase word, which lives as long as the
+ * sampler, or NULL if no word matches.
+ **************************************************************/
+extern const char *wordSampler_Draw(const WORD_SAMPLER *sampler, WORD_RNG *rng, SAMPLE_BY by, int value);
+
+/**********************************************************//**
+ * @brief Draws a word, with matching words as likely as their
+ * weight. Samplers made without a weight draw uniformly. This
+ * is safe to call from any thread.
+ * @param sampler: The sampler to draw from.
+ * @param rng: The caller's random number generator.
+ * @param by: What the draw is limited to.
+ * @param value: The length, RANK or TECHNIQUE to match.
+ * Ignored for SAMPLE_ANY.
+ * @return The lowercase word, or NULL if no matching word has
+ * any weight.
+ **************************************************************/
+extern const char *wordSampler_DrawWeighted(const WORD_SAMPLER *sampler, WORD_RNG *rng, SAMPLE_BY by, int value);
+
+/*============================================================*/
+#endif // _WORD_SAMPLER_H_
@@ -6,7 +6,7 @@
 // Standard library
 #include <stddef.h>         // size_t
 #include <stdbool.h>        // bool
-#include <string.h>         // strlen
+#include <stdint.h>         // uint32_t
 #include <math.h>           // fabs, sin
 
 // Allegro
@@ -19,8 +19,16 @@
 #include "debug.h"          // assert, eprintf
 #include "random.h"         // uniform
 #include "window.h"         // window size
+#include "glyph_table.h"    // GLYPH_TABLE
+#include "atlas.h"          // atlas_BeginBatch
+#include "redraw.h"         // redraw_Invalidate
+#include "render.h"         // render_DrawTriangles
+#include "frame.h"          // frame_Interpolate
 #include "word.h"           // WORD
+#include "letter_system.h"  // LETTER_SYSTEM
+#include "resource.h"       // resource_LoadFont, resource_Release
 #include "word_sprite.h"    // WORD_SPRITE
+#include "profile.h"        // PROFILE_ZONE
 
 //**************************************************************
 #define SPACING 12      ///< Spacing between word letters.
@@ -30,64 +38,243 @@
 /// Font to use when drawing words.
 static ALLEGRO_FONT *GlobalFont;   
 
+/// Measurements of the word font.
+static GLYPH_TABLE GlobalGlyphs;
+
+//**************************************************************
+/// Maximum number of sprites loaded at once.
+#define MAX_SPRITES 256
+
+/// Letters of every loaded sprite.
+static LETTER_SYSTEM GlobalLetters;
+
+/// Sprite owning each block of the letter system.
+static WORD_SPRITE *GlobalOwners[MAX_SPRITES];
+
+//**************************************************************
+/// Number of samples in one period of the idle wave. This must
+/// be a power of two.
+#define IDLE_STEPS 1024
+
+/// Bits of the idle phase below the wave table index, for
+/// IDLE_STEPS of 2^10.
+#define IDLE_SHIFT (32 - 10)
+
+/// Length of one period of the idle wave, in seconds.
+#define IDLE_PERIOD 1.0
+
+/// Letters in one period of the idle wave.
+#define IDLE_LETTERS 16
+
+/// Height of the idle wave at each step of its period.
+static float GlobalIdleWave[IDLE_STEPS];
+
+/// Phase of the idle wave, where the full range of the integer
+/// is one period so that it wraps around by itself.
+static uint32_t GlobalIdlePhase = 0;
+
+//**************************************************************
+/// Number of vertices in the two triangles of a letter.
+#define VERTICES_PER_LETTER 6
+
+/// Maximum number of letters submitted in one call.
+#define MAX_BATCH_LETTERS 1024
+
+/// Size of the letter vertex buffer.
+#define MAX_VERTICES (MAX_BATCH_LETTERS*VERTICES_PER_LETTER)
+
+/**********************************************************//**
+ * @struct LETTER_QUAD
+ * @brief Atlas texture coordinates and size of one glyph.
+ **************************************************************/
+typedef struct {
+    float u0;       ///< Left texture coordinate.
+    float v0;       ///< Top texture coordinate.
+    float u1;       ///< Right texture coordinate.
+    float v1;       ///< Bottom texture coordinate.
+    float hw;       ///< Half of the glyph width.
+    float hh;       ///< Half of the glyph height.
+    float cx;       ///< Center of the glyph right of the letter's center.
+    float cy;       ///< Center of the glyph below the letter's center.
+    bool valid;     ///< Whether the glyph is in the atlas.
+} LETTER_QUAD;
+
+/// Precomputed quad of every glyph.
+static LETTER_QUAD GlobalQuads[N_GLYPHS];
+
+/// Letter vertices waiting to be submitted.
+static ALLEGRO_VERTEX GlobalVertices[MAX_VERTICES];
+
+/// Number of vertices in the buffer.
+static int GlobalVertexCount = 0;
+
 /*============================================================*
  * Library initialization
  *============================================================*/
 void wordSprite_Initialize(void) {
-    GlobalFont = al_load_ttf_font("data/font/wordsmith.ttf", 32, ALLEGRO_TTF_MONOCHROME);
+    GlobalFont = resource_LoadFont("data/font/wordsmith.ttf", 32, ALLEGRO_TTF_MONOCHROME);
+    glyphTable_Create(&GlobalGlyphs, GlobalFont);
+    letterSystem_Create(&GlobalLetters, MAX_SPRITES);
+    
+    // Tabulate the idle wave
+    for (int i = 0; i < IDLE_STEPS; i++) {
+        GlobalIdleWave[i] = 4*(1 + sin(i*2*M_PI/IDLE_STEPS));
+    }
+    
+    // Look up where each glyph lives in the atlas
+    for (int i = 0; i < N_GLYPHS; i++) {
+        LETTER_QUAD *quad = &GlobalQuads[i];
+        ALLEGRO_BITMAP *glyph = GlobalGlyphs.glyph[i];
+        quad->valid = glyph != NULL;
+        if (glyph) {
+            int width = al_get_bitmap_width(glyph);
+            int height = al_get_bitmap_height(glyph);
+            quad->u0 = al_get_bitmap_x(glyph);
+            quad->v0 = al_get_bitmap_y(glyph);
+            quad->u1 = quad->u0 + width;
+            quad->v1 = quad->v0 + height;
+            quad->hw = width / 2.0;
+            quad->hh = height / 2.0;
+            
+            // The image only covers the ink, which sits at the
+            // glyph's bearing in the advance by line height cell
+            quad->cx = GlobalGlyphs.left[i] + quad->hw - GlobalGlyphs.advance[i] / 2.0;
+            quad->cy = GlobalGlyphs.top[i] + quad->hh - GlobalGlyphs.height / 2.0;
+        }
+    }
+}
+
+void wordSprite_Destroy(void) {
+    letterSystem_Destroy(&GlobalLetters);
+    resource_Release(GlobalFont);
+    GlobalFont = NULL;
 }
 
 static float Offset(const WORD_SPRITE *sprite, int index) {
     return (index - sprite->nLetters/2.0)*SPACING;
 }
 
+/**********************************************************//**
+ * @brief Appends the two triangles of one letter quad to the
+ * vertex buffer.
+ * @param quad: The atlas quad of the letter.
+ * @param x: Center x position of the letter.
+ * @param y: Center y position of the letter.
+ * @param cosine: Cosine of the rotation times the scaling.
+ * @param sine: Sine of the rotation times the scaling.
+ * @param color: Color of the letter.
+ **************************************************************/
+static inline void PushQuad(const LETTER_QUAD *quad, float x, float y, float cosine, float sine, ALLEGRO_COLOR color) {
+    // Rotated and scaled center and half-extents of the quad
+    x += quad->cx*cosine - quad->cy*sine;
+    y += quad->cx*sine + quad->cy*cosine;
+    float ax = quad->hw*cosine, ay = quad->hw*sine;
+    float bx = -quad->hh*sine, by = quad->hh*cosine;
+    
+    // Corners: top left, top right, bottom right, bottom left
+    ALLEGRO_VERTEX *v = &GlobalVertices[GlobalVertexCount];
+    v[0] = (ALLEGRO_VERTEX){x - ax - bx, y - ay - by, 0, quad->u0, quad->v0, color};
+    v[1] = (ALLEGRO_VERTEX){x + ax - bx, y + ay - by, 0, quad->u1, quad->v0, color};
+    v[2] = (ALLEGRO_VERTEX){x + ax + bx, y + ay + by, 0, quad->u1, quad->v1, color};
+    v[3] = v[0];
+    v[4] = v[2];
+    v[5] = (ALLEGRO_VERTEX){x - ax + bx, y - ay + by, 0, quad->u0, quad->v1, color};
+    GlobalVertexCount += VERTICES_PER_LETTER;
+}
+
+/**********************************************************//**
+ * @brief Submits every buffered letter quad in one call.
+ **************************************************************/
+static void FlushQuads(void) {
+    if (GlobalVertexCount > 0) {
+        render_DrawTriangles(GlobalVertices, GlobalVertexCount, atlas_GetBitmap());
+        GlobalVertexCount = 0;
+    }
+}
+
+/**********************************************************//**
+ * @brief Draws a letter with the font through the transform
+ * stack. Only used when the letter isn't in the atlas.
+ * @param letter: The letter to draw.
+ * @param x: Center x position of the letter.
+ * @param y: Center y position of the letter.
+ * @param rotation: Rotation in radians of the letter.
+ * @param scaling: Scaling applied to the letter.
+ * @param color: Color of the letter.
+ **************************************************************/
+static void DrawLetterText(char letter, float x, float y, float rotation, float scaling, ALLEGRO_COLOR color) {
+    // Center the letter
+    ALLEGRO_TRANSFORM transform;
+    al_identity_transform(&transform);
+    float tx = -glyphTable_Advance(&GlobalGlyphs, letter) / 2.0;
+    float ty = -GlobalGlyphs.height / 2.0;
+    al_translate_transform(&transform, tx, ty);
+    
+    // Rotate and scale the letter about its center
+    al_rotate_transform(&transform, rotation);
+    al_scale_transform(&transform, scaling, scaling);
+    
+    // Translate the letter to the proper position
+    al_translate_transform(&transform, x, y);
+    
+    // Draw with this transform
+    char string[2] = {letter, '\0'};  // Need null terminator!
+    render_DrawTransformedText(GlobalFont, color, &transform, string);
+}
+
 /*============================================================*
  * Word rendering
  *============================================================*/
 void wordSprite_Draw(const WORD_SPRITE *sprite) {
-    // Draw each letter, centering it at the declared origin
-    int fontHeight = al_get_font_line_height(GlobalFont);
-    int xDraw = sprite->x;
-    int yDraw = sprite->y - fontHeight;
+    wordSprite_DrawAll(&sprite, 1);
+}
+
+void wordSprite_DrawAll(const WORD_SPRITE *const *sprites, int count) {
+    PROFILE_ZONE("wordSprite_DrawAll");
     
-    // Old transformation matrix
-    ALLEGRO_TRANSFORM old;
-    al_copy_transform(&old, al_get_current_transform());
+    // Primitives can't be drawn while bitmap drawing is held
+    atlas_PauseBatch();
     
-    // Draw each latter
-    ALLEGRO_TRANSFORM transform;
-    char string[2] = {'\0', '\0'};  // Need null terminator!
-    for (int i = 0; i < sprite->nLetters; i++) {
-        // Get the current letter
-        const LETTER_SPRITE *current = &sprite->letters[i];
-        float x = xDraw + current->x + Offset(sprite, i);
-        float y = yDraw - current->y;
-        
-        // Get the text to draw
-        string[0] = current->letter;
-        int fontWidth = al_get_text_width(GlobalFont, string);
-        
-        // Center the letter
-        al_copy_transform(&transform, &old);
-        float tx = -fontWidth / 2.0;
-        float ty = -fontHeight / 2.0;
-        al_translate_transform(&transform, tx, ty);
-        
-        // Rotate and scale the letter about its center
-        al_rotate_transform(&transform, current->rotation);
-        al_scale_transform(&transform, current->scaling, current->scaling);
-        
-        // Translate the letter to the proper position
-        al_translate_transform(&transform, x, y);
-        
-        // Use this transformation matrix to draw the letter
-        al_use_transform(&transform);
-        ALLEGRO_COLOR color = al_map_rgba(255, 255, 255, 255*current->opacity);
-        al_draw_text(GlobalFont, color, 0, 0, ALLEGRO_ALIGN_LEFT, string);
+    // Compute every letter quad of every sprite
+    int fontHeight = GlobalGlyphs.height;
+    float alpha = frame_GetInterpolation();
+    for (int n = 0; n < count; n++) {
+        const WORD_SPRITE *sprite = sprites[n];
+        if (sprite->first < 0) {
+            continue;
+        }
+        int xDraw = sprite->x;
+        int yDraw = sprite->y - fontHeight;
+        for (int i = 0; i < sprite->nLetters; i++) {
+            // Get the current letter between the last two steps
+            int k = sprite->first + i;
+            const LETTER_SYSTEM *letters = &GlobalLetters;
+            float x = xDraw + frame_Interpolate(letters->prevX[k], letters->x[k], alpha) + Offset(sprite, i);
+            float y = yDraw - frame_Interpolate(letters->prevY[k], letters->y[k], alpha);
+            float rotation = frame_Interpolate(letters->prevRotation[k], letters->rotation[k], alpha);
+            float scaling = frame_Interpolate(letters->prevScaling[k], letters->scaling[k], alpha);
+            float opacity = frame_Interpolate(letters->prevOpacity[k], letters->opacity[k], alpha);
+            ALLEGRO_COLOR color = al_map_rgba_f(1.0, 1.0, 1.0, opacity);
+            
+            // Letters missing from the atlas are drawn on their own
+            const LETTER_QUAD *quad = &GlobalQuads[(unsigned char)sprite->letters[i] % N_GLYPHS];
+            if (!quad->valid) {
+                FlushQuads();
+                DrawLetterText(sprite->letters[i], x, y, rotation, scaling, color);
+                continue;
+            }
+            
+            // Rotate and scale the letter about its center
+            if (GlobalVertexCount + VERTICES_PER_LETTER > MAX_VERTICES) {
+                FlushQuads();
+            }
+            float cosine = cos(rotation)*scaling;
+            float sine = sin(rotation)*scaling;
+            PushQuad(quad, x, y, cosine, sine, color);
+        }
     }
-    
-    // Done drawing - restore transform
-    al_use_transform(&old);
+    FlushQuads();
+    atlas_ResumeBatch();
 }
 
 static inline void ChangeAnimation(WORD_SPRITE *sprite, WORD_ANIMATION animate) {
@@ -99,19 +286,8 @@ static inline void ChangeAnimation(WORD_SPRITE *sprite, WORD_ANIMATION animate)
 
 static inline void ResetSprite(WORD_SPRITE *sprite) {
     printf("Reset\n");
-    // Set initial X and Y positions
-    for (int i = 0; i < sprite->nLetters; i++) {
-        LETTER_SPRITE *current = &sprite->letters[i];
-        current->x = 0.0;
-        current->y = 0.0;
-        current->opacity = 1.0;
-        current->scaling = 1.0;
-        current->rotation = 0.0;
-        current->xv = 0.0;
-        current->yv = 0.0;
-        current->rv = 0.0;
-        current->sv = 0.0;
-    }
+    // Put the letters at rest at their initial positions
+    letterSystem_Reset(&GlobalLetters, sprite->first, sprite->nLetters);
 }
 
 static inline float Period(const WORD_SPRITE *sprite, float period) {
@@ -122,9 +298,9 @@ static inline float Tilt(const WORD_SPRITE *sprite, int index) {
     return 2*(index / (float)(sprite->nLetters - 1)) - 1;
 }
 
-static inline float IdleHeight(const WORD_SPRITE *sprite, int index) {
-    float period = fmod(al_get_time(), 1.0);
-    return 4*(1 + sin((period + index/16.0)*2*M_PI));
+static inline float IdleHeight(int index) {
+    int step = (GlobalIdlePhase >> IDLE_SHIFT) + index*(IDLE_STEPS/IDLE_LETTERS);
+    return GlobalIdleWave[step & (IDLE_STEPS - 1)];
 }
 
 static inline bool SpriteAlignLeft(const WORD_SPRITE *sprite) {
@@ -138,9 +314,9 @@ static bool AnimateIdle(WORD_SPRITE *sprite, float dt) {
     (void)dt;
     
     // Animate a sine wave for the motion.
+    float *y = &GlobalLetters.y[sprite->first];
     for (int i = 0; i < sprite->nLetters; i++) {
-        LETTER_SPRITE *current = &sprite->letters[i];
-        current->y = IdleHeight(sprite, i);
+        y[i] = IdleHeight(i);
     }
     return true;
 }
@@ -149,56 +325,48 @@ static bool AnimateIdle(WORD_SPRITE *sprite, float dt) {
  * Explosion animation
  *============================================================*/
 static bool AnimateExplode(WORD_SPRITE *sprite, float dt) {
+    (void)dt;
+    
     // Check if this is the first time the animation
     // has played for this sprite, or whether we are
     // continuing.
     const float MAX_TIME = 2.0;
-    float phase = sprite->timer;
-    if (phase >= MAX_TIME) {
+    LETTER_SYSTEM *letters = &GlobalLetters;
+    if (sprite->timer >= MAX_TIME) {
         // Hide the sprite
+        letterSystem_Reset(letters, sprite->first, sprite->nLetters);
         for (int i = 0; i < sprite->nLetters; i++) {
-            sprite->letters[i].opacity = 0.0;
+            letters->opacity[sprite->first + i] = 0.0;
         }
         return false;
     }
     
-    // Animate the word exploding.
-    for (int i = 0; i < sprite->nLetters; i++) {
-        // Get the letter
-        LETTER_SPRITE *current = &sprite->letters[i];
-        
-        // Get the tilt of the letter within the shape.
-        // First letter is -1, middle is 0, last is +1.
-        float tilt = Tilt(sprite, i);
-        
-        // Initialize random explosion if first time.
-        if (sprite->counter == 0) {
-            current->x = 0.0;
-            current->y = IdleHeight(sprite, i);
-            current->scaling = 1.0;
-            current->rotation = 0.0;
-            current->xv = (tilt + uniform(-0.5, 0.5))*16;
-            current->yv = (2-fabs(tilt))*48;
-            current->sv = uniform(-0.5, 0.5);
-            current->rv = 2*(tilt+uniform(-0.75, 0.75));
-        }
-        
-        // Update letter with Eulerian timestep
-        current->rotation += current->rv*dt;
-        current->scaling += current->sv*dt;
-        current->opacity = 1.0 - (phase/MAX_TIME);
-        current->x += 2*current->xv*dt;
-        current->y += 2*current->yv*dt;
-        current->yv -= 128*dt;
-        current->xv -= 0.1*dt*current->xv;
-        
-        // Floor collision
-        if (current->y < 0.0) {
-            current->y = 0.0;
-            current->yv *= -0.8;
+    // Initialize random explosion. The letter system does the
+    // rest with gravity, drag and a bouncy floor.
+    if (sprite->counter == 0) {
+        for (int i = 0; i < sprite->nLetters; i++) {
+            // Get the tilt of the letter within the shape.
+            // First letter is -1, middle is 0, last is +1.
+            int k = sprite->first + i;
+            float tilt = Tilt(sprite, i);
+            letters->x[k] = 0.0;
+            letters->y[k] = IdleHeight(i);
+            letters->scaling[k] = 1.0;
+            letters->rotation[k] = 0.0;
+            letters->opacity[k] = 1.0;
+            letters->xv[k] = (tilt + uniform(-0.5, 0.5))*16;
+            letters->yv[k] = (2-fabs(tilt))*48;
+            letters->sv[k] = uniform(-0.5, 0.5);
+            letters->rv[k] = 2*(tilt+uniform(-0.75, 0.75));
+            letters->ov[k] = -1.0/MAX_TIME;
+            letters->speed[k] = 2.0;
+            letters->gravity[k] = 128.0;
+            letters->drag[k] = 0.1;
+            letters->floor[k] = 0.0;
+            letters->bounce[k] = -0.8;
         }
+        sprite->counter = 1;
     }
-    sprite->counter = 1;
     return true;
 }
 
@@ -206,29 +374,29 @@ static bool AnimateExplode(WORD_SPRITE *sprite, float dt) {
  * Jumping animation
  *============================================================*/
 static bool AnimateJump(WORD_SPRITE *sprite, float dt) {
+    (void)dt;
+    
     // Stop jumping check.
+    LETTER_SYSTEM *letters = &GlobalLetters;
     int nDown = 0;
     for (int i = 0; i < sprite->nLetters; i++) {
-        // Get the letter
-        LETTER_SPRITE *current = &sprite->letters[i];
+        int k = sprite->first + i;
         
         // Make letters jump one-by-one.
-        // This depends on the time step precision.
+        // Steps are fixed, so this is the same at any frame rate.
         if (i == sprite->counter && sprite->timer > i*0.05) {
-            current->yv = 32;
+            letters->yv[k] = 32;
             sprite->counter++;
         }
         
-        // Update letter with Eulerian timestep
-        current->y += 4*current->yv*dt;
-        current->yv -= 128*dt;
-        
-        // Floor collision (coincide with idle animation)
-        float idle = IdleHeight(sprite, i);
-        if (current->y <= idle) {
-            current->y = idle;
+        // Land on the idle animation
+        float idle = IdleHeight(i);
+        if (letters->y[k] <= letters->floor[k]) {
             nDown++;
         }
+        letters->speed[k] = 4.0;
+        letters->gravity[k] = 128.0;
+        letters->floor[k] = idle;
     }
     
     // Stop animating check
@@ -243,33 +411,38 @@ static bool AnimateJump(WORD_SPRITE *sprite, float dt) {
  * Switching-in animation
  *============================================================*/
 static bool AnimateEnter(WORD_SPRITE *sprite, float dt) {
+    (void)dt;
+    
     // Animation constants
     const float MAX_TIME = 0.5;
     
     // Initialize drop height
+    LETTER_SYSTEM *letters = &GlobalLetters;
     if (sprite->counter == 0) {
         ResetSprite(sprite);
         for (int i = 0; i < sprite->nLetters; i++) {
-            LETTER_SPRITE *current = &sprite->letters[i];
-            current->y = 60;
-            current->yv = 0;
-            current->opacity = 0.0;
+            int k = sprite->first + i;
+            letters->y[k] = 60;
+            letters->opacity[k] = 0.0;
         }
         sprite->counter = 1;
     }
     
-    // Drop letters
+    // Drop letters. The velocity is in pixels per frame at
+    // 60 frames per second.
     int nDrop = (int)(sprite->nLetters * sprite->timer / MAX_TIME);
-    for (int i = 0; i < nDrop; i++) {
-        LETTER_SPRITE *current = &sprite->letters[i];
-        current->yv -= 256*dt;
-        current->y += current->yv;
-        float idle = IdleHeight(sprite, i);
-        if (current->y < idle) {
-            current->y = idle;
-            current->opacity = 1.0;
-        } else if (current->y > 30) {
-            current->opacity = 1.0 - (current->y - 30.0)/30.0;
+    for (int i = 0; i < nDrop && i < sprite->nLetters; i++) {
+        int k = sprite->first + i;
+        letters->speed[k] = 60.0;
+        letters->gravity[k] = 256.0;
+        letters->floor[k] = IdleHeight(i);
+        
+        // Fade in as the letter falls
+        float y = letters->y[k];
+        if (y > 30) {
+            letters->opacity[k] = 1.0 - (y - 30.0)/30.0;
+        } else {
+            letters->opacity[k] = 1.0;
         }
     }
     
@@ -285,6 +458,8 @@ static bool AnimateEnter(WORD_SPRITE *sprite, float dt) {
  * Switching-out animation
  *============================================================*/
 static bool AnimateExit(WORD_SPRITE *sprite, float dt) {
+    (void)dt;
+    
     // Animation time
     const float MAX_TIME = 2.0;
     
@@ -298,59 +473,158 @@ static bool AnimateExit(WORD_SPRITE *sprite, float dt) {
     }
     
     // Escape animation
+    LETTER_SYSTEM *letters = &GlobalLetters;
+    if (sprite->counter == 0) {
+        // Fade out from the start
+        for (int i = 0; i < sprite->nLetters; i++) {
+            letters->ov[sprite->first + i] = -1.0/MAX_TIME;
+        }
+    }
     for (int i = 0; i < sprite->nLetters; i++) {
-        // Get the letter
-        LETTER_SPRITE *current = &sprite->letters[i];
+        int k = sprite->first + i;
         
         // Make letters jump one-by-one.
-        // This depends on the time step precision.
+        // Steps are fixed, so this is the same at any frame rate.
         if (i == sprite->counter && sprite->timer > i*0.1) {
-            current->xv = (escapeX - (sprite->x + current->x + Offset(sprite, i))) / MAX_TIME;
-            current->yv = (escapeY - (sprite->y + IdleHeight(sprite, i))) / MAX_TIME;
-            current->rv = current->xv / 16.0;
-            current->sv = -0.1;
+            letters->xv[k] = (escapeX - (sprite->x + letters->x[k] + Offset(sprite, i))) / MAX_TIME;
+            letters->yv[k] = (escapeY - (sprite->y + IdleHeight(i))) / MAX_TIME;
+            letters->rv[k] = letters->xv[k] / 16.0;
+            letters->sv[k] = -0.1;
+            letters->speed[k] = 2.0;
             sprite->counter++;
         }
-        
-        // Update letter with Eulerian timestep
-        current->rotation += current->rv*dt;
-        current->scaling += current->sv*dt;
-        current->opacity = 1.0 - (sprite->timer/MAX_TIME);
-        current->x += 2*current->xv*dt;
-        current->y += 2*current->yv*dt;
     }
     return sprite->timer < MAX_TIME;
 }
 
+/**********************************************************//**
+ * @brief Marks the area covered by one letter as needing a
+ * redraw.
+ * @param sprite: The sprite of the letter.
+ * @param index: Index of the letter in the sprite.
+ * @param x: X offset of the letter.
+ * @param y: Y offset of the letter.
+ * @param scaling: Scaling of the letter.
+ **************************************************************/
+static void InvalidateLetter(const WORD_SPRITE *sprite, int index, float x, float y, float scaling) {
+    // Conservative radius of a rotated letter
+    float size = GlobalGlyphs.height;
+    float r = size*fabs(scaling);
+    float xDraw = sprite->x + x + Offset(sprite, index);
+    float yDraw = sprite->y - size - y;
+    redraw_Invalidate(xDraw - r, yDraw - r, 2*r + 1, 2*r + 1);
+}
+
+/**********************************************************//**
+ * @brief Marks the area covered by the sprite's visible
+ * letters as needing a redraw. Both the latest and the previous
+ * step are covered, since drawing blends between them.
+ * @param sprite: The sprite to invalidate.
+ **************************************************************/
+static void InvalidateSprite(const WORD_SPRITE *sprite) {
+    const LETTER_SYSTEM *letters = &GlobalLetters;
+    for (int i = 0; i < sprite->nLetters; i++) {
+        int k = sprite->first + i;
+        if (letters->opacity[k] > 0.0) {
+            InvalidateLetter(sprite, i, letters->x[k], letters->y[k], letters->scaling[k]);
+        }
+        if (letters->prevOpacity[k] > 0.0) {
+            InvalidateLetter(sprite, i, letters->prevX[k], letters->prevY[k], letters->prevScaling[k]);
+        }
+    }
+}
+
+/**********************************************************//**
+ * @brief Marks the area covered by every loaded sprite as
+ * needing a redraw.
+ **************************************************************/
+static void InvalidateAll(void) {
+    for (int i = 0; i < GlobalLetters.used/LETTER_BLOCK; i++) {
+        if (GlobalOwners[i]) {
+            InvalidateSprite(GlobalOwners[i]);
+        }
+    }
+}
+
 /*============================================================*
  * Sprite animation
  *============================================================*/
 bool wordSprite_Update(WORD_SPRITE *sprite, float dt) {
+    if (sprite->first < 0) {
+        return false;
+    }
+    
+    // Damage where the letters were and where they go
+    InvalidateSprite(sprite);
     sprite->timer += dt;
+    bool alive;
     switch (sprite->animate) {
     case WORD_ANIMATE_IDLE:
-        return AnimateIdle(sprite, dt);
+        alive = AnimateIdle(sprite, dt);
+        break;
     case WORD_ANIMATE_ENTER:
-        return AnimateEnter(sprite, dt);
+        alive = AnimateEnter(sprite, dt);
+        break;
     case WORD_ANIMATE_EXIT:
-        return AnimateExit(sprite, dt);
+        alive = AnimateExit(sprite, dt);
+        break;
     case WORD_ANIMATE_DIE:
-        return AnimateExplode(sprite, dt);
+        alive = AnimateExplode(sprite, dt);
+        break;
     case WORD_ANIMATE_ACTION:
-        return AnimateJump(sprite, dt);
+        alive = AnimateJump(sprite, dt);
+        break;
     default:
-        return false;
+        alive = false;
+        break;
     }
+    InvalidateSprite(sprite);
+    return alive;
+}
+
+void wordSprite_Step(float dt) {
+    // Advance the idle wave shared by every sprite
+    GlobalIdlePhase += (uint32_t)(fmod(dt/IDLE_PERIOD, 1.0)*4294967296.0);
+    
+    InvalidateAll();
+    letterSystem_Update(&GlobalLetters, dt);
+    InvalidateAll();
+}
+
+/**********************************************************//**
+ * @brief Checks whether the sprite holds a block of letters.
+ * @param sprite: The sprite to check.
+ * @return Whether the sprite owns its letters.
+ **************************************************************/
+static bool OwnsLetters(const WORD_SPRITE *sprite) {
+    int first = sprite->first;
+    return first >= 0 && first < GlobalLetters.capacity
+        && first % LETTER_BLOCK == 0
+        && GlobalOwners[first/LETTER_BLOCK] == sprite;
 }
 
 /*============================================================*
  * Word loading
  *============================================================*/
-void wordSprite_Load(WORD_SPRITE *sprite, float x, float y, const WORD *word) {
-    // Load each letter
-    int length = strlen(word->text);
-    for (int i = 0; i < length; i++) {
-        sprite->letters[i].letter = word->text[i];
+bool wordSprite_Load(WORD_SPRITE *sprite, float x, float y, const WORD *word) {
+    // Reserve the letters, reusing them when reloading
+    if (!OwnsLetters(sprite)) {
+        sprite->first = letterSystem_Allocate(&GlobalLetters);
+        if (sprite->first < 0) {
+            sprite->nLetters = 0;
+            return false;
+        }
+        GlobalOwners[sprite->first/LETTER_BLOCK] = sprite;
+    }
+    
+    // Load each letter. The glyphs are ASCII, so other UTF-8
+    // letters are shown as '?'.
+    int length = 0;
+    for (const char *c = word->text; *c && length < MAX_WORD_LENGTH; c++) {
+        if ((*c & 0xC0) == 0x80) {
+            continue;
+        }
+        sprite->letters[length++] = (*c & 0x80)? '?': *c;
     }
     
     // Set constant data
@@ -363,6 +637,19 @@ void wordSprite_Load(WORD_SPRITE *sprite, float x, float y, const WORD *word) {
     
     // Reset sprite
     ResetSprite(sprite);
+    InvalidateSprite(sprite);
+    return true;
+}
+
+void wordSprite_Unload(WORD_SPRITE *sprite) {
+    if (!OwnsLetters(sprite)) {
+        return;
+    }
+    InvalidateSprite(sprite);
+    GlobalOwners[sprite->first/LETTER_BLOCK] = NULL;
+    letterSystem_Free(&GlobalLetters, sprite->first);
+    sprite->first = -1;
+    sprite->nLetters = 0;
 }
 
 /*============================================================*/
@@ -15,23 +15,7 @@
 
 // This project
 #include "word.h"           // WORD
-
-/**********************************************************//**
- * @struct LETTER_SPRITE
- * @brief Defines how the letter is displayed on the screen.
- **************************************************************/
-typedef struct {
-    char letter;            ///< The letter to display.
-    float opacity;          ///< Opacity of the letter.
-    float scaling;          ///< Scaling applied to the letter.
-    float rotation;         ///< Rotation in radians of the letter.
-    float x;                ///< Letter X offset position.
-    float y;                ///< Letter Y offset position.
-    float xv;               ///< X velocity.
-    float yv;               ///< Y velicity.
-    float rv;               ///< Rotational velocity.
-    float sv;               ///< Size velocity.
-} LETTER_SPRITE;
+#include "letter_system.h"  // LETTER_SYSTEM
 
 typedef enum {
     WORD_ANIMATE_IDLE,
@@ -43,12 +27,15 @@ typedef enum {
 
 /**********************************************************//**
  * @struct WORD_SPRITE
- * @brief Defines how the word is displayed on the screen.
+ * @brief Defines how the word is displayed on the screen. The
+ * motion of the letters lives in the shared letter system, so
+ * a loaded sprite must not be moved in memory.
  **************************************************************/
 typedef struct WORD_SPRITE {
     // Letters
-    LETTER_SPRITE letters[MAX_WORD_LENGTH]; ///< Letter sprites.
+    char letters[MAX_WORD_LENGTH]; ///< The letters to display.
     int nLetters;           ///< Number of letters to draw.
+    int first;              ///< First letter in the letter system.
     
     // Overall position
     float x;                ///< Word origin X position.
@@ -65,6 +52,12 @@ typedef struct WORD_SPRITE {
  **************************************************************/
 extern void wordSprite_Initialize(void);
 
+/**********************************************************//**
+ * @brief Releases everything held by the word_sprite module.
+ * Sprites must not be drawn or updated afterwards.
+ **************************************************************/
+extern void wordSprite_Destroy(void);
+
 /**********************************************************//**
  * @brief Draw the word on the screen.
  * @param sprite: The word's sprite configuration.
@@ -72,13 +65,33 @@ extern void wordSprite_Initialize(void);
 extern void wordSprite_Draw(const WORD_SPRITE *sprite);
 
 /**********************************************************//**
- * @brief Update the word's animation.
+ * @brief Draw many words on the screen at once. The quads of
+ * all letters are computed in one pass and submitted to the
+ * GPU in a single primitive call.
+ * @param sprites: Array of pointers to sprite configurations.
+ * @param count: Number of sprites in the array.
+ **************************************************************/
+extern void wordSprite_DrawAll(const WORD_SPRITE *const *sprites, int count);
+
+/**********************************************************//**
+ * @brief Update the word's animation script. This only sets
+ * up the letter velocities; the letters of every sprite are
+ * moved together by wordSprite_Step.
  * @param sprite: The word's sprite configuration.
  * @param dt: The time update.
  * @return Whether the sprite should be deleted.
  **************************************************************/
 extern bool wordSprite_Update(WORD_SPRITE *sprite, float dt);
 
+/**********************************************************//**
+ * @brief Moves the letters of every loaded sprite. Call this
+ * once per frame after updating the sprites. The areas the
+ * letters covered before and after the step are marked for
+ * redraw.
+ * @param dt: The time update.
+ **************************************************************/
+extern void wordSprite_Step(float dt);
+
 /**********************************************************//**
  * @brief Loads a sprite for the given word. This places the
  * sprite at the origin.
@@ -86,8 +99,18 @@ extern bool wordSprite_Update(WORD_SPRITE *sprite, float dt);
  * @param x: Anchor x position.
  * @param y: Anchor y position.
  * @param word: The word to turn into a sprite.
+ * @return Whether the letters of the sprite could be reserved.
+ * If it succeeds you must unload the sprite with
+ * wordSprite_Unload later.
+ **************************************************************/
+extern bool wordSprite_Load(WORD_SPRITE *sprite, float x, float y, const WORD *word);
+
+/**********************************************************//**
+ * @brief Returns the letters of the sprite to the letter
+ * system.
+ * @param sprite: The sprite to unload.
  **************************************************************/
-extern void wordSprite_Load(WORD_SPRITE *sprite, float x, float y, const WORD *word);
+extern void wordSprite_Unload(WORD_SPRITE *sprite);
 
 /*============================================================*/
 #endif // _WORD_SPRITE_H_
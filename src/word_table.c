@@ -6,174 +6,810 @@
 // Standard library
 #include <stddef.h>         // size_t
 #include <stdbool.h>        // bool
-#include <stdlib.h>         // malloc, free
+#include <stdint.h>         // uint32_t
+#include <stdlib.h>         // malloc, realloc, free
 #include <stdio.h>          // FILE
-#include <string.h>         // strcmp
+#include <string.h>         // strcmp, strcpy, memcpy
+#include <pthread.h>        // pthread_create
 
 // This project
 #include "debug.h"          // assert, eprintf
 #include "word_table.h"     // WORD_TABLE
+#include "rcu.h"            // rcu_ReadLock
 
-/// The number of unique lowercase letters.
-#define N_LETTERS 26
+/// The number of distinct first bytes.
+#define N_FIRST 256
+
+/// Words in each front-coded block.
+#define BLOCK_WORDS 16
 
 /**********************************************************//**
  * @struct WORD_TABLE
- * @brief Stores lookup table of words.
+ * @brief Stores a lookup table of words. The header, the block
+ * index and the text live in one allocation that is never
+ * written after loading. The text is front-coded: each word is
+ * a byte with the number of bytes it shares with the word
+ * before, a byte with the length of the rest, then the rest.
+ * The first word of each block of
+ * BLOCK_WORDS is stored whole, so any block can be read on its
+ * own. Walking the words in order visits them like a trie,
+ * which is how suggestions are found.
  **************************************************************/
-typedef struct {
-    char **table;           ///< The table of all words.
-    int size;               ///< Entries in the table.
-    int lookup[N_LETTERS];  ///< Letter-indexed lookup table.
-} WORD_TABLE;
+struct WORD_TABLE {
+    int size;                   ///< Words in the table.
+    int nBlocks;                ///< Blocks in the table.
+    int bounds[N_FIRST+1];      ///< First word at or after each first byte.
+    const uint32_t *blocks;     ///< Start of each block in the text.
+    const uint8_t *least;       ///< Fewest shared bytes of any word in each block.
+    const char *text;           ///< Every word, front-coded.
+    WORD_TABLE_STATS stats;     ///< What loading found.
+};
 
-/// Value for when the lookup table has no value.
-#define LOOKUP_EMPTY -1
+/// The "real words" table.
+static WORD_TABLE *GlobalWords = NULL;
 
-/// The current word table
-static WORD_TABLE GlobalWords = {0, 0, {LOOKUP_EMPTY}};
-
-/*============================================================*
- * Table is valid
- *============================================================*/
-bool wordTable_IsValid(void) {
-    return GlobalWords.size != 0;
+/**********************************************************//**
+ * @brief Rounds a size up so that an array of uint32_t can
+ * follow it.
+ * @param size: The size to round.
+ * @return The aligned size.
+ **************************************************************/
+static inline size_t Align(size_t size) {
+    return (size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
 }
 
 /*============================================================*
- * Loading the table
+ * Reading lines
  *============================================================*/
-bool wordTable_Load(const char *filename) {
-    // Load the file
-    FILE *file = fopen(filename, "r");
+
+/**********************************************************//**
+ * @brief Reads a whole file.
+ * @param filename: The file to read.
+ * @param size: Gets the number of bytes read.
+ * @return The contents followed by '\0', which must be freed,
+ * or NULL on failure.
+ **************************************************************/
+static char *ReadFile(const char *filename, size_t *size) {
+    FILE *file = fopen(filename, "rb");
     if (!file) {
-        eprintf("Failed to open file.\n");
+        eprintf("Failed to open %s\n", filename);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    rewind(file);
+    if (length < 0 || (unsigned long)length >= UINT32_MAX) {
+        eprintf("Failed to measure %s\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    char *text = malloc(length + 1);
+    if (!text) {
+        eprintf("Out of memory.\n");
+        fclose(file);
+        return NULL;
+    }
+    *size = fread(text, 1, length, file);
+    text[*size] = '\0';
+    fclose(file);
+    return text;
+}
+
+/**********************************************************//**
+ * @brief Folds ASCII letters to lowercase, leaving other bytes
+ * as they are.
+ **************************************************************/
+static int FoldASCII(const void *data, const char *word, char *folded, int size) {
+    (void)data;
+    int i;
+    for (i = 0; word[i]; i++) {
+        if (i + 1 >= size) {
+            return -1;
+        }
+        char c = word[i];
+        folded[i] = (c >= 'A' && c <= 'Z')? c - 'A' + 'a': c;
+    }
+    folded[i] = '\0';
+    return i;
+}
+
+/**********************************************************//**
+ * @brief Checks if a byte is space around a word.
+ **************************************************************/
+static inline bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\0';
+}
+
+/**********************************************************//**
+ * @struct WORD_LIST
+ * @brief Folded words waiting to be sorted.
+ **************************************************************/
+typedef struct {
+    char *text;             ///< Every word, each ended by '\0'.
+    size_t used;            ///< Bytes of text used.
+    size_t capacity;        ///< Bytes of text allocated.
+    const char **words;     ///< Start of each word.
+    int count;              ///< Number of words.
+    int capacityWords;      ///< Number of words allocated.
+} WORD_LIST;
+
+/**********************************************************//**
+ * @brief Splits a file into trimmed, folded words.
+ * @param list: Gets the words.
+ * @param file: The file's text, which is trimmed in place.
+ * @param size: Bytes in the file.
+ * @param fold: Folds each word.
+ * @param data: Passed to fold.
+ * @param stats: Gets the line counts and whether the words
+ * were sorted.
+ * @return Whether there was enough memory.
+ **************************************************************/
+static bool ReadWords(WORD_LIST *list, char *file, size_t size, WORD_FOLD fold, const void *data, WORD_TABLE_STATS *stats) {
+    // Folding ASCII never makes words longer, so this is
+    // usually all the room needed
+    list->capacity = size + MAX_WORD_LINE + 1;
+    list->used = 0;
+    list->count = 0;
+    list->capacityWords = 1024;
+    list->text = malloc(list->capacity);
+    list->words = malloc(list->capacityWords * sizeof(const char *));
+    if (!list->text || !list->words) {
         return false;
     }
     
-    // Set up the lookup table
-    for (int i = 0; i < N_LETTERS; i++) {
-        GlobalWords.lookup[i] = LOOKUP_EMPTY;
+    // Skip a UTF-8 byte order mark
+    size_t i = 0;
+    if (size >= 3 && !memcmp(file, "\xEF\xBB\xBF", 3)) {
+        i = 3;
     }
     
-    // Read the entire file
-    int tableSize = 1024;
-    GlobalWords.table = (char **)malloc(tableSize * sizeof(char *));
-    GlobalWords.size = 0;
-    const size_t BUF_SIZE = 48;
-    char buf[BUF_SIZE+1];
-    while (fgets(buf, BUF_SIZE, file)) {
-        // Knock newline off of word
-        int end = strlen(buf) - 1;
-        if (end >= 0) {
-            buf[end] = '\0';
+    // Lines end with '\n', '\r' or both
+    size_t last = 0;
+    while (i < size) {
+        while (i < size && IsSpace(file[i])) {
+            i++;
         }
-        
-        // Lookup table management
-        int key = buf[0] - 'a';
-        if (key >= 0 && key < N_LETTERS) {
-            if (GlobalWords.lookup[key] == LOOKUP_EMPTY) {
-                GlobalWords.lookup[key] = GlobalWords.size;
-            }
+        size_t start = i;
+        while (i < size && file[i] != '\n' && file[i] != '\r') {
+            i++;
         }
+        size_t end = i;
+        while (end > start && IsSpace(file[end-1])) {
+            end--;
+        }
+        if (end == start) {
+            continue;
+        }
+        file[end] = '\0';
+        stats->lines++;
         
-        // Check if we need to expand the table.
-        if (GlobalWords.size >= tableSize) {
-            // Reallocate the table
-            char **newTable = (char **)malloc(2*tableSize * sizeof(char *));
-            if (!newTable) {
-                eprintf("Failed to expand the table.\n");
-                wordTable_Destroy();
-                fclose(file);
+        // Make room for the longest word
+        if (list->used + MAX_WORD_LINE + 1 > list->capacity) {
+            size_t capacity = 2*list->capacity;
+            char *grown = realloc(list->text, capacity);
+            if (!grown) {
                 return false;
             }
-            
-            // Copy the old table
-            for (int i = 0; i < GlobalWords.size; i++) {
-                newTable[i] = GlobalWords.table[i];
+            list->text = grown;
+            list->capacity = capacity;
+        }
+        if (list->count == list->capacityWords) {
+            int capacity = 2*list->capacityWords;
+            const char **grown = realloc(list->words, capacity * sizeof(const char *));
+            if (!grown) {
+                return false;
             }
-            
-            // Replace the table
-            free(GlobalWords.table);
-            GlobalWords.table = newTable;
-            tableSize *= 2;
-        }
-
-        // Generate the current table entry
-        GlobalWords.table[GlobalWords.size] = (char *)malloc((strlen(buf)+1) * sizeof(char));
-        if (!GlobalWords.table[GlobalWords.size]) {
-            eprintf("Out of memory.\n");
-            wordTable_Destroy();
-            fclose(file);
-            return false;
+            list->words = grown;
+            list->capacityWords = capacity;
+        }
+        
+        // Fold the case straight into the list, dropping what
+        // can't be folded
+        char *folded = list->text + list->used;
+        int length = end - start > MAX_WORD_LINE? -1: fold(data, file + start, folded, MAX_WORD_LINE + 1);
+        if (length <= 0) {
+            stats->rejected++;
+            continue;
+        }
+        if ((size_t)length != end - start || memcmp(folded, file + start, length)) {
+            stats->folded++;
+        }
+        if (stats->sorted && list->count > 0 && strcmp(list->text + last, folded) > 0) {
+            stats->sorted = false;
         }
-        strcpy(GlobalWords.table[GlobalWords.size], buf);
-        GlobalWords.size++;
+        
+        // Offsets until the text stops moving
+        last = list->used;
+        list->words[list->count++] = (const char *)(uintptr_t)last;
+        list->used += length + 1;
+    }
+    for (int n = 0; n < list->count; n++) {
+        list->words[n] = list->text + (uintptr_t)list->words[n];
+    }
+    return true;
+}
+
+/*============================================================*
+ * Sorting words
+ *============================================================*/
+
+/// Buckets smaller than this are insertion sorted.
+#define RADIX_CUTOFF 32
+
+/// Most threads sorting one table.
+#define SORT_THREADS 4
+
+/// Fewest words worth sorting on several threads.
+#define PARALLEL_SORT_WORDS 16384
+
+/**********************************************************//**
+ * @brief Insertion sorts words that share their first bytes.
+ * @param words: The words to sort.
+ * @param count: Number of words.
+ * @param depth: Bytes every word already shares.
+ **************************************************************/
+static void InsertionSort(const char **words, int count, int depth) {
+    for (int i = 1; i < count; i++) {
+        const char *word = words[i];
+        int j = i;
+        while (j > 0 && strcmp(words[j-1] + depth, word + depth) > 0) {
+            words[j] = words[j-1];
+            j--;
+        }
+        words[j] = word;
+    }
+}
+
+/**********************************************************//**
+ * @brief Moves words into buckets by one byte, stably.
+ * @param words: The words to distribute.
+ * @param scratch: Room for as many words.
+ * @param count: Number of words.
+ * @param depth: Byte to distribute by.
+ * @param starts: Gets the first word of each bucket, and the
+ * end of the last.
+ **************************************************************/
+static void Distribute(const char **words, const char **scratch, int count, int depth, int *starts) {
+    int sizes[N_FIRST] = {0};
+    for (int i = 0; i < count; i++) {
+        sizes[(unsigned char)words[i][depth]]++;
+    }
+    int next[N_FIRST];
+    int start = 0;
+    for (int b = 0; b < N_FIRST; b++) {
+        starts[b] = next[b] = start;
+        start += sizes[b];
+    }
+    starts[N_FIRST] = start;
+    for (int i = 0; i < count; i++) {
+        scratch[next[(unsigned char)words[i][depth]]++] = words[i];
+    }
+    memcpy(words, scratch, count * sizeof(const char *));
+}
+
+/**********************************************************//**
+ * @brief Sorts words that share their first bytes, most
+ * significant byte first.
+ * @param words: The words to sort.
+ * @param scratch: Room for as many words.
+ * @param count: Number of words.
+ * @param depth: Bytes every word already shares.
+ **************************************************************/
+static void RadixSort(const char **words, const char **scratch, int count, int depth) {
+    if (count < RADIX_CUTOFF) {
+        InsertionSort(words, count, depth);
+        return;
     }
     
-    // Done reading
-    fclose(file);
-    
-    // Compress the table size
-    char **compressed = (char **)malloc(GlobalWords.size * sizeof(char *));
-    if (!GlobalWords.table) {
-        eprintf("Failed to compress the table.\n");
-        wordTable_Destroy();
+    // Words that end here are all equal, so bucket 0 is done
+    int starts[N_FIRST+1];
+    Distribute(words, scratch, count, depth, starts);
+    for (int b = 1; b < N_FIRST; b++) {
+        int size = starts[b+1] - starts[b];
+        if (size > 1) {
+            RadixSort(words + starts[b], scratch + starts[b], size, depth + 1);
+        }
+    }
+}
+
+/**********************************************************//**
+ * @struct SORT_JOB
+ * @brief First-byte buckets shared by the sorting threads.
+ **************************************************************/
+typedef struct {
+    const char **words;     ///< The words, distributed by first byte.
+    const char **scratch;   ///< Room for as many words.
+    int starts[N_FIRST+1];  ///< First word of each bucket.
+    int next;               ///< Next bucket to claim.
+} SORT_JOB;
+
+/**********************************************************//**
+ * @brief Sorts buckets until none are left.
+ * @param data: The SORT_JOB.
+ * @return NULL.
+ **************************************************************/
+static void *SortBuckets(void *data) {
+    SORT_JOB *job = data;
+    int b;
+    while ((b = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < N_FIRST) {
+        int size = job->starts[b+1] - job->starts[b];
+        if (b > 0 && size > 1) {
+            RadixSort(job->words + job->starts[b], job->scratch + job->starts[b], size, 1);
+        }
+    }
+    return NULL;
+}
+
+/**********************************************************//**
+ * @brief Sorts words bytewise, on several threads if there are
+ * enough of them.
+ * @param words: The words to sort.
+ * @param count: Number of words.
+ * @return Whether there was enough memory.
+ **************************************************************/
+static bool SortWords(const char **words, int count) {
+    const char **scratch = malloc(count * sizeof(const char *) + 1);
+    if (!scratch) {
         return false;
     }
+    if (count < PARALLEL_SORT_WORDS) {
+        RadixSort(words, scratch, count, 0);
+        free(scratch);
+        return true;
+    }
     
-    // Copy the old table
-    for (int i = 0; i < GlobalWords.size; i++) {
-        compressed[i] = GlobalWords.table[i];
+    // Split by first byte, then sort the buckets in parallel
+    SORT_JOB job = {.words = words, .scratch = scratch, .next = 0};
+    Distribute(words, scratch, count, 0, job.starts);
+    pthread_t threads[SORT_THREADS-1];
+    int nThreads = 0;
+    while (nThreads < SORT_THREADS-1 && !pthread_create(&threads[nThreads], NULL, SortBuckets, &job)) {
+        nThreads++;
+    }
+    SortBuckets(&job);
+    for (int i = 0; i < nThreads; i++) {
+        pthread_join(threads[i], NULL);
     }
-    free(GlobalWords.table);
-    GlobalWords.table = compressed;
+    free(scratch);
     return true;
 }
 
 /*============================================================*
- * Destroying the table
+ * Loading a table
  *============================================================*/
-void wordTable_Destroy(void) {
-    // Guard against double free.
-    if (GlobalWords.table) {
-        for (int i = 0; i < GlobalWords.size; i++) {
-            free(GlobalWords.table[i]);
+
+/**********************************************************//**
+ * @brief Builds a table from sorted words, dropping repeats.
+ * @param words: The sorted words.
+ * @param count: Number of words.
+ * @param bytes: Bytes in the words, including each '\0'.
+ * @param stats: Gets the number of words kept and dropped.
+ * @return The table, or NULL if out of memory.
+ **************************************************************/
+static WORD_TABLE *Build(const char **words, int count, size_t bytes, WORD_TABLE_STATS *stats) {
+    // The header, the block index and the text in one block,
+    // with room for every word stored whole, even repeats
+    int maxBlocks = (count + BLOCK_WORDS - 1) / BLOCK_WORDS;
+    size_t blockStart = Align(sizeof(WORD_TABLE));
+    size_t leastStart = blockStart + maxBlocks*sizeof(uint32_t);
+    size_t textStart = leastStart + maxBlocks;
+    char *block = malloc(textStart + bytes + count);
+    if (!block) {
+        return NULL;
+    }
+    WORD_TABLE *table = (WORD_TABLE *)block;
+    uint32_t *blocks = (uint32_t *)(block + blockStart);
+    uint8_t *least = (uint8_t *)(block + leastStart);
+    char *text = block + textStart;
+    
+    // Store each word after the bytes it shares with the last
+    const char *last = "";
+    size_t used = 0;
+    int letter = 0;
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        const char *word = words[i];
+        int shared = 0;
+        while (word[shared] && word[shared] == last[shared]) {
+            shared++;
         }
-        free(GlobalWords.table);
+        if (n > 0 && !word[shared] && !last[shared]) {
+            stats->duplicates++;
+            continue;
+        }
+        while (letter <= N_FIRST && (unsigned char)word[0] >= letter) {
+            table->bounds[letter++] = n;
+        }
+        
+        // Blocks start with the whole word
+        int from = shared;
+        if (n % BLOCK_WORDS == 0) {
+            blocks[n / BLOCK_WORDS] = used;
+            least[n / BLOCK_WORDS] = shared;
+            from = 0;
+        } else if (shared < least[n / BLOCK_WORDS]) {
+            least[n / BLOCK_WORDS] = shared;
+        }
+        int length = strlen(word + from);
+        text[used] = shared;
+        text[used+1] = length;
+        memcpy(text + used + 2, word + from, length);
+        used += length + 2;
+        last = word;
+        n++;
+    }
+    while (letter <= N_FIRST) {
+        table->bounds[letter++] = n;
     }
     
-    // Reset table attributes.
-    GlobalWords.table = NULL;
-    GlobalWords.size = 0;
+    // Give back the room the shared bytes saved
+    table = realloc(block, textStart + used);
+    if (!table) {
+        table = (WORD_TABLE *)block;
+    }
+    block = (char *)table;
+    table->size = n;
+    table->nBlocks = (n + BLOCK_WORDS - 1) / BLOCK_WORDS;
+    table->blocks = (const uint32_t *)(block + blockStart);
+    table->least = (const uint8_t *)(block + leastStart);
+    table->text = block + textStart;
+    stats->words = n;
+    stats->bytes = textStart + used;
+    table->stats = *stats;
+    return table;
+}
+
+WORD_TABLE *wordTable_CreateFolded(const char *filename, WORD_FOLD fold, const void *data) {
+    size_t size;
+    char *file = ReadFile(filename, &size);
+    if (!file) {
+        return NULL;
+    }
+    
+    // Normalize every line
+    WORD_TABLE_STATS stats = {.sorted = true};
+    WORD_LIST list;
+    bool read = ReadWords(&list, file, size, fold? fold: FoldASCII, data, &stats);
+    free(file);
+    
+    // Shipped lists are usually in order and skip sorting
+    WORD_TABLE *table = NULL;
+    if (read && (stats.sorted || SortWords(list.words, list.count))) {
+        table = Build(list.words, list.count, list.used, &stats);
+    }
+    if (!table) {
+        eprintf("Out of memory.\n");
+    }
+    free(list.words);
+    free(list.text);
+    return table;
+}
+
+WORD_TABLE *wordTable_Create(const char *filename) {
+    return wordTable_CreateFolded(filename, NULL, NULL);
 }
 
 /*============================================================*
- * Contianment checking
+ * Freeing a table
  *============================================================*/
-static bool ContainsHelper(const char *what, int start, int end) {
-    // Base case
-    if (start == end+1 || start >= end) {
-        return strcmp(GlobalWords.table[start], what) == 0;
+void wordTable_Free(WORD_TABLE *table) {
+    free(table);
+}
+
+int wordTable_GetSize(const WORD_TABLE *table) {
+    return table->size;
+}
+
+void wordTable_GetStats(const WORD_TABLE *table, WORD_TABLE_STATS *stats) {
+    *stats = table->stats;
+}
+
+/*============================================================*
+ * Containment checking
+ *============================================================*/
+/**********************************************************//**
+ * @brief Compares the first word of a block with some text.
+ * @param text: The start of the block.
+ * @param what: The text to compare to.
+ * @param length: Length of the text.
+ * @return Less than, equal to or greater than zero if the word
+ * is before, the same as or after the text.
+ **************************************************************/
+static inline int CompareFirst(const char *text, const char *what, int length) {
+    int wordLength = (unsigned char)text[1];
+    int compare = memcmp(text + 2, what, wordLength < length? wordLength: length);
+    return compare? compare: wordLength - length;
+}
+
+bool wordTable_ContainsIn(const WORD_TABLE *table, const char *what) {
+    // Only search the blocks with words of the same first byte
+    unsigned char key = what[0];
+    if (table->bounds[key] == table->bounds[key+1]) {
+        return false;
     }
+    int first = table->bounds[key] / BLOCK_WORDS;
+    int end = (table->bounds[key+1] + BLOCK_WORDS - 1) / BLOCK_WORDS;
     
-    // Split
-    int midpoint = (start + end) / 2;
-    int compare = strcmp(GlobalWords.table[midpoint], what);
-    if (compare == 0) {
-        return true;
-    } else if (compare > 0) {
-        return ContainsHelper(what, start, midpoint);
+    // Find the last block starting at or before the word. The
+    // first block may start before the first byte does.
+    int length = strlen(what);
+    int start = first + 1;
+    while (start < end) {
+        int midpoint = start + (end - start) / 2;
+        if (CompareFirst(table->text + table->blocks[midpoint], what, length) > 0) {
+            end = midpoint;
+        } else {
+            start = midpoint + 1;
+        }
+    }
+    
+    // Walk the block, keeping how many bytes the word shares
+    // with the last one read. That word is always before it, so
+    // a word sharing more with it is too, and one sharing less
+    // is after it.
+    int block = start - 1;
+    int stop = block*BLOCK_WORDS + BLOCK_WORDS < table->size? block*BLOCK_WORDS + BLOCK_WORDS: table->size;
+    const char *text = table->text + table->blocks[block];
+    int matched = 0;
+    for (int i = block*BLOCK_WORDS; i < stop; i++) {
+        int shared = i == block*BLOCK_WORDS? 0: (unsigned char)text[0];
+        int rest = (unsigned char)text[1];
+        const char *bytes = text + 2;
+        text += rest + 2;
+        if (shared > matched) {
+            continue;
+        } else if (shared < matched) {
+            return false;
+        }
+        
+        // Compare the rest of this word
+        int j = 0;
+        while (j < rest && bytes[j] == what[matched + j]) {
+            j++;
+        }
+        if (j < rest) {
+            if ((unsigned char)bytes[j] > (unsigned char)what[matched + j]) {
+                return false;
+            }
+        } else if (!what[matched + j]) {
+            return true;
+        }
+        matched += j;
+    }
+    return false;
+}
+
+/*============================================================*
+ * Suggestions
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Computes the next row of edit distances after adding
+ * a letter to the candidate prefix. Only the cells within band
+ * of the diagonal are computed; the rest could never be at
+ * most band, so the cells around them are saturated at
+ * band+1 for the next row to read.
+ * @param above: The row for the prefix so far.
+ * @param row: Gets the row with the letter added.
+ * @param what: The text suggestions are made for.
+ * @param length: Length of the text.
+ * @param depth: Length of the prefix with the letter added.
+ * @param band: The most edits searched for.
+ * @param letter: The letter added to the prefix.
+ * @return The smallest distance in the new row, at most
+ * band+1.
+ **************************************************************/
+static inline int NextRow(const int *above, int *row, const char *what, int length, int depth, int band, char letter) {
+    int start = depth - band;
+    int end = depth + band < length? depth + band: length;
+    int smallest = band + 1;
+    if (start <= 0) {
+        smallest = row[0] = depth;
+        start = 1;
     } else {
-        return ContainsHelper(what, midpoint+1, end);
+        row[start-1] = band + 1;
     }
+    for (int j = start; j <= end; j++) {
+        int best = above[j-1] + (what[j-1] != letter);
+        if (above[j] + 1 < best) {
+            best = above[j] + 1;
+        }
+        if (row[j-1] + 1 < best) {
+            best = row[j-1] + 1;
+        }
+        row[j] = best;
+        if (best < smallest) {
+            smallest = best;
+        }
+    }
+    if (end < length) {
+        row[end+1] = band + 1;
+    }
+    return smallest;
 }
 
-bool wordTable_Contains(const char *what) {
-    if (GlobalWords.size == 0) {
+/**********************************************************//**
+ * @brief Adds a suggestion, keeping them sorted by distance.
+ * Earlier words win ties, so equals stay alphabetical.
+ * @param suggestions: The suggestions so far.
+ * @param count: Number of suggestions so far.
+ * @param maxSuggestions: Most suggestions to keep.
+ * @param word: The word to add.
+ * @param distance: Its distance.
+ * @return The new number of suggestions.
+ **************************************************************/
+static int AddSuggestion(WORD_SUGGESTION *suggestions, int count, int maxSuggestions, const char *word, int distance) {
+    int i = count < maxSuggestions? count: maxSuggestions - 1;
+    while (i > 0 && suggestions[i-1].distance > distance) {
+        suggestions[i] = suggestions[i-1];
+        i--;
+    }
+    strcpy(suggestions[i].text, word);
+    suggestions[i].distance = distance;
+    return count < maxSuggestions? count + 1: count;
+}
+
+int wordTable_SuggestIn(const WORD_TABLE *table, const char *what, int maxDistance, WORD_SUGGESTION *suggestions, int maxSuggestions) {
+    int length = strlen(what);
+    if (length > MAX_SUGGEST_QUERY || maxSuggestions <= 0 || maxDistance < 0) {
+        return 0;
+    }
+    if (maxDistance > MAX_SUGGEST_DISTANCE) {
+        maxDistance = MAX_SUGGEST_DISTANCE;
+    }
+    
+    // One row of distances per letter of the candidate. The
+    // sorted table is walked like a trie: rows are shared with
+    // the previous word as far as their prefixes match.
+    int rows[MAX_SUGGEST_BYTES+1][MAX_SUGGEST_QUERY+1];
+    for (int j = 0; j <= length; j++) {
+        rows[0][j] = j;
+    }
+    char word[MAX_WORD_LINE+1];
+    const char *text = table->text;
+    int depth = 0;
+    int bound = maxDistance;
+    int count = 0;
+    int i = 0;
+    while (i < table->size) {
+        // The word is the start of the one before, then its own
+        // bytes, which are only copied as far as they are read
+        int prefix = (unsigned char)text[0];
+        int from = i % BLOCK_WORDS? prefix: 0;
+        int end = from + (unsigned char)text[1];
+        const char *bytes = text + 2 - from;
+        text = bytes + end;
+        
+        // Extend the prefix until the word ends or can't match
+        int letter = prefix < depth? prefix: depth;
+        bool pruned = false;
+        while (letter < end) {
+            char next = letter < from? word[letter]: bytes[letter];
+            if (letter + 1 > length + bound
+                    || NextRow(rows[letter], rows[letter+1], what, length, letter + 1, maxDistance, next) > bound) {
+                pruned = true;
+                break;
+            }
+            word[letter++] = next;
+        }
+        depth = letter;
+        i++;
+        if (pruned) {
+            // Skip every word with the prefix that can't match,
+            // a whole block at a time where they fill it
+            while (i < table->size) {
+                if (i % BLOCK_WORDS == 0) {
+                    text = table->text + table->blocks[i / BLOCK_WORDS];
+                    if (table->least[i / BLOCK_WORDS] > letter) {
+                        i += BLOCK_WORDS;
+                        continue;
+                    }
+                }
+                if ((unsigned char)text[0] <= letter) {
+                    break;
+                }
+                text += (unsigned char)text[1] + 2;
+                i++;
+            }
+            continue;
+        }
+        
+        // Once full, only strictly closer words can get in
+        if (letter >= length - bound && rows[letter][length] <= bound) {
+            word[letter] = '\0';
+            count = AddSuggestion(suggestions, count, maxSuggestions, word, rows[letter][length]);
+            if (count == maxSuggestions) {
+                bound = suggestions[count-1].distance - 1;
+                if (bound < 0) {
+                    break;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/*============================================================*
+ * Walking the words
+ *============================================================*/
+void wordTable_WalkIn(const WORD_TABLE *table, WORD_VISIT visit, void *data) {
+    char word[MAX_WORD_LINE+1];
+    const char *text = table->text;
+    for (int i = 0; i < table->size; i++) {
+        int from = i % BLOCK_WORDS? (unsigned char)text[0]: 0;
+        int rest = (unsigned char)text[1];
+        memcpy(word + from, text + 2, rest);
+        word[from + rest] = '\0';
+        text += rest + 2;
+        visit(data, word);
+    }
+}
+
+/*============================================================*
+ * The "real words" table
+ *============================================================*/
+bool wordTable_Load(const char *filename) {
+    // Build the new table off to the side
+    WORD_TABLE *table = wordTable_Create(filename);
+    if (!table) {
         return false;
     }
-    return ContainsHelper(what, 0, GlobalWords.size);
+    
+    // Swap it in, then free the old one once no reader can
+    // still be using it
+    WORD_TABLE *old = __atomic_exchange_n(&GlobalWords, table, __ATOMIC_SEQ_CST);
+    if (old) {
+        rcu_Synchronize();
+        wordTable_Free(old);
+    }
+    return true;
+}
+
+void wordTable_Destroy(void) {
+    WORD_TABLE *old = __atomic_exchange_n(&GlobalWords, NULL, __ATOMIC_SEQ_CST);
+    if (old) {
+        rcu_Synchronize();
+        wordTable_Free(old);
+    }
+}
+
+const WORD_TABLE *wordTable_BeginRead(void) {
+    rcu_ReadLock();
+    return __atomic_load_n(&GlobalWords, __ATOMIC_ACQUIRE);
+}
+
+void wordTable_EndRead(void) {
+    rcu_ReadUnlock();
+}
+
+bool wordTable_IsValid(void) {
+    const WORD_TABLE *table = wordTable_BeginRead();
+    bool valid = table && table->size != 0;
+    wordTable_EndRead();
+    return valid;
+}
+
+bool wordTable_Contains(const char *what) {
+    const WORD_TABLE *table = wordTable_BeginRead();
+    bool found = table && wordTable_ContainsIn(table, what);
+    wordTable_EndRead();
+    return found;
+}
+
+int wordTable_Suggest(const char *what, int maxDistance, WORD_SUGGESTION *suggestions, int maxSuggestions) {
+    const WORD_TABLE *table = wordTable_BeginRead();
+    int count = table? wordTable_SuggestIn(table, what, maxDistance, suggestions, maxSuggestions): 0;
+    wordTable_EndRead();
+    return count;
+}
+
+bool wordTable_Walk(WORD_VISIT visit, void *data) {
+    const WORD_TABLE *table = wordTable_BeginRead();
+    if (table) {
+        wordTable_WalkIn(table, visit, data);
+    }
+    wordTable_EndRead();
+    return table != NULL;
 }
 
 /*============================================================*/
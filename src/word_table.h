@@ -1,6 +1,8 @@
 /**********************************************************//**
  * @file word_table.h
- * @brief Header file for word dictionary tables.
+ * @brief Header file for word dictionary tables. A table never
+ * changes once it is created, so any number of threads can
+ * look words up in it at once without locking.
  **************************************************************/
 
 #ifndef _WORD_TABLE_H_
@@ -8,35 +10,207 @@
 
 // Standard library
 #include <stdbool.h>    // bool
+#include <stddef.h>     // size_t
+
+//**************************************************************
+/// Longest text, in bytes, that suggestions can be made for.
+#define MAX_SUGGEST_QUERY 64
+
+/// Most edits between some text and a suggestion.
+#define MAX_SUGGEST_DISTANCE 2
+
+/// Longest suggestion, in bytes.
+#define MAX_SUGGEST_BYTES (MAX_SUGGEST_QUERY + MAX_SUGGEST_DISTANCE)
+
+/// Longest word, in bytes, kept when loading a table.
+#define MAX_WORD_LINE 255
+
+/**********************************************************//**
+ * @struct WORD_TABLE
+ * @brief An immutable, sorted table of words. The contents are
+ * private to word_table.c.
+ **************************************************************/
+typedef struct WORD_TABLE WORD_TABLE;
+
+/**********************************************************//**
+ * @struct WORD_SUGGESTION
+ * @brief A real word close to some other text.
+ **************************************************************/
+typedef struct {
+    char text[MAX_SUGGEST_BYTES+1]; ///< The real word.
+    int distance;                   ///< Edits away from the text.
+} WORD_SUGGESTION;
+
+/**********************************************************//**
+ * @struct WORD_TABLE_STATS
+ * @brief What was found while loading a table.
+ **************************************************************/
+typedef struct {
+    int lines;          ///< Lines that weren't blank.
+    int words;          ///< Words in the table.
+    int duplicates;     ///< Lines dropped as repeats.
+    int rejected;       ///< Lines too long or that couldn't be folded.
+    int folded;         ///< Lines changed by case folding.
+    bool sorted;        ///< Whether the folded lines were in order.
+    size_t bytes;       ///< Memory the table takes.
+} WORD_TABLE_STATS;
+
+/**********************************************************//**
+ * @brief Folds a word to lowercase for a table.
+ * @param data: Data given to wordTable_CreateFolded.
+ * @param word: The word, trimmed of spaces.
+ * @param folded: Gets the folded word.
+ * @param size: Bytes available in folded, including '\0'.
+ * @return The length of the folded word, or -1 to drop it.
+ **************************************************************/
+typedef int (*WORD_FOLD)(const void *data, const char *word, char *folded, int size);
+
+/**********************************************************//**
+ * @brief Visits one word of a table.
+ * @param data: Data given to wordTable_WalkIn.
+ * @param word: The word.
+ **************************************************************/
+typedef void (*WORD_VISIT)(void *data, const char *word);
+
+/**********************************************************//**
+ * @brief Loads a word table from a text file with one word per
+ * line. Lines may end in '\n', "\r\n" or '\r', and may be in
+ * any order and case: they are trimmed, folded to lowercase
+ * (ASCII only), sorted bytewise and deduplicated.
+ * @param filename: The file to load.
+ * @return The table, which must be freed with wordTable_Free,
+ * or NULL if it could not be loaded.
+ **************************************************************/
+extern WORD_TABLE *wordTable_Create(const char *filename);
+
+/**********************************************************//**
+ * @brief Loads a word table like wordTable_Create, folding
+ * each word with the given function.
+ * @param filename: The file to load.
+ * @param fold: Folds each word, or NULL to fold ASCII.
+ * @param data: Passed to fold.
+ * @return The table, or NULL if it could not be loaded.
+ **************************************************************/
+extern WORD_TABLE *wordTable_CreateFolded(const char *filename, WORD_FOLD fold, const void *data);
+
+/**********************************************************//**
+ * @brief Frees a table made by wordTable_Create. No thread may
+ * be using it.
+ * @param table: The table to free. NULL is ignored.
+ **************************************************************/
+extern void wordTable_Free(WORD_TABLE *table);
+
+/**********************************************************//**
+ * @brief Gets the number of words in a table.
+ * @param table: The table to inspect.
+ * @return The number of words.
+ **************************************************************/
+extern int wordTable_GetSize(const WORD_TABLE *table);
 
 /**********************************************************//**
- * @brief Loads the given file as the "real words" table.
- * This is a text file of lowercase words separated by '\n'.
- * The text file must be in alphabetical order.
+ * @brief Gets what was found while loading a table.
+ * @param table: The table to inspect.
+ * @param stats: Gets the statistics.
+ **************************************************************/
+extern void wordTable_GetStats(const WORD_TABLE *table, WORD_TABLE_STATS *stats);
+
+/**********************************************************//**
+ * @brief Checks if a word is in a table. This is safe to call
+ * from any thread.
+ * @param table: The table to search.
+ * @param what: The lowercase word to look for.
+ * @return Whether the word is in the table.
+ **************************************************************/
+extern bool wordTable_ContainsIn(const WORD_TABLE *table, const char *what);
+
+/**********************************************************//**
+ * @brief Finds the words in a table closest to some text, by
+ * Levenshtein distance over bytes. This is safe to call from
+ * any thread.
+ * @param table: The table to search.
+ * @param what: The lowercase text, up to MAX_SUGGEST_QUERY
+ * bytes long.
+ * @param maxDistance: Most edits a suggestion may be away,
+ * up to MAX_SUGGEST_DISTANCE.
+ * @param suggestions: Gets the suggestions, closest first and
+ * alphabetical among equals.
+ * @param maxSuggestions: Most suggestions to find.
+ * @return The number of suggestions found.
+ **************************************************************/
+extern int wordTable_SuggestIn(const WORD_TABLE *table, const char *what, int maxDistance, WORD_SUGGESTION *suggestions, int maxSuggestions);
+
+/**********************************************************//**
+ * @brief Visits every word in a table, in order. This is safe
+ * to call from any thread.
+ * @param table: The table to walk.
+ * @param visit: Called with each word.
+ * @param data: Passed to visit.
+ **************************************************************/
+extern void wordTable_WalkIn(const WORD_TABLE *table, WORD_VISIT visit, void *data);
+
+/**********************************************************//**
+ * @brief Loads the given file as the "real words" table used
+ * by the functions below, replacing any table loaded before.
+ * This is safe while other threads look words up: they keep
+ * the old table until they finish, and it is freed after.
  * @param filename: The file to load.
  * @return Whether the loading succeeded. If it succeeds you
- * must destroy the table with wordtable_Destroy later.
+ * must destroy the table with wordTable_Destroy later.
  **************************************************************/
 extern bool wordTable_Load(const char *filename);
 
 /**********************************************************//**
- * @brief Destroys the initialized word table.
+ * @brief Destroys the "real words" table, once every thread
+ * looking words up in it has finished.
  **************************************************************/
 extern void wordTable_Destroy(void);
 
+/**********************************************************//**
+ * @brief Gets the "real words" table for several lookups in a
+ * row. It won't be freed before wordTable_EndRead, even if
+ * another thread loads a new one. This never blocks.
+ * @return The table loaded by wordTable_Load, or NULL.
+ **************************************************************/
+extern const WORD_TABLE *wordTable_BeginRead(void);
+
+/**********************************************************//**
+ * @brief Stops using the table from wordTable_BeginRead.
+ **************************************************************/
+extern void wordTable_EndRead(void);
+
 /**********************************************************//**
  * @brief Check if the word table is loaded.
  * @return Whether the word table has been initialized by a
- * call to wordtable_Load.
+ * call to wordTable_Load.
  **************************************************************/
 extern bool wordTable_IsValid(void);
 
 /**********************************************************//**
- * @brief Checks if a word is in the table.
+ * @brief Checks if a word is in the "real words" table.
  * @param what: The string to check if it is the table.
  * @return Whether the word is in the table.
  **************************************************************/
 extern bool wordTable_Contains(const char *what);
 
+/**********************************************************//**
+ * @brief Finds the words in the "real words" table closest to
+ * some text. See wordTable_SuggestIn.
+ * @param what: The lowercase text.
+ * @param maxDistance: Most edits a suggestion may be away.
+ * @param suggestions: Gets the suggestions.
+ * @param maxSuggestions: Most suggestions to find.
+ * @return The number of suggestions found.
+ **************************************************************/
+extern int wordTable_Suggest(const char *what, int maxDistance, WORD_SUGGESTION *suggestions, int maxSuggestions);
+
+/**********************************************************//**
+ * @brief Visits every word in the "real words" table. The
+ * table can't be freed until the walk is over.
+ * @param visit: Called with each word.
+ * @param data: Passed to visit.
+ * @return Whether a table was loaded.
+ **************************************************************/
+extern bool wordTable_Walk(WORD_VISIT visit, void *data);
+
 /*============================================================*/
 #endif // _WORD_TABLE_H_
@@ -0,0 +1,198 @@
+/**********************************************************//**
+ * @file word_trie.c
+ * @brief Implementation of the dictionary trie.
+ **************************************************************/
+
+// Standard library
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint32_t
+#include <stdlib.h>         // malloc, realloc, free
+#include <string.h>         // strlen, memcpy
+
+// This project
+#include "debug.h"          // eprintf
+#include "word_trie.h"      // WORD_TRIE
+#include "word.h"           // MAX_WORD_LENGTH, MAX_WORD_BYTES
+#include "language.h"       // language_Walk
+
+/**********************************************************//**
+ * @struct TRIE_NODE
+ * @brief One byte of a prefix. Nodes are stored in depth-first
+ * order, so the first child of a node comes right after it,
+ * and each child links to the next, in byte order.
+ **************************************************************/
+typedef struct {
+    uint32_t sibling;       ///< The next child of the parent, or 0.
+    unsigned char byte;     ///< The byte ending the prefix.
+    bool word;              ///< Whether the prefix is a word.
+    bool parent;            ///< Whether any longer prefix follows.
+} TRIE_NODE;
+
+/**********************************************************//**
+ * @struct WORD_TRIE
+ * @brief Stores the nodes of every prefix. Node 0 is the empty
+ * prefix.
+ **************************************************************/
+struct WORD_TRIE {
+    TRIE_NODE *nodes;       ///< Every prefix.
+    int size;               ///< Number of nodes.
+};
+
+/**********************************************************//**
+ * @struct TRIE_BUILD
+ * @brief The nodes made so far while a trie is built. Words
+ * come in sorted order, so only the nodes of the last word
+ * can still get new children.
+ **************************************************************/
+typedef struct {
+    TRIE_NODE *nodes;               ///< Every prefix so far.
+    int count;                      ///< Number of nodes.
+    int capacity;                   ///< Nodes allocated.
+    char last[MAX_WORD_BYTES+1];    ///< The last word added.
+    int lastBytes;                  ///< Bytes in the last word.
+    int path[MAX_WORD_BYTES+1];     ///< Node of each prefix of it.
+    bool unsorted;                  ///< Whether a word was out of order.
+    bool failed;                    ///< Whether memory ran out.
+} TRIE_BUILD;
+
+/*============================================================*
+ * Creating a trie
+ *============================================================*/
+
+/**********************************************************//**
+ * @brief Adds the nodes of a word if it can be made.
+ * @param data: The trie being built.
+ * @param text: The word, which comes after the last one.
+ **************************************************************/
+static void AddWord(void *data, const char *text) {
+    TRIE_BUILD *build = data;
+    if (build->failed || build->unsorted) {
+        return;
+    }
+    
+    // Words too long to type are left out
+    int bytes = strlen(text);
+    int letters = 0;
+    for (int i = 0; i < bytes; i++) {
+        letters += ((unsigned char)text[i] & 0xC0) != 0x80;
+    }
+    if (bytes == 0 || bytes > MAX_WORD_BYTES || letters > MAX_WORD_LENGTH) {
+        return;
+    }
+    
+    // Find the prefix shared with the last word
+    int shared = 0;
+    while (shared < bytes && shared < build->lastBytes && text[shared] == build->last[shared]) {
+        shared++;
+    }
+    if (shared == bytes || (shared < build->lastBytes
+            && (unsigned char)text[shared] < (unsigned char)build->last[shared])) {
+        build->unsorted = true;
+        return;
+    }
+    
+    // Make a node for each byte after it
+    if (build->count + bytes - shared > build->capacity) {
+        int capacity = 2*build->capacity + bytes;
+        TRIE_NODE *grown = realloc(build->nodes, capacity*sizeof(TRIE_NODE));
+        if (!grown) {
+            build->failed = true;
+            return;
+        }
+        build->nodes = grown;
+        build->capacity = capacity;
+    }
+    for (int depth = shared + 1; depth <= bytes; depth++) {
+        int node = build->count++;
+        TRIE_NODE *parent = &build->nodes[build->path[depth-1]];
+        if (parent->parent) {
+            // The last word's node is the last child so far
+            build->nodes[build->path[depth]].sibling = node;
+        } else {
+            parent->parent = true;
+        }
+        build->nodes[node].sibling = 0;
+        build->nodes[node].byte = text[depth-1];
+        build->nodes[node].word = false;
+        build->nodes[node].parent = false;
+        build->path[depth] = node;
+    }
+    build->nodes[build->path[bytes]].word = true;
+    memcpy(build->last, text, bytes);
+    build->lastBytes = bytes;
+}
+
+WORD_TRIE *wordTrie_Create(const LANGUAGE *language) {
+    // Start with the empty prefix
+    TRIE_BUILD build;
+    memset(&build, 0, sizeof(build));
+    build.nodes = malloc(sizeof(TRIE_NODE));
+    if (!build.nodes) {
+        eprintf("Out of memory.\n");
+        return NULL;
+    }
+    build.nodes[0].sibling = 0;
+    build.nodes[0].byte = '\0';
+    build.nodes[0].word = false;
+    build.nodes[0].parent = false;
+    build.count = 1;
+    build.capacity = 1;
+    build.path[0] = WORD_TRIE_ROOT;
+    
+    // Add every word in order
+    if (!language_Walk(language, AddWord, &build)) {
+        eprintf("Word table has not been initialized.\n");
+        free(build.nodes);
+        return NULL;
+    }
+    if (build.unsorted) {
+        eprintf("Word table is not sorted.\n");
+        free(build.nodes);
+        return NULL;
+    }
+    WORD_TRIE *trie = malloc(sizeof(WORD_TRIE));
+    if (!trie || build.failed) {
+        eprintf("Out of memory.\n");
+        free(build.nodes);
+        free(trie);
+        return NULL;
+    }
+    
+    // Give back the room that wasn't needed
+    TRIE_NODE *shrunk = realloc(build.nodes, build.count*sizeof(TRIE_NODE));
+    trie->nodes = shrunk? shrunk: build.nodes;
+    trie->size = build.count;
+    return trie;
+}
+
+void wordTrie_Free(WORD_TRIE *trie) {
+    if (trie) {
+        free(trie->nodes);
+        free(trie);
+    }
+}
+
+/*============================================================*
+ * Following prefixes
+ *============================================================*/
+int wordTrie_Step(const WORD_TRIE *trie, int node, const char *text) {
+    for (const unsigned char *next = (const unsigned char *)text; *next && node >= 0; next++) {
+        // Children are in byte order, so the search can stop
+        // at the first one past the byte
+        if (!trie->nodes[node].parent) {
+            return -1;
+        }
+        int child = node + 1;
+        while (child && trie->nodes[child].byte < *next) {
+            child = trie->nodes[child].sibling;
+        }
+        node = child && trie->nodes[child].byte == *next? child: -1;
+    }
+    return node;
+}
+
+bool wordTrie_IsWord(const WORD_TRIE *trie, int node) {
+    return node >= 0 && trie->nodes[node].word;
+}
+
+/*============================================================*/
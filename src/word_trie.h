@@ -0,0 +1,67 @@
+/**********************************************************//**
+ * @file word_trie.h
+ * @brief Header file for following a dictionary one letter at
+ * a time. Each step down the trie checks a single node's
+ * children, so whether typed text is a real word, and whether
+ * it can still become one, is known after every letter.
+ **************************************************************/
+
+#ifndef _WORD_TRIE_H_
+#define _WORD_TRIE_H_
+
+// Standard library
+#include <stdbool.h>    // bool
+
+// This project
+#include "language.h"   // LANGUAGE
+
+//**************************************************************
+/// The node of the empty prefix, where every word starts.
+#define WORD_TRIE_ROOT 0
+
+/**********************************************************//**
+ * @struct WORD_TRIE
+ * @brief The prefixes of every word in a dictionary that can
+ * be made into a WORD. The contents are private to
+ * word_trie.c and never change after creation.
+ **************************************************************/
+typedef struct WORD_TRIE WORD_TRIE;
+
+/**********************************************************//**
+ * @brief Creates a trie of a language's dictionary. The words
+ * are copied, so the dictionary may be replaced or freed
+ * afterwards.
+ * @param language: The language of the dictionary.
+ * @return The trie, which must be freed with wordTrie_Free,
+ * or NULL on failure.
+ **************************************************************/
+extern WORD_TRIE *wordTrie_Create(const LANGUAGE *language);
+
+/**********************************************************//**
+ * @brief Frees a trie. No thread may be reading it.
+ * @param trie: The trie to free. NULL is ignored.
+ **************************************************************/
+extern void wordTrie_Free(WORD_TRIE *trie);
+
+/**********************************************************//**
+ * @brief Follows some lowercase text down from a node. This
+ * is safe to call from any thread.
+ * @param trie: The trie to search.
+ * @param node: The node to start from.
+ * @param text: The lowercase text to follow, usually one
+ * letter.
+ * @return The node of the longer prefix, or -1 if no word
+ * starts with it.
+ **************************************************************/
+extern int wordTrie_Step(const WORD_TRIE *trie, int node, const char *text);
+
+/**********************************************************//**
+ * @brief Checks if the prefix of a node is a word itself.
+ * @param trie: The trie to search.
+ * @param node: A node from wordTrie_Step, or -1.
+ * @return Whether it is a word.
+ **************************************************************/
+extern bool wordTrie_IsWord(const WORD_TRIE *trie, int node);
+
+/*============================================================*/
+#endif // _WORD_TRIE_H_